@@ -4,23 +4,68 @@
 
 # Add inputs and outputs from these tool invocations to the build variables 
 CPP_SRCS += \
+../src/layoutexport.cpp \
+../src/layoutfeed.cpp \
+../src/mindmap.cpp \
+../src/pngreader.cpp \
+../src/pngwriter.cpp \
+../src/radialcli.cpp \
+../src/radialfeed.cpp \
 ../src/radialgl.cpp \
+../src/softraster.cpp \
+../src/svgexport.cpp \
+../src/tiffwriter.cpp \
+../src/tilepyramid.cpp \
 ../src/tinyxml2.cpp 
 
 CPP_DEPS += \
+./src/layoutexport.d \
+./src/layoutfeed.d \
+./src/mindmap.d \
+./src/pngreader.d \
+./src/pngwriter.d \
+./src/radialcli.d \
+./src/radialfeed.d \
 ./src/radialgl.d \
+./src/softraster.d \
+./src/svgexport.d \
+./src/tiffwriter.d \
+./src/tilepyramid.d \
 ./src/tinyxml2.d 
 
 OBJS += \
+./src/layoutfeed.o \
+./src/mindmap.o \
+./src/pngreader.o \
+./src/pngwriter.o \
 ./src/radialgl.o \
+./src/softraster.o \
+./src/svgexport.o \
+./src/tiffwriter.o \
+./src/tilepyramid.o \
 ./src/tinyxml2.o 
 
+CLI_OBJS += \
+./src/layoutexport.o \
+./src/mindmap.o \
+./src/pngwriter.o \
+./src/radialcli.o \
+./src/softraster.o \
+./src/svgexport.o \
+./src/tiffwriter.o \
+./src/tilepyramid.o \
+./src/tinyxml2.o 
+
+FEED_OBJS += \
+./src/layoutfeed.o \
+./src/radialfeed.o 
+
 
 # Each subdirectory must supply rules for building sources it contributes
 src/%.o: ../src/%.cpp src/subdir.mk
 	@echo 'Building file: $<'
 	@echo 'Invoking: GCC C++ Compiler'
-	g++ -O0 -g3 -Wall -c -fmessage-length=0 -MMD -MP -MF"$(@:%.o=%.d)" -MT"$@" -o "$@" "$<"
+	g++ -O0 -g3 -Wall -c -fmessage-length=0 -pthread -MMD -MP -MF"$(@:%.o=%.d)" -MT"$@" -o "$@" "$<"
 	@echo 'Finished building: $<'
 	@echo ' '
 
@@ -28,7 +73,7 @@ src/%.o: ../src/%.cpp src/subdir.mk
 clean: clean-src
 
 clean-src:
-	-$(RM) ./src/radialgl.d ./src/radialgl.o ./src/tinyxml2.d ./src/tinyxml2.o
+	-$(RM) ./src/layoutexport.d ./src/layoutexport.o ./src/layoutfeed.d ./src/layoutfeed.o ./src/mindmap.d ./src/mindmap.o ./src/pngreader.d ./src/pngreader.o ./src/pngwriter.d ./src/pngwriter.o ./src/radialcli.d ./src/radialcli.o ./src/radialfeed.d ./src/radialfeed.o ./src/radialgl.d ./src/radialgl.o ./src/softraster.d ./src/softraster.o ./src/svgexport.d ./src/svgexport.o ./src/tiffwriter.d ./src/tiffwriter.o ./src/tilepyramid.d ./src/tilepyramid.o ./src/tinyxml2.d ./src/tinyxml2.o
 
 .PHONY: clean-src
 
@@ -0,0 +1,386 @@
+// layoutexport.cpp - layout data export: CSV, JSON and a binary columnar file.
+
+#include "layoutexport.h"
+
+#include <cstdio>
+#include <cstring>
+#include <cmath>
+#include <charconv>
+#include <algorithm>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+static const size_t LAYOUT_FLUSH_BYTES = 1 << 16; // buffered output before a write
+static const size_t LAYOUT_ITEM_BYTES  = 64;      // most bytes a single put*() call adds
+static const size_t LAYOUT_BLOCK_ROWS  = 16384;   // rows per column block of the binary file
+static const size_t LAYOUT_CHUNK_ROWS  = 8192;    // text rows per formatting job
+
+// Output buffer: items are formatted straight into it and it is written out
+// whenever the next item might not fit. Without a file it just grows.
+struct LayoutWriter {
+    FILE* f;
+    std::vector<char> buf;
+    size_t used = 0;
+    bool ok = true;
+
+    explicit LayoutWriter(FILE* file) : f(file), buf(LAYOUT_FLUSH_BYTES + LAYOUT_ITEM_BYTES) {}
+
+    void flush() {
+        if (used && std::fwrite(buf.data(), 1, used, f) != used) ok = false;
+        used = 0;
+    }
+
+    void reserve(size_t n) {
+        if (used + n <= buf.size()) return;
+        if (f) flush();
+        if (used + n > buf.size()) buf.resize(std::max(2 * buf.size(), used + n));
+    }
+
+    char* room() {
+        reserve(LAYOUT_ITEM_BYTES);
+        return &buf[used];
+    }
+
+    void put(char c) { *room() = c; ++used; }
+    void put(const char* s) { put(s, std::strlen(s)); }
+    void put(const char* s, size_t n) {
+        if (f && n > LAYOUT_FLUSH_BYTES) {
+            flush();
+            if (std::fwrite(s, 1, n, f) != n) ok = false;
+            return;
+        }
+        reserve(n);
+        std::memcpy(&buf[used], s, n);
+        used += n;
+    }
+
+    template <typename T>
+    void number(T v) {
+        char* p = room();
+        used += size_t(std::to_chars(p, p + LAYOUT_ITEM_BYTES, v).ptr - p);
+    }
+
+    // Little-endian binary.
+    void le(uint64_t v, int bytes) {
+        char* p = room();
+        for (int i = 0; i < bytes; ++i) p[i] = char(uint8_t(v >> (8 * i)));
+        used += size_t(bytes);
+    }
+};
+
+static FILE* openOutput(const char* path, const char* mode) {
+    FILE* f = std::fopen(path, mode);
+    if (!f) std::fprintf(stderr, "Cannot write %s\n", path);
+    return f;
+}
+
+static bool finishOutput(LayoutWriter& w, const char* path) {
+    w.flush();
+    bool ok = w.ok && !std::ferror(w.f);
+    ok = (std::fclose(w.f) == 0) && ok;
+    if (!ok) std::fprintf(stderr, "Error writing %s\n", path);
+    return ok;
+}
+
+// The exported nodes in order, and the row of each preorder slot (-1: not exported).
+static void exportRows(const std::vector<Node*>& nodes, const std::vector<std::pair<int, int>>& ranges,
+                       std::vector<const Node*>& rows, std::vector<int32_t>& rowOf) {
+    rowOf.assign(nodes.size(), -1);
+    forEachSlot(nodes, ranges, [&](const Node* n) {
+        rowOf[size_t(n->index)] = int32_t(rows.size());
+        rows.push_back(n);
+    });
+}
+
+static int32_t parentRow(const Node* n, const std::vector<int32_t>& rowOf) {
+    return n->parent ? rowOf[size_t(n->parent->index)] : -1;
+}
+
+// ---------------------------- CSV and JSON ----------------------------
+
+// row(writer, i) for every row into out, in order. Rows are formatted in
+// chunks of LAYOUT_CHUNK_ROWS on the workers and written by the calling
+// thread as they come in; at most two chunks per worker are held at a time.
+template <typename Fn>
+static void formatRows(LayoutWriter& out, size_t rows, int threads, Fn row) {
+    size_t chunks = (rows + LAYOUT_CHUNK_ROWS - 1) / LAYOUT_CHUNK_ROWS;
+    size_t workers = threads > 0 ? size_t(threads) : std::max(1u, std::thread::hardware_concurrency());
+    workers = std::min(workers, chunks);
+    if (workers <= 1) {
+        for (size_t i = 0; i < rows; ++i) row(out, i);
+        return;
+    }
+
+    // Chunk k is formatted into slot k % window once chunk k - window is written.
+    size_t window = 2 * workers;
+    std::vector<LayoutWriter> slots(window, LayoutWriter(nullptr));
+    std::vector<char> ready(window, 0);
+    std::mutex lock;
+    std::condition_variable changed;
+    size_t next = 0, written = 0;
+    auto worker = [&]() {
+        std::unique_lock<std::mutex> guard(lock);
+        for (;;) {
+            changed.wait(guard, [&] { return next >= chunks || next < written + window; });
+            if (next >= chunks) return;
+            size_t k = next++;
+            guard.unlock();
+            LayoutWriter& slot = slots[k % window];
+            slot.used = 0;
+            for (size_t i = k * LAYOUT_CHUNK_ROWS, e = std::min(rows, i + LAYOUT_CHUNK_ROWS); i < e; ++i) row(slot, i);
+            guard.lock();
+            ready[k % window] = 1;
+            changed.notify_all();
+        }
+    };
+    std::vector<std::thread> pool;
+    for (size_t t = 0; t < workers; ++t) pool.emplace_back(worker);
+
+    for (size_t k = 0; k < chunks; ++k) {
+        std::unique_lock<std::mutex> guard(lock);
+        changed.wait(guard, [&] { return ready[k % window] != 0; });
+        guard.unlock();
+        out.put(slots[k % window].buf.data(), slots[k % window].used);
+        guard.lock();
+        ready[k % window] = 0;
+        ++written;
+        changed.notify_all();
+    }
+    for (auto& t : pool) t.join();
+}
+
+static void putCsvField(LayoutWriter& w, const std::string& s) {
+    w.put('"');
+    size_t from = 0;
+    for (size_t q; (q = s.find('"', from)) != std::string::npos; from = q + 1) {
+        w.put(s.data() + from, q + 1 - from);
+        w.put('"');
+    }
+    w.put(s.data() + from, s.size() - from);
+    w.put('"');
+}
+
+static void putJsonString(LayoutWriter& w, const std::string& s) {
+    static const char hex[] = "0123456789abcdef";
+    w.put('"');
+    for (char c : s) {
+        unsigned char u = (unsigned char)c;
+        if (c == '"' || c == '\\') {
+            w.put('\\');
+            w.put(c);
+        } else if (u < 0x20) {
+            w.put("\\u00");
+            w.put(hex[u >> 4]);
+            w.put(hex[u & 15]);
+        } else {
+            w.put(c);
+        }
+    }
+    w.put('"');
+}
+
+// JSON has no infinities or NaN.
+static void putJsonNumber(LayoutWriter& w, float v) {
+    if (std::isfinite(v)) w.number(v);
+    else                  w.put("null");
+}
+
+bool exportLayoutCsv(const char* path, const std::vector<Node*>& nodes,
+                     const std::vector<std::pair<int, int>>& ranges, int threads) {
+    FILE* f = openOutput(path, "w");
+    if (!f) return false;
+    std::vector<const Node*> rows;
+    std::vector<int32_t> rowOf;
+    exportRows(nodes, ranges, rows, rowOf);
+
+    LayoutWriter w(f);
+    w.put("index,parent,depth,leaves,angle,radius,x,y,id,text\n");
+    formatRows(w, rows.size(), threads, [&](LayoutWriter& out, size_t i) {
+        const Node* n = rows[i];
+        out.number(i);                     out.put(',');
+        out.number(parentRow(n, rowOf));   out.put(',');
+        out.number(n->depth);              out.put(',');
+        out.number(n->leafCount);          out.put(',');
+        out.number(n->angle);              out.put(',');
+        out.number(n->radius);             out.put(',');
+        out.number(n->x);                  out.put(',');
+        out.number(n->y);                  out.put(',');
+        putCsvField(out, n->id);           out.put(',');
+        putCsvField(out, n->text);
+        out.put('\n');
+    });
+    return finishOutput(w, path);
+}
+
+bool exportLayoutJson(const char* path, const std::vector<Node*>& nodes,
+                      const std::vector<std::pair<int, int>>& ranges, int threads) {
+    FILE* f = openOutput(path, "w");
+    if (!f) return false;
+    std::vector<const Node*> rows;
+    std::vector<int32_t> rowOf;
+    exportRows(nodes, ranges, rows, rowOf);
+
+    LayoutWriter w(f);
+    w.put('[');
+    formatRows(w, rows.size(), threads, [&](LayoutWriter& out, size_t i) {
+        const Node* n = rows[i];
+        out.put(i ? ",\n" : "\n");
+        out.put("{\"index\":");   out.number(i);
+        out.put(",\"parent\":");  out.number(parentRow(n, rowOf));
+        out.put(",\"depth\":");   out.number(n->depth);
+        out.put(",\"leaves\":");  out.number(n->leafCount);
+        out.put(",\"angle\":");   putJsonNumber(out, n->angle);
+        out.put(",\"radius\":");  putJsonNumber(out, n->radius);
+        out.put(",\"x\":");       putJsonNumber(out, n->x);
+        out.put(",\"y\":");       putJsonNumber(out, n->y);
+        out.put(",\"id\":");      putJsonString(out, n->id);
+        out.put(",\"text\":");    putJsonString(out, n->text);
+        out.put('}');
+    });
+    w.put("\n]\n");
+    return finishOutput(w, path);
+}
+
+// ---------------------------- Binary Layout File ----------------------------
+
+static uint64_t alignUp(uint64_t v) {
+    return (v + LAYOUT_FILE_ALIGN - 1) / LAYOUT_FILE_ALIGN * LAYOUT_FILE_ALIGN;
+}
+
+bool exportLayoutBinary(const char* path, const std::vector<Node*>& nodes,
+                        const std::vector<std::pair<int, int>>& ranges) {
+    FILE* f = openOutput(path, "wb");
+    if (!f) return false;
+    std::vector<const Node*> rows;
+    std::vector<int32_t> rowOf;
+    exportRows(nodes, ranges, rows, rowOf);
+
+    // Every column but the ID bytes has a known size; the header, which
+    // holds the total, is written last.
+    uint64_t n = rows.size();
+    const uint64_t columnBytes[LAYOUT_ID_BYTES] = { 4 * n, 4 * n, 4 * n, 4 * n, 4 * n, 4 * n, 4 * n, 8 * (n + 1) };
+    uint64_t column[LAYOUT_COLUMNS];
+    column[0] = alignUp(sizeof(LayoutFileHeader));
+    for (int c = 1; c < LAYOUT_COLUMNS; ++c) column[c] = alignUp(column[c - 1] + columnBytes[c - 1]);
+
+    // One pass over the nodes, LAYOUT_BLOCK_ROWS at a time: a block of every
+    // column is filled, then written at its place in the column. Padding
+    // between columns is left to the file system, which reads gaps as zeros.
+    bool ok = true;
+    auto writeAt = [&](uint64_t pos, const std::vector<uint8_t>& bytes) {
+        if (ok && !bytes.empty() &&
+            (std::fseek(f, long(pos), SEEK_SET) != 0 || std::fwrite(bytes.data(), 1, bytes.size(), f) != bytes.size()))
+            ok = false;
+    };
+    static const int elementBytes[LAYOUT_ID_BYTES] = { 4, 4, 4, 4, 4, 4, 4, 8 };
+    std::vector<uint8_t> block[LAYOUT_COLUMNS];
+    size_t at = 0; // row within the block
+    auto put = [&](LayoutColumn c, uint64_t v) {
+        uint8_t* p = &block[c][at * size_t(elementBytes[c])];
+        for (int i = 0; i < elementBytes[c]; ++i) p[i] = uint8_t(v >> (8 * i));
+    };
+    auto putFloat = [&](LayoutColumn c, float v) {
+        uint32_t bits;
+        std::memcpy(&bits, &v, sizeof(bits));
+        put(c, bits);
+    };
+    uint64_t idBytes = 0;
+    for (size_t first = 0; first < rows.size(); first += LAYOUT_BLOCK_ROWS) {
+        size_t count = std::min(rows.size() - first, LAYOUT_BLOCK_ROWS);
+        uint64_t idFirst = idBytes;
+        for (int c = 0; c < LAYOUT_ID_BYTES; ++c) block[c].resize(count * size_t(elementBytes[c]));
+        block[LAYOUT_ID_BYTES].clear();
+        for (at = 0; at < count; ++at) {
+            const Node* r = rows[first + at];
+            put(LAYOUT_PARENT, uint32_t(parentRow(r, rowOf)));
+            put(LAYOUT_DEPTH, uint32_t(r->depth));
+            put(LAYOUT_LEAVES, uint32_t(r->leafCount));
+            putFloat(LAYOUT_ANGLE, r->angle);
+            putFloat(LAYOUT_RADIUS, r->radius);
+            putFloat(LAYOUT_X, r->x);
+            putFloat(LAYOUT_Y, r->y);
+            put(LAYOUT_ID_OFFSETS, idBytes);
+            block[LAYOUT_ID_BYTES].insert(block[LAYOUT_ID_BYTES].end(), r->id.begin(), r->id.end());
+            idBytes += r->id.size();
+        }
+        for (int c = 0; c < LAYOUT_ID_BYTES; ++c)
+            writeAt(column[c] + uint64_t(elementBytes[c]) * first, block[c]);
+        writeAt(column[LAYOUT_ID_BYTES] + idFirst, block[LAYOUT_ID_BYTES]);
+    }
+    block[LAYOUT_ID_OFFSETS].resize(8);
+    at = 0;
+    put(LAYOUT_ID_OFFSETS, idBytes);
+    writeAt(column[LAYOUT_ID_OFFSETS] + 8 * n, block[LAYOUT_ID_OFFSETS]);
+    uint64_t end = alignUp(column[LAYOUT_ID_BYTES] + idBytes);
+    writeAt(end - 1, std::vector<uint8_t>(1, 0));
+
+    std::fseek(f, 0, SEEK_SET);
+    LayoutWriter w(f);
+    w.ok = ok;
+    for (char c : LAYOUT_FILE_MAGIC) w.put(c);
+    w.le(LAYOUT_FILE_VERSION, 4);
+    w.le(sizeof(LayoutFileHeader), 4);
+    w.le(n, 8);
+    w.le(end, 8);
+    for (uint64_t c : column) w.le(c, 8);
+    w.le(idBytes, 8);
+    return finishOutput(w, path);
+}
+
+bool LayoutFile::open(const char* path) {
+    close();
+    int fd = ::open(path, O_RDONLY);
+    if (fd < 0) { std::fprintf(stderr, "Cannot open %s\n", path); return false; }
+    struct stat st;
+    if (::fstat(fd, &st) == 0 && size_t(st.st_size) >= sizeof(LayoutFileHeader)) {
+        size = size_t(st.st_size);
+        base = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+        if (base == MAP_FAILED) base = nullptr;
+    }
+    ::close(fd);
+
+    // The version reads back as 1 only on a little-endian host.
+    const LayoutFileHeader* h = static_cast<const LayoutFileHeader*>(base);
+    bool ok = h && std::memcmp(h->magic, LAYOUT_FILE_MAGIC, sizeof(h->magic)) == 0 &&
+              h->version == LAYOUT_FILE_VERSION && h->headerBytes == sizeof(LayoutFileHeader) &&
+              h->fileBytes <= size;
+    const uint64_t elementBytes[LAYOUT_COLUMNS] = { 4, 4, 4, 4, 4, 4, 4, 8, 1 };
+    for (int c = 0; ok && c < LAYOUT_COLUMNS; ++c) {
+        uint64_t count = c == LAYOUT_ID_BYTES ? h->idBytes : c == LAYOUT_ID_OFFSETS ? h->rows + 1 : h->rows;
+        ok = h->column[c] % LAYOUT_FILE_ALIGN == 0 && count <= h->fileBytes / elementBytes[c] &&
+             h->column[c] <= h->fileBytes - count * elementBytes[c];
+    }
+    if (!ok) {
+        std::fprintf(stderr, "%s: not a layout file (version %u, little-endian)\n", path, LAYOUT_FILE_VERSION);
+        close();
+        return false;
+    }
+
+    const char* b = static_cast<const char*>(base);
+    header = h;
+    rows = size_t(h->rows);
+    parent    = reinterpret_cast<const int32_t*>(b + h->column[LAYOUT_PARENT]);
+    depth     = reinterpret_cast<const int32_t*>(b + h->column[LAYOUT_DEPTH]);
+    leaves    = reinterpret_cast<const int32_t*>(b + h->column[LAYOUT_LEAVES]);
+    angle     = reinterpret_cast<const float*>(b + h->column[LAYOUT_ANGLE]);
+    radius    = reinterpret_cast<const float*>(b + h->column[LAYOUT_RADIUS]);
+    x         = reinterpret_cast<const float*>(b + h->column[LAYOUT_X]);
+    y         = reinterpret_cast<const float*>(b + h->column[LAYOUT_Y]);
+    idOffsets = reinterpret_cast<const uint64_t*>(b + h->column[LAYOUT_ID_OFFSETS]);
+    idBytes   = b + h->column[LAYOUT_ID_BYTES];
+    return true;
+}
+
+void LayoutFile::close() {
+    if (base) ::munmap(base, size);
+    base = nullptr;
+    size = 0;
+    header = nullptr;
+    rows = 0;
+}
@@ -0,0 +1,104 @@
+// layoutexport.h - layout data export: CSV, JSON and a binary columnar file.
+//
+// One row per exported node, in preorder: its row number, the parent's row
+// (-1 for the root), depth, leaf count, angle (radians), radius and position
+// (world units), then the FreeMind ID and text. Rows are numbered in export
+// order, so they match the map's preorder indices unless collapsed subtrees
+// are left out. The parent is given by row, not by FreeMind ID: its ID is
+// the id column of that row (LayoutFile::id(parent[row]) in a layout file). Numbers are written with std::to_chars (shortest text that
+// reads back to the same float) into buffers written in fixed-size chunks;
+// text rows are formatted on worker threads (threads <= 0: one per core),
+// so output goes out as fast as the file takes it, in bounded memory.
+
+#ifndef LAYOUTEXPORT_H
+#define LAYOUTEXPORT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <utility>
+
+#include "mindmap.h"
+
+// index,parent,depth,leaves,angle,radius,x,y,id,text with a header line;
+// id and text quoted.
+bool exportLayoutCsv(const char* path, const std::vector<Node*>& nodes,
+                     const std::vector<std::pair<int, int>>& ranges, int threads);
+
+// An array of objects, one per line, with the CSV columns as keys.
+bool exportLayoutJson(const char* path, const std::vector<Node*>& nodes,
+                      const std::vector<std::pair<int, int>>& ranges, int threads);
+
+// ---------------------------- Binary Layout File ----------------------------
+
+// A little-endian file meant to be mapped and used in place: the header, then
+// one array per column, each starting at a multiple of LAYOUT_FILE_ALIGN
+// bytes. Text is left out; IDs are UTF-8 bytes without terminators, row i's
+// being [idOffsets[i], idOffsets[i + 1]) of the ID bytes.
+enum LayoutColumn {
+    LAYOUT_PARENT,      // int32, the parent's row (-1 for the root)
+    LAYOUT_DEPTH,       // int32
+    LAYOUT_LEAVES,      // int32
+    LAYOUT_ANGLE,       // float32
+    LAYOUT_RADIUS,      // float32
+    LAYOUT_X,           // float32
+    LAYOUT_Y,           // float32
+    LAYOUT_ID_OFFSETS,  // uint64, rows + 1
+    LAYOUT_ID_BYTES,    // char
+    LAYOUT_COLUMNS
+};
+
+static const char     LAYOUT_FILE_MAGIC[8] = { 'R', 'A', 'D', 'L', 'A', 'Y', 'O', 'T' };
+static const uint32_t LAYOUT_FILE_VERSION  = 1;
+static const size_t   LAYOUT_FILE_ALIGN    = 64;
+
+struct LayoutFileHeader {
+    char     magic[8];                 // LAYOUT_FILE_MAGIC
+    uint32_t version;                  // LAYOUT_FILE_VERSION
+    uint32_t headerBytes;              // sizeof(LayoutFileHeader)
+    uint64_t rows;
+    uint64_t fileBytes;
+    uint64_t column[LAYOUT_COLUMNS];   // byte offset of each column from the start of the file
+    uint64_t idBytes;                  // size of the LAYOUT_ID_BYTES column
+};
+static_assert(sizeof(LayoutFileHeader) == 112, "LayoutFileHeader is a file format");
+
+bool exportLayoutBinary(const char* path, const std::vector<Node*>& nodes,
+                        const std::vector<std::pair<int, int>>& ranges);
+
+// A layout file mapped read-only. The column pointers point into the mapping
+// and stay valid until close() or destruction. open() fails (with a message
+// on stderr) for anything that is not a layout file of this version, and on
+// big-endian hosts.
+struct LayoutFile {
+    const LayoutFileHeader* header = nullptr;
+    size_t rows = 0;
+    const int32_t* parent = nullptr;
+    const int32_t* depth = nullptr;
+    const int32_t* leaves = nullptr;
+    const float* angle = nullptr;
+    const float* radius = nullptr;
+    const float* x = nullptr;
+    const float* y = nullptr;
+    const uint64_t* idOffsets = nullptr;
+    const char* idBytes = nullptr;
+
+    LayoutFile() = default;
+    LayoutFile(const LayoutFile&) = delete;
+    LayoutFile& operator=(const LayoutFile&) = delete;
+    ~LayoutFile() { close(); }
+
+    bool open(const char* path);
+    void close();
+
+    std::string id(size_t row) const {
+        return std::string(idBytes + idOffsets[row], size_t(idOffsets[row + 1] - idOffsets[row]));
+    }
+
+private:
+    void* base = nullptr;
+    size_t size = 0;
+};
+
+#endif // LAYOUTEXPORT_H
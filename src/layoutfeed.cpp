@@ -0,0 +1,218 @@
+// layoutfeed.cpp - live layout feed over POSIX shared memory.
+
+#include "layoutfeed.h"
+
+#include <cstring>
+#include <cerrno>
+#include <new>
+#include <algorithm>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+static const size_t FEED_ALIGN = 64;
+static const int FEED_COLUMN_BYTES = 4; // every column is 32-bit
+
+static size_t alignUp(size_t v) {
+    return (v + FEED_ALIGN - 1) / FEED_ALIGN * FEED_ALIGN;
+}
+
+std::string layoutFeedName(int pid) {
+    return "/radialgl-" + std::to_string(pid);
+}
+
+// ---------------------------- Slots ----------------------------
+
+// Update u goes to slot u & 1, whose sequence is 2u - 1 while it is written
+// and 2u once it is complete; then the update counter moves to u.
+static void beginUpdate(std::atomic<uint64_t>& sequence, uint64_t u) {
+    sequence.store(2 * u - 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+}
+
+static void endUpdate(std::atomic<uint64_t>& sequence, std::atomic<uint64_t>& updates, uint64_t u) {
+    sequence.store(2 * u, std::memory_order_release);
+    updates.store(u, std::memory_order_release);
+}
+
+// The slot reads back unchanged: nothing was written to it since sequence
+// was loaded as expected.
+static bool slotUnchanged(const std::atomic<uint64_t>& sequence, uint64_t expected) {
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return sequence.load(std::memory_order_relaxed) == expected;
+}
+
+// ---------------------------- Writer ----------------------------
+
+bool LayoutFeedWriter::create(size_t capacity) {
+    std::string keep = name;
+    close();
+    name = keep;
+
+    size_t arrays = alignUp(capacity * FEED_COLUMN_BYTES);
+    size_t bytes = alignUp(sizeof(LayoutFeedHeader)) + 2 * FEED_COLUMNS * arrays;
+    int fd = ::shm_open(name.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) { std::fprintf(stderr, "Cannot create shared memory %s: %s\n", name.c_str(), std::strerror(errno)); return false; }
+    void* p = MAP_FAILED;
+    if (::ftruncate(fd, off_t(bytes)) == 0) p = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (p == MAP_FAILED) {
+        std::fprintf(stderr, "Cannot map shared memory %s: %s\n", name.c_str(), std::strerror(errno));
+        ::shm_unlink(name.c_str());
+        return false;
+    }
+
+    // The segment starts zeroed: no updates, every sequence 0.
+    header = new (p) LayoutFeedHeader();
+    size = bytes;
+    std::memcpy(header->magic, LAYOUT_FEED_MAGIC, sizeof(header->magic));
+    header->version = LAYOUT_FEED_VERSION;
+    header->headerBytes = sizeof(LayoutFeedHeader);
+    header->segmentBytes = bytes;
+    header->capacity = capacity;
+    header->pid = int32_t(::getpid());
+    size_t at = alignUp(sizeof(LayoutFeedHeader));
+    for (auto& slot : header->layouts)
+        for (int c = 0; c < FEED_COLUMNS; ++c, at += arrays) slot.column[c] = at;
+    header->live.store(1, std::memory_order_release);
+    return true;
+}
+
+bool LayoutFeedWriter::publishLayout(const std::vector<Node*>& nodes,
+                                     const std::vector<std::pair<int, int>>& ranges, const Node* focus) {
+    size_t rows = 0;
+    for (const auto& r : ranges) rows += size_t(r.second - r.first);
+    if (!header || rows > header->capacity) {
+        if (!create(rows + rows / 4 + 1024)) return false; // room to grow
+    }
+
+    uint64_t u = header->layoutUpdates.load(std::memory_order_relaxed) + 1;
+    LayoutFeedLayoutSlot& slot = header->layouts[u & 1];
+    beginUpdate(slot.sequence, u);
+
+    char* base = reinterpret_cast<char*>(header);
+    float* x = reinterpret_cast<float*>(base + slot.column[FEED_X]);
+    float* y = reinterpret_cast<float*>(base + slot.column[FEED_Y]);
+    int32_t* parent = reinterpret_cast<int32_t*>(base + slot.column[FEED_PARENT]);
+    int32_t* depth = reinterpret_cast<int32_t*>(base + slot.column[FEED_DEPTH]);
+    int32_t* index = reinterpret_cast<int32_t*>(base + slot.column[FEED_INDEX]);
+    rowOf.assign(nodes.size(), -1);
+    focusRow = -1;
+    int32_t row = 0;
+    forEachSlot(nodes, ranges, [&](const Node* n) {
+        rowOf[size_t(n->index)] = row;
+        if (n == focus) focusRow = row;
+        x[row] = n->x;
+        y[row] = n->y;
+        parent[row] = n->parent ? rowOf[size_t(n->parent->index)] : -1;
+        depth[row] = n->depth;
+        index[row] = n->index;
+        ++row;
+    });
+    slot.rows = rows;
+    endUpdate(slot.sequence, header->layoutUpdates, u);
+    return true;
+}
+
+void LayoutFeedWriter::publishView(const LayoutFeedView& view) {
+    if (!header) return;
+    uint64_t u = header->viewUpdates.load(std::memory_order_relaxed) + 1;
+    LayoutFeedViewSlot& slot = header->views[u & 1];
+    beginUpdate(slot.sequence, u);
+    slot.view = view;
+    slot.view.layout = header->layoutUpdates.load(std::memory_order_relaxed);
+    slot.view.focus = focusRow;
+    endUpdate(slot.sequence, header->viewUpdates, u);
+}
+
+void LayoutFeedWriter::close() {
+    if (!header) return;
+    header->live.store(0, std::memory_order_release);
+    ::munmap(header, size);
+    ::shm_unlink(name.c_str());
+    header = nullptr;
+    size = 0;
+}
+
+// ---------------------------- Reader ----------------------------
+
+bool LayoutFeedReader::open(const char* name) {
+    close();
+    int fd = ::shm_open(name, O_RDONLY, 0);
+    if (fd < 0) return false;
+    struct stat st;
+    void* p = MAP_FAILED;
+    if (::fstat(fd, &st) == 0 && size_t(st.st_size) >= sizeof(LayoutFeedHeader))
+        p = ::mmap(nullptr, size_t(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (p == MAP_FAILED) return false;
+
+    const LayoutFeedHeader* h = static_cast<const LayoutFeedHeader*>(p);
+    bool ok = h->live.load(std::memory_order_acquire) == 1 &&
+              std::memcmp(h->magic, LAYOUT_FEED_MAGIC, sizeof(h->magic)) == 0 &&
+              h->version == LAYOUT_FEED_VERSION && h->headerBytes == sizeof(LayoutFeedHeader) &&
+              h->segmentBytes <= size_t(st.st_size);
+    for (int s = 0; ok && s < 2; ++s)
+        for (int c = 0; ok && c < FEED_COLUMNS; ++c)
+            ok = h->layouts[s].column[c] <= h->segmentBytes &&
+                 h->capacity <= (h->segmentBytes - h->layouts[s].column[c]) / FEED_COLUMN_BYTES;
+    if (!ok) {
+        ::munmap(p, size_t(st.st_size));
+        return false;
+    }
+    header = h;
+    size = size_t(st.st_size);
+    return true;
+}
+
+void LayoutFeedReader::close() {
+    if (header) ::munmap(const_cast<LayoutFeedHeader*>(header), size);
+    header = nullptr;
+    size = 0;
+}
+
+bool LayoutFeedReader::stale() const {
+    return !header || header->live.load(std::memory_order_acquire) == 0;
+}
+
+bool LayoutFeedReader::view(LayoutFeedView& out) const {
+    if (!header) return false;
+    for (;;) {
+        uint64_t u = header->viewUpdates.load(std::memory_order_acquire);
+        if (u == 0) return false;
+        const LayoutFeedViewSlot& slot = header->views[u & 1];
+        uint64_t expected = slot.sequence.load(std::memory_order_acquire);
+        if (expected != 2 * u) continue; // overtaken by two updates
+        out = slot.view;
+        if (slotUnchanged(slot.sequence, expected)) return true;
+    }
+}
+
+bool LayoutFeedReader::begin(Layout& out) const {
+    if (!header) return false;
+    for (;;) {
+        uint64_t u = header->layoutUpdates.load(std::memory_order_acquire);
+        if (u == 0) return false;
+        const LayoutFeedLayoutSlot& slot = header->layouts[u & 1];
+        uint64_t expected = slot.sequence.load(std::memory_order_acquire);
+        if (expected != 2 * u) continue;
+
+        const char* base = reinterpret_cast<const char*>(header);
+        out.update = u;
+        out.rows = size_t(std::min<uint64_t>(slot.rows, header->capacity));
+        out.x = reinterpret_cast<const float*>(base + slot.column[FEED_X]);
+        out.y = reinterpret_cast<const float*>(base + slot.column[FEED_Y]);
+        out.parent = reinterpret_cast<const int32_t*>(base + slot.column[FEED_PARENT]);
+        out.depth = reinterpret_cast<const int32_t*>(base + slot.column[FEED_DEPTH]);
+        out.index = reinterpret_cast<const int32_t*>(base + slot.column[FEED_INDEX]);
+        out.sequence = &slot.sequence;
+        out.expected = expected;
+        if (slotUnchanged(slot.sequence, expected)) return true;
+    }
+}
+
+bool LayoutFeedReader::end(const Layout& layout) const {
+    return layout.sequence && slotUnchanged(*layout.sequence, layout.expected);
+}
@@ -0,0 +1,156 @@
+// layoutfeed.h - live layout feed over POSIX shared memory.
+//
+// A running viewer publishes the positions of its placed nodes and its camera
+// in a shared memory object (shm_open), for other processes to use in place.
+// Both are double-buffered: an update is written into the slot readers are
+// not directed to, then published by bumping a counter, so a reader always
+// finds a complete update and only loses one if it holds it across two more.
+// Each slot carries a sequence number (odd while it is being written) that
+// readers check after use, seqlock style: no locks, no copies, no parsing.
+//
+// Layout rows are the placed nodes in preorder, as in layoutexport.h: the
+// parent is a row number, and index is the node's preorder slot in the map
+// (the row of a layout file exported with nothing folded).
+
+#ifndef LAYOUTFEED_H
+#define LAYOUTFEED_H
+
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+#include <string>
+#include <vector>
+#include <utility>
+
+#include "mindmap.h"
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "feed counters are shared between processes");
+
+enum LayoutFeedColumn {
+    FEED_X,       // float32, world units
+    FEED_Y,       // float32
+    FEED_PARENT,  // int32 row, -1 for the root
+    FEED_DEPTH,   // int32
+    FEED_INDEX,   // int32 preorder slot in the map
+    FEED_COLUMNS
+};
+
+enum : uint32_t { FEED_HYPERBOLIC = 1 }; // LayoutFeedView::flags
+
+static const char     LAYOUT_FEED_MAGIC[8] = { 'R', 'A', 'D', 'F', 'E', 'E', 'D', '1' };
+static const uint32_t LAYOUT_FEED_VERSION  = 1;
+
+// The camera, as the viewer's setupOrtho() applies it: the world is rotated
+// by rotDeg about the origin, then (panX, panY) is the window center, which
+// shows halfHeight world units above and below it.
+struct LayoutFeedView {
+    uint64_t layout = 0;        // the layout update this view was drawn with
+    float panX = 0.0f, panY = 0.0f;
+    float zoom = 1.0f, rotDeg = 0.0f;
+    float halfHeight = 0.0f;
+    int32_t winW = 0, winH = 0;
+    int32_t focus = -1;         // row of the layout's center node
+    uint32_t flags = 0;
+};
+
+struct LayoutFeedViewSlot {
+    std::atomic<uint64_t> sequence;
+    LayoutFeedView view;
+};
+
+struct LayoutFeedLayoutSlot {
+    std::atomic<uint64_t> sequence;
+    uint64_t rows;
+    uint64_t column[FEED_COLUMNS]; // byte offset of each array from the start of the segment
+};
+
+// The start of the segment; the layout arrays follow it.
+struct LayoutFeedHeader {
+    char     magic[8];                    // LAYOUT_FEED_MAGIC
+    uint32_t version;                     // LAYOUT_FEED_VERSION
+    uint32_t headerBytes;                 // sizeof(LayoutFeedHeader)
+    uint64_t segmentBytes;
+    uint64_t capacity;                    // rows each layout slot holds
+    std::atomic<uint32_t> live;           // 0 once the publisher has exited or replaced the segment
+    int32_t  pid;                         // publisher
+    std::atomic<uint64_t> viewUpdates;    // the latest view is in views[viewUpdates & 1]
+    std::atomic<uint64_t> layoutUpdates;  // the latest layout is in layouts[layoutUpdates & 1]
+    LayoutFeedViewSlot views[2];
+    LayoutFeedLayoutSlot layouts[2];
+};
+
+// "/radialgl-<pid>", the name the viewer publishes under.
+std::string layoutFeedName(int pid);
+
+// Publisher side. The segment is created by the first publishLayout() and
+// recreated, larger, when a layout outgrows it; close() marks it dead and
+// unlinks it.
+struct LayoutFeedWriter {
+    std::string name;
+
+    LayoutFeedWriter() = default;
+    LayoutFeedWriter(const LayoutFeedWriter&) = delete;
+    LayoutFeedWriter& operator=(const LayoutFeedWriter&) = delete;
+    ~LayoutFeedWriter() { close(); }
+
+    // Publish the nodes in ranges, centered on focus. Returns false (after a
+    // message on stderr) if the segment cannot be made.
+    bool publishLayout(const std::vector<Node*>& nodes, const std::vector<std::pair<int, int>>& ranges,
+                       const Node* focus);
+    // Publish the camera for the latest layout (layout and focus are filled in).
+    void publishView(const LayoutFeedView& view);
+    void close();
+
+private:
+    bool create(size_t capacity);
+
+    LayoutFeedHeader* header = nullptr;
+    size_t size = 0;
+    int32_t focusRow = -1;
+    std::vector<int32_t> rowOf;
+};
+
+// Reader side: a segment mapped read-only.
+struct LayoutFeedReader {
+    // The latest layout, in place. Valid while end() says so.
+    struct Layout {
+        uint64_t update = 0;
+        size_t rows = 0;
+        const float* x = nullptr;
+        const float* y = nullptr;
+        const int32_t* parent = nullptr;
+        const int32_t* depth = nullptr;
+        const int32_t* index = nullptr;
+        const std::atomic<uint64_t>* sequence = nullptr;
+        uint64_t expected = 0;
+    };
+
+    LayoutFeedReader() = default;
+    LayoutFeedReader(const LayoutFeedReader&) = delete;
+    LayoutFeedReader& operator=(const LayoutFeedReader&) = delete;
+    ~LayoutFeedReader() { close(); }
+
+    // Map the named segment. Returns false if there is none, or none ready,
+    // or it is not a feed of this version.
+    bool open(const char* name);
+    void close();
+    bool isOpen() const { return header != nullptr; }
+
+    // The publisher has gone or moved to a new segment: open() again.
+    bool stale() const;
+
+    // Copy the latest camera (it is small). False if there is none yet.
+    bool view(LayoutFeedView& out) const;
+
+    // Point out at the latest layout. False if there is none yet. Use the
+    // arrays, then call end(): if it returns false they were overwritten
+    // meanwhile and whatever was computed from them must be redone.
+    bool begin(Layout& out) const;
+    bool end(const Layout& layout) const;
+
+private:
+    const LayoutFeedHeader* header = nullptr;
+    size_t size = 0;
+};
+
+#endif // LAYOUTFEED_H
@@ -0,0 +1,214 @@
+// mindmap.cpp - FreeMind map model, parser and radial layout passes.
+
+#include "mindmap.h"
+
+#include <cstdio>
+#include <cmath>
+#include <algorithm>
+
+#include "tinyxml2.h"
+#include "strokefont.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// ---------------------------- XML Parsing (FreeMind) ----------------------------
+
+static std::string getAttr(tinyxml2::XMLElement* el, const char* name) {
+    const char* v = el->Attribute(name);
+    return v ? std::string(v) : std::string();
+}
+
+static std::unique_ptr<Node> parseNode(tinyxml2::XMLElement* xmlNode, Node* parent, int& autoId) {
+    auto n = std::make_unique<Node>();
+    n->parent = parent;
+
+    n->text = getAttr(xmlNode, "TEXT");
+    n->id   = getAttr(xmlNode, "ID");
+
+    if (n->id.empty()) n->id = "auto_" + std::to_string(autoId++);
+    if (n->text.empty()) n->text = n->id;
+
+    for (tinyxml2::XMLElement* c = xmlNode->FirstChildElement("node"); c; c = c->NextSiblingElement("node")) {
+        auto child = parseNode(c, n.get(), autoId);
+        n->children.insert(n->children.begin(), std::move(child));
+    }
+    return n;
+}
+
+std::unique_ptr<Node> loadFreeMind(const char* path, int& autoId) {
+    tinyxml2::XMLDocument doc;
+    if (doc.LoadFile(path) != tinyxml2::XML_SUCCESS) {
+        std::fprintf(stderr, "Failed to load %s\n", path);
+        return nullptr;
+    }
+
+    auto* mapEl = doc.FirstChildElement("map");
+    if (!mapEl) { std::fprintf(stderr, "%s: no <map> element.\n", path); return nullptr; }
+
+    auto* rootEl = mapEl->FirstChildElement("node");
+    if (!rootEl) { std::fprintf(stderr, "%s: no root <node> element.\n", path); return nullptr; }
+
+    return parseNode(rootEl, nullptr, autoId);
+}
+
+// ---------------------------- Layout ----------------------------
+
+void layoutIndexNode(Node* n, std::vector<Node*>& nodes, std::vector<Node*>& stack) {
+    n->index = int(nodes.size());
+    n->depth = n->parent ? n->parent->depth + 1 : 0;
+    nodes.push_back(n);
+    for (auto it = n->children.rbegin(); it != n->children.rend(); ++it)
+        stack.push_back(it->get());
+}
+
+void layoutCountLeaves(Node* n) {
+    n->height = 0;
+    n->subtreeEnd = n->children.empty() ? n->index + 1 : n->children.back()->subtreeEnd;
+    if (n->children.empty()) { n->leafCount = 1; return; }
+
+    int sum = 0;
+    for (auto& ch : n->children) {
+        sum += ch->leafCount;
+        n->height = std::max(n->height, ch->height + 1);
+    }
+    n->leafCount = n->collapsed ? 1 : std::max(1, sum);
+}
+
+// Position the node (its wedge was set by its parent) and split the wedge
+// among its children in proportion to their leaf counts.
+bool layoutPlaceNode(Node* n, float radiusStep) {
+    if (!n->parent) { n->angle0 = 0.0f; n->angle1 = 2.0f * float(M_PI); }
+    n->angle = 0.5f * (n->angle0 + n->angle1);
+    n->radius = float(n->depth) * radiusStep;
+    n->x = std::cos(n->angle) * n->radius;
+    n->y = std::sin(n->angle) * n->radius;
+
+    if (n->collapsed) return false;
+
+    float cur = n->angle0;
+    float span = n->angle1 - n->angle0;
+    float total = float(std::max(1, n->leafCount));
+    for (auto& ch : n->children) {
+        float next = cur + span * (float(ch->leafCount) / total);
+        ch->angle0 = cur;
+        ch->angle1 = next;
+        cur = next;
+    }
+    return true;
+}
+
+void layoutMindMap(MindMap& map, float radiusStep) {
+    map.nodes.clear();
+    if (!map.root) return;
+
+    std::vector<Node*> stack(1, map.root.get());
+    while (!stack.empty()) {
+        Node* n = stack.back();
+        stack.pop_back();
+        layoutIndexNode(n, map.nodes, stack);
+    }
+    for (size_t i = map.nodes.size(); i > 0; --i) layoutCountLeaves(map.nodes[i - 1]);
+
+    size_t i = 0;
+    while (i < map.nodes.size()) {
+        Node* n = map.nodes[i];
+        i = layoutPlaceNode(n, radiusStep) ? i + 1 : size_t(n->subtreeEnd);
+    }
+}
+
+std::vector<std::pair<int, int>> placedRanges(const MindMap& map) {
+    std::vector<std::pair<int, int>> ranges;
+    int count = int(map.nodes.size());
+    int start = 0, i = 0;
+    while (i < count) {
+        const Node* n = map.nodes[i];
+        if (n->collapsed && n->subtreeEnd > i + 1) {
+            ranges.push_back({ start, i + 1 });
+            i = start = n->subtreeEnd;
+        } else {
+            ++i;
+        }
+    }
+    if (start < count) ranges.push_back({ start, count });
+    return ranges;
+}
+
+// ---------------------------- Links ----------------------------
+
+void linkControlPoints(const Node* parent, const Node* child, float radiusStep,
+                       float& p1x, float& p1y, float& p2x, float& p2y) {
+    linkControlPoints(parent->angle, parent->radius, child->angle, child->radius, radiusStep, p1x, p1y, p2x, p2y);
+}
+
+void linkControlPoints(float parentAngle, float parentRadius, float childAngle, float childRadius,
+                       float radiusStep, float& p1x, float& p1y, float& p2x, float& p2y) {
+    float mid1r = parentRadius + 0.55f * radiusStep;
+    float mid2r = childRadius  - 0.55f * radiusStep;
+    p1x = std::cos(parentAngle) * mid1r;
+    p1y = std::sin(parentAngle) * mid1r;
+    p2x = std::cos(childAngle) * mid2r;
+    p2y = std::sin(childAngle) * mid2r;
+}
+
+// ---------------------------- Drawing Style ----------------------------
+
+bool mapLabelWanted(const Node* n, const Node* focus, const MapStyle& style) {
+    if (!style.labels || n->text.empty()) return false;
+    return n == focus || !style.leavesOnly || n->children.empty();
+}
+
+void placeMapLabel(const Node* n, const Node* focus, const MapStyle& style,
+                   float& x, float& y, float& angleDeg, bool& endAligned) {
+    if (n == focus) {
+        x = 3.0f;
+        y = 0.0f;
+        angleDeg = -style.rotDeg;
+        endAligned = false;
+        return;
+    }
+    // Non-focus nodes have radius > 0: the radial direction is position / radius.
+    float k = 1.0f + style.labelPad / n->radius;
+    float deg = n->angle * (180.0f / float(M_PI));
+    endAligned = std::cos(n->angle + style.rotDeg * (float(M_PI) / 180.0f)) < 0.0f;
+    x = n->x * k;
+    y = n->y * k;
+    angleDeg = endAligned ? deg + 180.0f : deg;
+}
+
+LabelBox labelTextBox(float ox, float oy, float ux, float uy, float vx, float vy,
+                      float u0, float u1, float pxPerStroke) {
+    float v0 = -STROKE_ROMAN_DESCENT * pxPerStroke;
+    float v1 =  STROKE_ROMAN_ASCENT  * pxPerStroke;
+    float mu = 0.5f * (u0 + u1), mv = 0.5f * (v0 + v1);
+    return { ox + ux * mu + vx * mv, oy + uy * mu + vy * mv, ux, uy, 0.5f * (u1 - u0), 0.5f * (v1 - v0) };
+}
+
+bool labelBoxesOverlap(const LabelBox& a, const LabelBox& b) {
+    float dx = b.cx - a.cx, dy = b.cy - a.cy;
+    const float axes[4][2] = { { a.ux, a.uy }, { -a.uy, a.ux }, { b.ux, b.uy }, { -b.uy, b.ux } };
+    for (const auto& L : axes) {
+        float ra = a.hu * std::fabs(a.ux*L[0] + a.uy*L[1]) + a.hv * std::fabs(-a.uy*L[0] + a.ux*L[1]);
+        float rb = b.hu * std::fabs(b.ux*L[0] + b.uy*L[1]) + b.hv * std::fabs(-b.uy*L[0] + b.ux*L[1]);
+        if (std::fabs(dx*L[0] + dy*L[1]) > ra + rb) return false;
+    }
+    return true;
+}
+
+void labelBoxBounds(const LabelBox& b, float& ex, float& ey) {
+    ex = b.hu * std::fabs(b.ux) + b.hv * std::fabs(b.uy);
+    ey = b.hu * std::fabs(b.uy) + b.hv * std::fabs(b.ux);
+}
+
+float mapExtent(const std::vector<Node*>& nodes, const std::vector<std::pair<int, int>>& ranges,
+                const Node* focus, const MapStyle& style) {
+    float extent = 1.0f;
+    forEachSlot(nodes, ranges, [&](const Node* n) {
+        float reach = n->radius + style.endpointRadius;
+        if (mapLabelWanted(n, focus, style))
+            reach = std::max(reach, n->radius + style.labelPad + strokeTextWidth(n->text) * style.labelScale);
+        extent = std::max(extent, reach);
+    });
+    return extent;
+}
@@ -0,0 +1,136 @@
+// mindmap.h - FreeMind map model, parser, radial layout passes and the
+// drawing style shared by the exporters.
+//
+// Shared by the viewer (radialgl) and the headless batch tool (radialcli).
+// Nothing in here touches GL or global state: every call works on the nodes
+// it is given, so separate maps can be loaded and laid out on separate threads.
+
+#ifndef MINDMAP_H
+#define MINDMAP_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <utility>
+
+struct Node {
+    std::string id;
+    std::string text;
+    Node* parent = nullptr;
+    std::vector<std::unique_ptr<Node>> children;
+
+    int depth = 0;
+    int height = 0;         // levels below this node
+    int leafCount = 0;      // visible leaves: a collapsed node counts as one
+    bool collapsed = false; // children hidden (right click)
+
+    int index = 0;          // preorder position in the node array
+    int subtreeEnd = 0;     // one past the last descendant in the node array
+
+    float textWidth = 0.0f; // stroke units, cached by cacheLabelWidths()
+
+    float angle = 0.0f;     // radians
+    float angle0 = 0.0f, angle1 = 0.0f; // angular wedge [angle0, angle1) owned by this subtree
+    float radius = 0.0f;    // world units
+    float x = 0.0f, y = 0.0f;
+};
+
+// Parse a FreeMind file. Nodes without an ID get "auto_<n>", numbered from
+// autoId (which is advanced); children are stored in reverse document order.
+// Returns nullptr (after a message on stderr) if the file cannot be used.
+std::unique_ptr<Node> loadFreeMind(const char* path, int& autoId);
+
+// The three passes of the radial layout, one node per call so that callers
+// can slice them (see the viewer's LayoutJob):
+//   layoutIndexNode:  preorder, parents first; pops nothing, pushes the
+//                     children onto the DFS stack in visiting order
+//   layoutCountLeaves: reverse preorder, children first
+//   layoutPlaceNode:  preorder, parents first; the root owns the full circle.
+//                     Returns false for a collapsed node, whose subtree is
+//                     then left unplaced.
+void layoutIndexNode(Node* n, std::vector<Node*>& nodes, std::vector<Node*>& stack);
+void layoutCountLeaves(Node* n);
+bool layoutPlaceNode(Node* n, float radiusStep);
+
+// A loaded map and its preorder node array.
+struct MindMap {
+    std::unique_ptr<Node> root;
+    std::vector<Node*> nodes;
+};
+
+// All three passes over the whole map, centered on the root.
+void layoutMindMap(MindMap& map, float radiusStep);
+
+// Preorder [begin, end) ranges of the nodes placed by layoutMindMap(), i.e.
+// the whole array minus the subtrees below collapsed nodes.
+std::vector<std::pair<int, int>> placedRanges(const MindMap& map);
+
+// Inner control points of the cubic Bezier link from parent to child: each
+// leaves its endpoint radially, 0.55 ring spacings towards the other ring.
+void linkControlPoints(const Node* parent, const Node* child, float radiusStep,
+                       float& p1x, float& p1y, float& p2x, float& p2y);
+
+// The same for endpoints given in polar form (angle in radians, radius), such
+// as positions interpolated between two layouts.
+void linkControlPoints(float parentAngle, float parentRadius, float childAngle, float childRadius,
+                       float radiusStep, float& p1x, float& p1y, float& p2x, float& p2y);
+
+// ---------------------------- Drawing Style ----------------------------
+
+// How a laid-out map is drawn, with the viewer's defaults. The exporters
+// derive their option structs from it.
+struct MapStyle {
+    float radiusStep     = 35.0f;   // ring spacing the layout was made with (Bezier control points)
+    bool  curved         = true;    // cubic Bezier links, else straight lines
+    float endpointRadius = 0.75f;   // world units
+    bool  labels         = true;
+    bool  leavesOnly     = false;
+    float labelScale     = 0.020f;  // world units per stroke font unit
+    float labelPad       = 3.0f;    // label anchor offset past the node (world units)
+    float rotDeg         = 0.0f;    // view rotation; also decides which labels are flipped
+};
+
+// fn(node) for the nodes in the preorder [begin, end) slot ranges.
+template <typename Fn>
+void forEachSlot(const std::vector<Node*>& nodes, const std::vector<std::pair<int, int>>& ranges, Fn fn) {
+    for (const auto& r : ranges)
+        for (int i = r.first; i < r.second; ++i) fn(nodes[size_t(i)]);
+}
+
+// Whether n gets a label in a map laid out around focus.
+bool mapLabelWanted(const Node* n, const Node* focus, const MapStyle& style);
+
+// Label anchor (world units), text angle (degrees, world frame) and alignment,
+// as in the viewer: the focus label horizontal on screen, the others radial,
+// turned by 180 degrees and end-aligned where they would read upside down.
+void placeMapLabel(const Node* n, const Node* focus, const MapStyle& style,
+                   float& x, float& y, float& angleDeg, bool& endAligned);
+
+// Label decluttering, the same for the viewer and the exporters: every label
+// is an oriented box in pixels, tested against the boxes already placed near
+// it through a grid of LABEL_GRID_CELL_PX square cells.
+constexpr float LABEL_GRID_CELL_PX = 48.0f;
+
+struct LabelBox {
+    float cx, cy;   // center
+    float ux, uy;   // unit baseline direction
+    float hu, hv;   // half extents along / across the baseline
+};
+
+// The box of the text run [u0, u1] (pixels along the baseline from the anchor
+// (ox, oy)) from the font's descent to its ascent. (ux, uy) and (vx, vy) are
+// the unit baseline and up directions in pixels.
+LabelBox labelTextBox(float ox, float oy, float ux, float uy, float vx, float vy,
+                      float u0, float u1, float pxPerStroke);
+
+// Separating-axis test for two oriented boxes.
+bool labelBoxesOverlap(const LabelBox& a, const LabelBox& b);
+
+// Half extents of the box's axis-aligned bounds.
+void labelBoxBounds(const LabelBox& b, float& ex, float& ey);
+
+// Radius around the focus that holds every node, circle and label drawn.
+float mapExtent(const std::vector<Node*>& nodes, const std::vector<std::pair<int, int>>& ranges,
+                const Node* focus, const MapStyle& style);
+
+#endif // MINDMAP_H
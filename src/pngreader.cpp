@@ -0,0 +1,274 @@
+// pngreader.cpp - PNG decoder with a built-in inflate.
+
+#include "pngreader.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+
+// ---------------------------- Inflate ----------------------------
+
+static const uint16_t LEN_BASE[29]  = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+                                        35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+static const uint8_t  LEN_EXTRA[29] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+                                        3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+static const uint16_t DIST_BASE[30]  = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+                                         257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145,
+                                         8193, 12289, 16385, 24577 };
+static const uint8_t  DIST_EXTRA[30] = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+                                         7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+static const uint8_t  CL_ORDER[19]   = { 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+
+// LSB-first bit input. Reading past the end yields zeros and is caught by
+// overrun() once the stream is done.
+struct BitReader {
+    const uint8_t* p;
+    size_t n, pos = 0;
+    uint64_t buf = 0;
+    int count = 0;
+
+    BitReader(const uint8_t* data, size_t size) : p(data), n(size) {}
+
+    void need(int k) {
+        while (count < k) {
+            buf |= uint64_t(pos < n ? p[pos] : 0) << count;
+            ++pos;
+            count += 8;
+        }
+    }
+    uint32_t peek(int k) { need(k); return uint32_t(buf & ((1ull << k) - 1)); }
+    void drop(int k) { buf >>= k; count -= k; }
+    uint32_t bits(int k) { uint32_t v = peek(k); drop(k); return v; }
+    void alignByte() { drop(count & 7); }
+    bool overrun() const { return pos * 8 - size_t(count) > n * 8; }
+};
+
+// Canonical Huffman decoder: codes up to HUFF_FAST_BITS long are resolved by
+// one table lookup, longer ones bit by bit from the per-length counts.
+static const int HUFF_FAST_BITS = 9;
+
+struct Huffman {
+    uint16_t fast[1 << HUFF_FAST_BITS]; // symbol << 4 | length, 0: slow path
+    uint16_t count[16];                 // codes per length
+    uint16_t symbol[288];               // symbols ordered by code
+
+    // False if the lengths over-subscribe the code space.
+    bool build(const uint8_t* lens, int n) {
+        std::memset(count, 0, sizeof(count));
+        std::memset(fast, 0, sizeof(fast));
+        for (int s = 0; s < n; ++s) ++count[lens[s]];
+        count[0] = 0;
+        int left = 1;
+        for (int len = 1; len < 16; ++len) {
+            left = (left << 1) - count[len];
+            if (left < 0) return false;
+        }
+
+        uint16_t offset[16], next[16];
+        offset[1] = 0;
+        for (int len = 1; len < 15; ++len) offset[len + 1] = uint16_t(offset[len] + count[len]);
+        uint16_t code = 0;
+        for (int len = 1; len < 16; ++len) {
+            code = uint16_t((code + count[len - 1]) << 1);
+            next[len] = code;
+        }
+        for (int s = 0; s < n; ++s) {
+            int len = lens[s];
+            if (!len) continue;
+            symbol[offset[len]++] = uint16_t(s);
+            uint32_t c = next[len]++, rev = 0;
+            for (int k = 0; k < len; ++k) rev |= ((c >> k) & 1u) << (len - 1 - k);
+            if (len <= HUFF_FAST_BITS)
+                for (uint32_t j = rev; j < (1u << HUFF_FAST_BITS); j += 1u << len)
+                    fast[j] = uint16_t(s << 4 | len);
+        }
+        return true;
+    }
+
+    // Next symbol, or -1 for a code that is not in the table.
+    int decode(BitReader& br) const {
+        uint16_t e = fast[br.peek(HUFF_FAST_BITS)];
+        if (e) { br.drop(e & 15); return e >> 4; }
+        int code = 0, first = 0, index = 0;
+        for (int len = 1; len < 16; ++len) {
+            code |= int(br.bits(1));
+            int c = count[len];
+            if (code - c < first) return symbol[index + (code - first)];
+            index += c;
+            first = (first + c) << 1;
+            code <<= 1;
+        }
+        return -1;
+    }
+};
+
+static bool inflateCodes(BitReader& br, const Huffman& lit, const Huffman& dist, std::vector<uint8_t>& out) {
+    for (;;) {
+        int s = lit.decode(br);
+        if (s < 0 || br.overrun()) return false;
+        if (s < 256) { out.push_back(uint8_t(s)); continue; }
+        if (s == 256) return true;
+        s -= 257;
+        if (s >= 29) return false;
+        size_t len = LEN_BASE[s] + br.bits(LEN_EXTRA[s]);
+        int d = dist.decode(br);
+        if (d < 0 || d >= 30) return false;
+        size_t back = DIST_BASE[d] + br.bits(DIST_EXTRA[d]);
+        if (back > out.size()) return false;
+        size_t from = out.size() - back;
+        for (size_t k = 0; k < len; ++k) out.push_back(out[from + k]);
+    }
+}
+
+// Raw deflate data (RFC 1951) appended to out.
+static bool inflate(const uint8_t* data, size_t n, std::vector<uint8_t>& out) {
+    BitReader br(data, n);
+    Huffman lit, dist;
+    for (bool final = false; !final; ) {
+        final = br.bits(1) != 0;
+        uint32_t type = br.bits(2);
+        if (type == 0) {
+            br.alignByte();
+            uint32_t len = br.bits(16), nlen = br.bits(16);
+            if ((len ^ 0xFFFF) != nlen) return false;
+            for (uint32_t k = 0; k < len; ++k) out.push_back(uint8_t(br.bits(8)));
+        } else if (type == 1) {
+            uint8_t lens[288 + 30];
+            std::memset(lens, 8, 144);
+            std::memset(lens + 144, 9, 112);
+            std::memset(lens + 256, 7, 24);
+            std::memset(lens + 280, 8, 8);
+            std::memset(lens + 288, 5, 30);
+            lit.build(lens, 288);
+            dist.build(lens + 288, 30);
+            if (!inflateCodes(br, lit, dist, out)) return false;
+        } else if (type == 2) {
+            int hlit = int(br.bits(5)) + 257, hdist = int(br.bits(5)) + 1, hclen = int(br.bits(4)) + 4;
+            uint8_t clLens[19] = {};
+            for (int k = 0; k < hclen; ++k) clLens[CL_ORDER[k]] = uint8_t(br.bits(3));
+            Huffman cl;
+            if (!cl.build(clLens, 19)) return false;
+
+            uint8_t lens[288 + 32] = {};
+            for (int k = 0; k < hlit + hdist; ) {
+                int s = cl.decode(br);
+                if (s < 0 || br.overrun()) return false;
+                if (s < 16) { lens[k++] = uint8_t(s); continue; }
+                int repeat;
+                uint8_t v = 0;
+                if (s == 16) {
+                    if (k == 0) return false;
+                    v = lens[k - 1];
+                    repeat = 3 + int(br.bits(2));
+                } else if (s == 17) {
+                    repeat = 3 + int(br.bits(3));
+                } else {
+                    repeat = 11 + int(br.bits(7));
+                }
+                if (k + repeat > hlit + hdist) return false;
+                while (repeat--) lens[k++] = v;
+            }
+            if (!lit.build(lens, hlit) || !dist.build(lens + hlit, hdist)) return false;
+            if (!inflateCodes(br, lit, dist, out)) return false;
+        } else {
+            return false;
+        }
+        if (br.overrun()) return false;
+    }
+    return true;
+}
+
+// ---------------------------- PNG ----------------------------
+
+static uint32_t getBE32(const uint8_t* p) {
+    return uint32_t(p[0]) << 24 | uint32_t(p[1]) << 16 | uint32_t(p[2]) << 8 | p[3];
+}
+
+static uint8_t paeth(int a, int b, int c) {
+    int p = a + b - c;
+    int pa = std::abs(p - a), pb = std::abs(p - b), pc = std::abs(p - c);
+    if (pa <= pb && pa <= pc) return uint8_t(a);
+    return uint8_t(pb <= pc ? b : c);
+}
+
+bool decodePng(const uint8_t* data, size_t size, int& width, int& height, std::vector<uint8_t>& rgba) {
+    static const uint8_t SIGNATURE[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+    if (size < 8 || std::memcmp(data, SIGNATURE, 8) != 0) return false;
+
+    uint32_t w = 0, h = 0;
+    int bpp = 0;
+    std::vector<uint8_t> z;
+    for (size_t pos = 8; pos + 12 <= size; ) {
+        uint32_t len = getBE32(data + pos);
+        const uint8_t* type = data + pos + 4;
+        const uint8_t* body = data + pos + 8;
+        if (len > size - pos - 12) return false;
+        if (!std::memcmp(type, "IHDR", 4)) {
+            if (len < 13) return false;
+            w = getBE32(body);
+            h = getBE32(body + 4);
+            if (body[8] != 8 || body[12] != 0) return false;   // 8 bits, not interlaced
+            if (body[9] == 2) bpp = 3;
+            else if (body[9] == 6) bpp = 4;
+            else return false;
+        } else if (!std::memcmp(type, "IDAT", 4)) {
+            z.insert(z.end(), body, body + len);
+        } else if (!std::memcmp(type, "IEND", 4)) {
+            break;
+        }
+        pos += 12 + size_t(len);
+    }
+    if (!bpp || w == 0 || h == 0 || w > (1u << 24) || h > (1u << 24)) return false;
+    if (z.size() < 6 || (z[0] & 0x0F) != 8 || (z[1] & 0x20) || ((z[0] << 8) | z[1]) % 31 != 0) return false;
+
+    size_t rowLen = size_t(w) * size_t(bpp);
+    std::vector<uint8_t> raw;
+    raw.reserve(size_t(h) * (rowLen + 1));
+    if (!inflate(z.data() + 2, z.size() - 6, raw) || raw.size() < size_t(h) * (rowLen + 1)) return false;
+
+    width = int(w);
+    height = int(h);
+    rgba.resize(size_t(w) * size_t(h) * 4);
+    std::vector<uint8_t> prev(rowLen, 0), cur(rowLen);
+    for (size_t y = 0; y < h; ++y) {
+        const uint8_t* src = &raw[y * (rowLen + 1)];
+        uint8_t filter = src[0];
+        ++src;
+        for (size_t x = 0; x < rowLen; ++x) {
+            int a = x >= size_t(bpp) ? cur[x - size_t(bpp)] : 0;
+            int b = prev[x];
+            int c = x >= size_t(bpp) ? prev[x - size_t(bpp)] : 0;
+            switch (filter) {
+            case 0: cur[x] = src[x]; break;
+            case 1: cur[x] = uint8_t(src[x] + a); break;
+            case 2: cur[x] = uint8_t(src[x] + b); break;
+            case 3: cur[x] = uint8_t(src[x] + ((a + b) >> 1)); break;
+            case 4: cur[x] = uint8_t(src[x] + paeth(a, b, c)); break;
+            default: return false;
+            }
+        }
+        uint8_t* dst = &rgba[y * size_t(w) * 4];
+        for (size_t x = 0; x < w; ++x) {
+            dst[4*x]     = cur[x * size_t(bpp)];
+            dst[4*x + 1] = cur[x * size_t(bpp) + 1];
+            dst[4*x + 2] = cur[x * size_t(bpp) + 2];
+            dst[4*x + 3] = bpp == 4 ? cur[x * 4 + 3] : 255;
+        }
+        std::swap(prev, cur);
+    }
+    return true;
+}
+
+bool readPng(const char* path, int& width, int& height, std::vector<uint8_t>& rgba) {
+    FILE* f = std::fopen(path, "rb");
+    if (!f) return false;
+    std::vector<uint8_t> data;
+    uint8_t chunk[1 << 16];
+    for (size_t got; (got = std::fread(chunk, 1, sizeof(chunk), f)) > 0; ) data.insert(data.end(), chunk, chunk + got);
+    std::fclose(f);
+
+    if (decodePng(data.data(), data.size(), width, height, rgba)) return true;
+    std::fprintf(stderr, "Cannot decode %s\n", path);
+    return false;
+}
@@ -0,0 +1,23 @@
+// pngreader.h - PNG decoder with a built-in inflate.
+//
+// The counterpart of pngwriter.h, for the viewer's tile pyramid: reads 8-bit
+// RGB and RGBA images without interlacing (everything encodePng() writes, and
+// what most tools write at that depth) without external libraries.
+
+#ifndef PNGREADER_H
+#define PNGREADER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Decode a PNG held in memory into width x height RGBA8 pixels, top row
+// first. Returns false for anything it cannot read.
+bool decodePng(const uint8_t* data, size_t size, int& width, int& height, std::vector<uint8_t>& rgba);
+
+// decodePng() of a file. Returns false if the file does not exist (quietly:
+// sparse tile sets leave files out) or cannot be decoded (with a message on
+// stderr).
+bool readPng(const char* path, int& width, int& height, std::vector<uint8_t>& rgba);
+
+#endif // PNGREADER_H
@@ -0,0 +1,511 @@
+// pngwriter.cpp - PNG encoder with a built-in, multi-threaded deflate.
+
+#include "pngwriter.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+static const size_t PNG_BAND_BYTES    = 1 << 20; // filtered bytes per band (one deflate job)
+static const int    DEFLATE_CHAIN     = 32;      // hash chain steps per match search
+static const int    DEFLATE_GOOD_LEN  = 64;      // stop searching at a match this long
+static const size_t DEFLATE_BLOCK_SYMS = 1 << 16; // tokens per dynamic Huffman block
+
+// ---------------------------- Checksums ----------------------------
+
+struct Crc32Table {
+    uint32_t t[256];
+    Crc32Table() {
+        for (uint32_t n = 0; n < 256; ++n) {
+            uint32_t c = n;
+            for (int k = 0; k < 8; ++k) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            t[n] = c;
+        }
+    }
+};
+
+static uint32_t crc32Update(uint32_t crc, const uint8_t* p, size_t n) {
+    static const Crc32Table table;
+    crc = ~crc;
+    for (size_t i = 0; i < n; ++i) crc = table.t[(crc ^ p[i]) & 0xFF] ^ (crc >> 8);
+    return ~crc;
+}
+
+static const uint32_t ADLER_BASE = 65521;
+
+static uint32_t adler32Update(uint32_t adler, const uint8_t* p, size_t n) {
+    uint32_t a = adler & 0xFFFF, b = adler >> 16;
+    while (n > 0) {
+        size_t run = std::min(n, size_t(5552)); // largest run without 32-bit overflow
+        for (size_t i = 0; i < run; ++i) { a += p[i]; b += a; }
+        a %= ADLER_BASE;
+        b %= ADLER_BASE;
+        p += run;
+        n -= run;
+    }
+    return a | (b << 16);
+}
+
+// Adler-32 of A followed by B, from adler(A), adler(B) and len(B).
+static uint32_t adler32Combine(uint32_t a1, uint32_t a2, size_t len2) {
+    uint32_t rem = uint32_t(len2 % ADLER_BASE);
+    uint32_t sum1 = a1 & 0xFFFF;
+    uint32_t sum2 = uint32_t((uint64_t(rem) * sum1) % ADLER_BASE);
+    sum1 += (a2 & 0xFFFF) + ADLER_BASE - 1;
+    sum2 += (a1 >> 16) + (a2 >> 16) + ADLER_BASE - rem;
+    if (sum1 >= ADLER_BASE) sum1 -= ADLER_BASE;
+    if (sum1 >= ADLER_BASE) sum1 -= ADLER_BASE;
+    if (sum2 >= (ADLER_BASE << 1)) sum2 -= (ADLER_BASE << 1);
+    if (sum2 >= ADLER_BASE) sum2 -= ADLER_BASE;
+    return sum1 | (sum2 << 16);
+}
+
+// ---------------------------- Huffman Codes ----------------------------
+
+// Code lengths (at most maxBits) for the symbols with non-zero frequency.
+// At least two symbols always get a code, so every code is complete.
+static void huffmanLengths(const uint32_t* freq, int n, int maxBits, uint8_t* lens) {
+    std::fill(lens, lens + n, 0);
+    std::vector<std::pair<uint32_t, int>> sym; // (frequency, symbol), ascending
+    for (int i = 0; i < n; ++i)
+        if (freq[i]) sym.push_back({ freq[i], i });
+    if (sym.size() < 2) {
+        int a = sym.empty() ? 0 : sym[0].second;
+        lens[a] = 1;
+        lens[a == 0 ? 1 : 0] = 1;
+        return;
+    }
+    std::sort(sym.begin(), sym.end());
+
+    // Two-queue Huffman: leaves in frequency order, internal nodes in creation
+    // order (which is also non-decreasing), so no heap is needed.
+    size_t m = sym.size();
+    std::vector<uint64_t> weight(2 * m - 1);
+    std::vector<int> parent(2 * m - 1, -1);
+    for (size_t i = 0; i < m; ++i) weight[i] = sym[i].first;
+    size_t leaf = 0, inner = m;
+    for (size_t next = m; next < 2 * m - 1; ++next) {
+        size_t pick[2];
+        for (size_t& k : pick)
+            k = (leaf < m && (inner >= next || weight[leaf] <= weight[inner])) ? leaf++ : inner++;
+        weight[next] = weight[pick[0]] + weight[pick[1]];
+        parent[pick[0]] = parent[pick[1]] = int(next);
+    }
+
+    // Depths, root down; then count codes per length, longer ones folded into maxBits.
+    std::vector<int> depth(2 * m - 1, 0);
+    int count[64] = {};
+    for (size_t i = 2 * m - 1; i-- > 0; ) {
+        if (parent[i] >= 0) depth[i] = depth[size_t(parent[i])] + 1;
+        if (i < m) count[std::min(depth[i], maxBits)]++;
+    }
+
+    // Restore the Kraft sum after folding: each step turns a maxBits code and
+    // a shorter one into two codes one bit longer.
+    uint32_t total = 0;
+    for (int i = 1; i <= maxBits; ++i) total += uint32_t(count[i]) << (maxBits - i);
+    while (total != (1u << maxBits)) {
+        count[maxBits]--;
+        for (int i = maxBits - 1; i > 0; --i) {
+            if (count[i]) { count[i]--; count[i + 1] += 2; break; }
+        }
+        total--;
+    }
+
+    // Rarest symbols get the longest codes.
+    size_t s = 0;
+    for (int len = maxBits; len > 0; --len)
+        for (int k = 0; k < count[len]; ++k) lens[sym[s++].second] = uint8_t(len);
+}
+
+// Canonical codes for the lengths, bit-reversed for LSB-first output.
+static void huffmanCodes(const uint8_t* lens, int n, uint16_t* codes) {
+    int blCount[16] = {}, nextCode[16] = {};
+    for (int i = 0; i < n; ++i) blCount[lens[i]]++;
+    blCount[0] = 0;
+    for (int bits = 1, code = 0; bits < 16; ++bits) {
+        code = (code + blCount[bits - 1]) << 1;
+        nextCode[bits] = code;
+    }
+    for (int i = 0; i < n; ++i) {
+        int len = lens[i];
+        if (!len) { codes[i] = 0; continue; }
+        uint32_t c = uint32_t(nextCode[len]++), r = 0;
+        for (int k = 0; k < len; ++k) { r = (r << 1) | (c & 1); c >>= 1; }
+        codes[i] = uint16_t(r);
+    }
+}
+
+// ---------------------------- Deflate ----------------------------
+
+static const uint16_t LEN_BASE[29]  = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+                                        35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+static const uint8_t  LEN_EXTRA[29] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+                                        3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+static const uint16_t DIST_BASE[30]  = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+                                         257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145,
+                                         8193, 12289, 16385, 24577 };
+static const uint8_t  DIST_EXTRA[30] = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+                                         7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+static const uint8_t  CL_ORDER[19]   = { 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+
+struct DeflateTables {
+    uint8_t lenCode[259];     // match length -> index into LEN_BASE
+    uint8_t distCode[32768];  // distance - 1 -> index into DIST_BASE
+    DeflateTables() {
+        for (int c = 0; c < 29; ++c) {
+            int end = (c + 1 < 29) ? LEN_BASE[c + 1] : 259;
+            for (int l = LEN_BASE[c]; l < end; ++l) lenCode[l] = uint8_t(c);
+        }
+        lenCode[258] = 28;
+        for (int c = 0; c < 30; ++c) {
+            int end = (c + 1 < 30) ? DIST_BASE[c + 1] : 32769;
+            for (int d = DIST_BASE[c]; d < end; ++d) distCode[d - 1] = uint8_t(c);
+        }
+    }
+};
+
+static const DeflateTables& deflateTables() {
+    static const DeflateTables t;
+    return t;
+}
+
+struct BitWriter {
+    std::vector<uint8_t>& out;
+    uint64_t bits = 0;
+    int count = 0;
+
+    explicit BitWriter(std::vector<uint8_t>& o) : out(o) {}
+
+    void put(uint32_t v, int n) {
+        bits |= uint64_t(v) << count;
+        count += n;
+        while (count >= 8) { out.push_back(uint8_t(bits)); bits >>= 8; count -= 8; }
+    }
+
+    void align() { if (count > 0) put(0, 8 - count); }
+};
+
+// Token: literal byte (dist == 0) or a match.
+struct LzToken {
+    uint16_t len;   // literal value when dist == 0
+    uint16_t dist;
+};
+
+static void writeDynamicBlock(BitWriter& bw, const LzToken* tok, size_t n, bool final) {
+    const DeflateTables& T = deflateTables();
+    uint32_t litFreq[286] = {}, distFreq[30] = {};
+    for (size_t i = 0; i < n; ++i) {
+        if (tok[i].dist == 0) { litFreq[tok[i].len]++; continue; }
+        litFreq[257 + T.lenCode[tok[i].len]]++;
+        distFreq[T.distCode[tok[i].dist - 1]]++;
+    }
+    litFreq[256] = 1;
+
+    uint8_t litLen[286], distLen[30];
+    uint16_t litCode[286], distCode[30];
+    huffmanLengths(litFreq, 286, 15, litLen);
+    huffmanLengths(distFreq, 30, 15, distLen);
+    huffmanCodes(litLen, 286, litCode);
+    huffmanCodes(distLen, 30, distCode);
+
+    int hlit = 286, hdist = 30;
+    while (hlit > 257 && !litLen[hlit - 1]) --hlit;
+    while (hdist > 1 && !distLen[hdist - 1]) --hdist;
+
+    // Run-length code the concatenated code lengths (symbols 16, 17, 18).
+    std::vector<uint8_t> lens(litLen, litLen + hlit);
+    lens.insert(lens.end(), distLen, distLen + hdist);
+    std::vector<std::pair<uint8_t, uint8_t>> rle; // (symbol, extra bits value)
+    uint32_t clFreq[19] = {};
+    for (size_t i = 0; i < lens.size(); ) {
+        uint8_t v = lens[i];
+        size_t run = 1;
+        while (i + run < lens.size() && lens[i + run] == v) ++run;
+        size_t left = run;
+        if (v == 0) {
+            while (left >= 11) { size_t k = std::min(left, size_t(138)); rle.push_back({ 18, uint8_t(k - 11) }); left -= k; }
+            if (left >= 3)     { rle.push_back({ 17, uint8_t(left - 3) }); left = 0; }
+        } else {
+            rle.push_back({ v, 0 });
+            --left;
+            while (left >= 3) { size_t k = std::min(left, size_t(6)); rle.push_back({ 16, uint8_t(k - 3) }); left -= k; }
+        }
+        while (left-- > 0) rle.push_back({ v, 0 });
+        i += run;
+    }
+    for (const auto& r : rle) clFreq[r.first]++;
+
+    uint8_t clLen[19];
+    uint16_t clCode[19];
+    huffmanLengths(clFreq, 19, 7, clLen);
+    huffmanCodes(clLen, 19, clCode);
+    int hclen = 19;
+    while (hclen > 4 && !clLen[CL_ORDER[hclen - 1]]) --hclen;
+
+    bw.put(final ? 1 : 0, 1);
+    bw.put(2, 2);
+    bw.put(uint32_t(hlit - 257), 5);
+    bw.put(uint32_t(hdist - 1), 5);
+    bw.put(uint32_t(hclen - 4), 4);
+    for (int i = 0; i < hclen; ++i) bw.put(clLen[CL_ORDER[i]], 3);
+    for (const auto& r : rle) {
+        bw.put(clCode[r.first], clLen[r.first]);
+        if (r.first == 16) bw.put(r.second, 2);
+        if (r.first == 17) bw.put(r.second, 3);
+        if (r.first == 18) bw.put(r.second, 7);
+    }
+
+    for (size_t i = 0; i < n; ++i) {
+        const LzToken& t = tok[i];
+        if (t.dist == 0) { bw.put(litCode[t.len], litLen[t.len]); continue; }
+        int lc = T.lenCode[t.len], dc = T.distCode[t.dist - 1];
+        bw.put(litCode[257 + lc], litLen[257 + lc]);
+        if (LEN_EXTRA[lc]) bw.put(uint32_t(t.len - LEN_BASE[lc]), LEN_EXTRA[lc]);
+        bw.put(distCode[dc], distLen[dc]);
+        if (DIST_EXTRA[dc]) bw.put(uint32_t(t.dist - DIST_BASE[dc]), DIST_EXTRA[dc]);
+    }
+    bw.put(litCode[256], litLen[256]);
+}
+
+// Compress data as a run of deflate blocks ending on a byte boundary: with
+// BFINAL on the last block if final, otherwise followed by an empty stored
+// block (as a sync flush does), so that independently compressed runs can be
+// concatenated. Greedy LZ77 over a 32 KiB window with hash chains.
+static void deflateRun(const uint8_t* data, size_t n, bool final, std::vector<uint8_t>& out) {
+    const size_t WINDOW = 32768, HASH = 1 << 15;
+    std::vector<int32_t> head(HASH, -1), prev(WINDOW, -1);
+    auto hashAt = [&](size_t i) {
+        return ((uint32_t(data[i]) << 10) ^ (uint32_t(data[i + 1]) << 5) ^ data[i + 2]) & (HASH - 1);
+    };
+    auto insert = [&](size_t i) {
+        if (i + 2 >= n) return;
+        uint32_t h = hashAt(i);
+        prev[i & (WINDOW - 1)] = head[h];
+        head[h] = int32_t(i);
+    };
+
+    BitWriter bw(out);
+    std::vector<LzToken> tok;
+    tok.reserve(DEFLATE_BLOCK_SYMS);
+    auto flushBlock = [&](bool last) {
+        writeDynamicBlock(bw, tok.data(), tok.size(), last && final);
+        tok.clear();
+    };
+
+    size_t i = 0;
+    while (i < n) {
+        size_t bestLen = 0, bestDist = 0;
+        if (i + 2 < n) {
+            size_t maxLen = std::min(size_t(258), n - i);
+            int32_t cand = head[hashAt(i)];
+            for (int chain = 0; cand >= 0 && chain < DEFLATE_CHAIN; ++chain) {
+                size_t dist = i - size_t(cand);
+                if (dist > WINDOW - 1) break;
+                if (data[size_t(cand) + bestLen] == data[i + bestLen]) {
+                    size_t len = 0;
+                    while (len < maxLen && data[size_t(cand) + len] == data[i + len]) ++len;
+                    if (len > bestLen) {
+                        bestLen = len;
+                        bestDist = dist;
+                        if (len >= maxLen || len >= size_t(DEFLATE_GOOD_LEN)) break;
+                    }
+                }
+                int32_t p = prev[size_t(cand) & (WINDOW - 1)];
+                if (p >= cand) break; // slot already reused by a newer position
+                cand = p;
+            }
+        }
+
+        if (bestLen >= 3) {
+            tok.push_back({ uint16_t(bestLen), uint16_t(bestDist) });
+            for (size_t k = 0; k < bestLen; ++k) insert(i + k);
+            i += bestLen;
+        } else {
+            tok.push_back({ data[i], 0 });
+            insert(i);
+            ++i;
+        }
+        if (tok.size() == DEFLATE_BLOCK_SYMS && i < n) flushBlock(false);
+    }
+    flushBlock(true);
+
+    if (!final) {
+        bw.put(0, 3); // BFINAL 0, stored
+        bw.align();
+        out.push_back(0x00); out.push_back(0x00);
+        out.push_back(0xFF); out.push_back(0xFF);
+    } else {
+        bw.align();
+    }
+}
+
+// ---------------------------- Filtering ----------------------------
+
+static uint8_t paeth(int a, int b, int c) {
+    int p = a + b - c;
+    int pa = std::abs(p - a), pb = std::abs(p - b), pc = std::abs(p - c);
+    if (pa <= pb && pa <= pc) return uint8_t(a);
+    return uint8_t(pb <= pc ? b : c);
+}
+
+// Filter type byte + filtered row, for the filter with the smallest sum of
+// absolute (signed) residuals. prev is all zeros for the first row.
+static void filterRow(const uint8_t* cur, const uint8_t* prev, size_t len, int bpp,
+                      std::vector<uint8_t> cand[5], uint8_t* out) {
+    size_t bestSum = ~size_t(0);
+    int best = 0;
+    for (int f = 0; f < 5; ++f) {
+        uint8_t* o = cand[f].data();
+        size_t sum = 0;
+        for (size_t i = 0; i < len; ++i) {
+            int a = i >= size_t(bpp) ? cur[i - bpp] : 0;
+            int b = prev[i];
+            int c = i >= size_t(bpp) ? prev[i - bpp] : 0;
+            uint8_t pred = 0;
+            switch (f) {
+            case 1: pred = uint8_t(a); break;
+            case 2: pred = uint8_t(b); break;
+            case 3: pred = uint8_t((a + b) >> 1); break;
+            case 4: pred = paeth(a, b, c); break;
+            }
+            uint8_t v = uint8_t(cur[i] - pred);
+            o[i] = v;
+            sum += v < 128 ? v : 256 - v;
+        }
+        if (sum < bestSum) { bestSum = sum; best = f; }
+    }
+    out[0] = uint8_t(best);
+    std::memcpy(out + 1, cand[best].data(), len);
+}
+
+// ---------------------------- PNG ----------------------------
+
+static void putBE32(std::vector<uint8_t>& out, uint32_t v) {
+    out.push_back(uint8_t(v >> 24)); out.push_back(uint8_t(v >> 16));
+    out.push_back(uint8_t(v >> 8));  out.push_back(uint8_t(v));
+}
+
+// Chunk with its CRC (crc of type + data, computed by the caller if known).
+static void putChunk(std::vector<uint8_t>& out, const char* type, const uint8_t* data, size_t n, uint32_t crc) {
+    putBE32(out, uint32_t(n));
+    out.insert(out.end(), type, type + 4);
+    out.insert(out.end(), data, data + n);
+    putBE32(out, crc);
+}
+
+static uint32_t chunkCrc(const char* type, const uint8_t* data, size_t n) {
+    return crc32Update(crc32Update(0, reinterpret_cast<const uint8_t*>(type), 4), data, n);
+}
+
+struct PngBand {
+    int y0, y1;                 // rows
+    std::vector<uint8_t> zdata; // deflate run
+    uint32_t adler = 1;         // of the filtered bytes
+    size_t rawBytes = 0;
+    uint32_t crc = 0;           // of "IDAT" + zdata
+};
+
+std::vector<uint8_t> encodePng(const uint8_t* rgba, int width, int height, bool bottomUp, int threads) {
+    size_t W = size_t(std::max(width, 0)), H = size_t(std::max(height, 0));
+    auto srcRow = [&](size_t y) { return rgba + (bottomUp ? H - 1 - y : y) * W * 4; };
+
+    bool opaque = true;
+    for (size_t i = 3; opaque && i < W * H * 4; i += 4) opaque = rgba[i] == 255;
+    int bpp = opaque ? 3 : 4;
+    size_t rowLen = W * size_t(bpp);
+
+    std::vector<PngBand> bands;
+    size_t bandRows = std::max(size_t(1), PNG_BAND_BYTES / (rowLen + 1));
+    for (size_t y = 0; y < H; y += bandRows)
+        bands.push_back({ int(y), int(std::min(H, y + bandRows)), {}, 1, 0, 0 });
+
+    // Workers take the next band; each band needs only its own rows and the
+    // row above it.
+    std::atomic<size_t> next{ 0 };
+    auto worker = [&]() {
+        std::vector<uint8_t> cur(rowLen), prev(rowLen), filtered;
+        std::vector<uint8_t> cand[5];
+        for (auto& c : cand) c.resize(rowLen);
+        auto loadRow = [&](size_t y, std::vector<uint8_t>& dst) {
+            const uint8_t* s = srcRow(y);
+            if (!opaque) { std::memcpy(dst.data(), s, rowLen); return; }
+            for (size_t x = 0; x < W; ++x) {
+                dst[3*x] = s[4*x]; dst[3*x + 1] = s[4*x + 1]; dst[3*x + 2] = s[4*x + 2];
+            }
+        };
+
+        for (size_t b; (b = next.fetch_add(1)) < bands.size(); ) {
+            PngBand& band = bands[b];
+            filtered.resize(size_t(band.y1 - band.y0) * (rowLen + 1));
+            if (band.y0 > 0) loadRow(size_t(band.y0 - 1), prev);
+            else             std::fill(prev.begin(), prev.end(), 0);
+            for (int y = band.y0; y < band.y1; ++y) {
+                loadRow(size_t(y), cur);
+                filterRow(cur.data(), prev.data(), rowLen, bpp, cand,
+                          &filtered[size_t(y - band.y0) * (rowLen + 1)]);
+                std::swap(cur, prev);
+            }
+            band.rawBytes = filtered.size();
+            band.adler = adler32Update(1, filtered.data(), filtered.size());
+            deflateRun(filtered.data(), filtered.size(), b + 1 == bands.size(), band.zdata);
+            band.crc = chunkCrc("IDAT", band.zdata.data(), band.zdata.size());
+        }
+    };
+
+    size_t workers = threads > 0 ? size_t(threads) : std::max(1u, std::thread::hardware_concurrency());
+    workers = std::max(size_t(1), std::min(workers, bands.size()));
+    std::vector<std::thread> pool;
+    for (size_t t = 1; t < workers; ++t) pool.emplace_back(worker);
+    worker();
+    for (auto& t : pool) t.join();
+
+    std::vector<uint8_t> png = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+    std::vector<uint8_t> ihdr;
+    putBE32(ihdr, uint32_t(W));
+    putBE32(ihdr, uint32_t(H));
+    ihdr.push_back(8);                       // bit depth
+    ihdr.push_back(opaque ? 2 : 6);          // RGB / RGBA
+    ihdr.push_back(0); ihdr.push_back(0); ihdr.push_back(0);
+    putChunk(png, "IHDR", ihdr.data(), ihdr.size(), chunkCrc("IHDR", ihdr.data(), ihdr.size()));
+
+    // zlib header, the bands, then the Adler-32 trailer, each in its own IDAT.
+    const uint8_t zhead[2] = { 0x78, 0x01 };
+    putChunk(png, "IDAT", zhead, 2, chunkCrc("IDAT", zhead, 2));
+    uint32_t adler = 1;
+    for (const PngBand& band : bands) {
+        putChunk(png, "IDAT", band.zdata.data(), band.zdata.size(), band.crc);
+        adler = adler32Combine(adler, band.adler, band.rawBytes);
+    }
+    if (bands.empty()) {
+        // No rows: an empty final stored block.
+        const uint8_t empty[5] = { 0x01, 0x00, 0x00, 0xFF, 0xFF };
+        putChunk(png, "IDAT", empty, 5, chunkCrc("IDAT", empty, 5));
+    }
+    std::vector<uint8_t> trailer;
+    putBE32(trailer, adler);
+    putChunk(png, "IDAT", trailer.data(), 4, chunkCrc("IDAT", trailer.data(), 4));
+    putChunk(png, "IEND", nullptr, 0, chunkCrc("IEND", nullptr, 0));
+    return png;
+}
+
+std::vector<uint8_t> zlibCompress(const uint8_t* data, size_t n) {
+    std::vector<uint8_t> z = { 0x78, 0x01 };
+    deflateRun(data, n, true, z);
+    uint32_t adler = adler32Update(1, data, n);
+    putBE32(z, adler);
+    return z;
+}
+
+bool writePng(const char* path, const uint8_t* rgba, int width, int height, bool bottomUp, int threads) {
+    std::vector<uint8_t> png = encodePng(rgba, width, height, bottomUp, threads);
+    FILE* f = std::fopen(path, "wb");
+    if (!f) { std::fprintf(stderr, "Cannot write %s\n", path); return false; }
+    bool ok = std::fwrite(png.data(), 1, png.size(), f) == png.size();
+    ok = (std::fclose(f) == 0) && ok;
+    if (!ok) std::fprintf(stderr, "Error writing %s\n", path);
+    return ok;
+}
@@ -0,0 +1,30 @@
+// pngwriter.h - PNG encoder with a built-in, multi-threaded deflate.
+//
+// Needs nothing beyond the C++ standard library. The image is cut into row
+// bands; worker threads filter each band (per row, the PNG filter with the
+// smallest sum of absolute differences) and compress it into its own run of
+// dynamic-Huffman deflate blocks, byte-aligned with an empty stored block.
+// The bands are stitched into one zlib stream, each band in its own IDAT
+// chunk, with the Adler-32 and chunk CRCs also computed by the workers.
+
+#ifndef PNGWRITER_H
+#define PNGWRITER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Encode width x height RGBA8 pixels (rows of width * 4 bytes, top row
+// first, or last if bottomUp as read back from GL). Fully opaque images are
+// stored as RGB. threads <= 0: one per core.
+std::vector<uint8_t> encodePng(const uint8_t* rgba, int width, int height, bool bottomUp, int threads);
+
+// zlib stream (RFC 1950) of n bytes, compressed on the calling thread with
+// the same deflate. For other formats that store deflate data (tiled TIFF).
+std::vector<uint8_t> zlibCompress(const uint8_t* data, size_t n);
+
+// encodePng() into a file. Returns false (after a message on stderr) if the
+// file cannot be written.
+bool writePng(const char* path, const uint8_t* rgba, int width, int height, bool bottomUp, int threads);
+
+#endif // PNGWRITER_H
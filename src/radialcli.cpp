@@ -0,0 +1,399 @@
+// radialcli.cpp - headless batch layout of FreeMind maps.
+//
+// Parses, lays out and exports any number of maps without a display: no GL
+// is linked or initialized. Files are processed on a pool of worker threads
+// (one map per worker at a time) and a table of per-file parse, layout and
+// export timings is printed once all are done.
+//
+// Usage:
+//   radialcli [options] map.mm...
+//
+// Options:
+//   -o DIR       write outputs to DIR (default: next to each input)
+//   -f FORMAT    csv (default): one line per placed node (layoutexport.h)
+//                json: the same rows as an array of objects
+//                layout: the same rows as a binary columnar file to mmap
+//                (LayoutFile in layoutexport.h), without the text; each file
+//                is mapped back and checked against the map once written
+//                svg: links, endpoint circles and labels as in the viewer
+//                none: parse and lay out only
+//                png: -s sized raster from the software rasterizer
+//                pam: the same raster, uncompressed
+//                tif: -s sized poster as a tiled TIFF, rendered tile by
+//                tile in bounded memory (up to 1048576 a side)
+//                tiles: tile pyramid for the viewer's tile mode (<map>.tiles/,
+//                see tilepyramid.h), labels decluttered per level
+//                frames: the viewer's rotation animation as a numbered PNG
+//                sequence (<map>-00000.png...), one full turn in -n frames
+//   -p DIGITS    SVG coordinate precision, decimal places (default: 2)
+//   -s SIZE      raster width and height in pixels, or WxH (default: 2048; at
+//                most 32768 for png, pam and frames, encoded from one image)
+//   -t TILE      tile edge in pixels, a multiple of 16 (default: 512 for
+//                tif, 256 for tiles)
+//   -L LEVELS    tile pyramid levels (default: 6, the last one 32 tiles across)
+//   -n FRAMES    frames per turn (default: 600, 25 fps at the viewer's 15 deg/s)
+//   -b RUNS      benchmark the software rasterizer instead of exporting:
+//                files one after another, best of RUNS on 1 and on all threads
+//   -j N         worker threads (default: one per core)
+//   -r STEP      ring spacing in world units (default: 35)
+//
+// Exit status is 1 if any file failed. No GL is needed for any format: raster
+// output comes from the software rasterizer (softraster.h).
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <chrono>
+#include <atomic>
+#include <thread>
+
+#include "mindmap.h"
+#include "layoutexport.h"
+#include "svgexport.h"
+#include "softraster.h"
+#include "pngwriter.h"
+#include "tilepyramid.h"
+
+// ---------------------------- Options ----------------------------
+
+enum class OutputFormat { None, Csv, Json, Layout, Svg, Png, Pam, Tif, Tiles, Frames };
+
+struct Options {
+    std::string outDir;
+    OutputFormat format = OutputFormat::Csv;
+    int threads = 0;            // 0: one per core
+    float radiusStep = 35.0f;   // same default as the viewer's RADIUS_STEP
+    int precision = 2;          // SVG decimal places
+    int width = 2048, height = 2048; // raster pixels
+    int tileSize = 0;           // TIFF or pyramid tile edge (0: the format's default)
+    int levels = 6;             // tile pyramid levels
+    int frames = 600;           // rotation frames per turn
+    int benchRuns = 0;          // > 0: rasterizer benchmark
+    int rasterThreads = 1;      // per file, set from the pool size
+    std::vector<const char*> inputs;
+};
+
+static void printUsage() {
+    std::fprintf(stderr,
+        "usage: radialcli [-o DIR] [-f csv|json|layout|svg|png|pam|tif|tiles|frames|none] [-j N] [-r STEP] [-p DIGITS] [-s SIZE|WxH] [-t TILE] [-L LEVELS] [-n FRAMES] [-b RUNS] map.mm...\n");
+}
+
+static bool parseOptions(int argc, char** argv, Options& opt) {
+    for (int i = 1; i < argc; ++i) {
+        const char* a = argv[i];
+        if (a[0] != '-' || !a[1]) { opt.inputs.push_back(a); continue; }
+        if (i + 1 >= argc) { std::fprintf(stderr, "%s needs a value\n", a); return false; }
+        const char* v = argv[++i];
+        if (!std::strcmp(a, "-o")) {
+            opt.outDir = v;
+        } else if (!std::strcmp(a, "-f")) {
+            if (!std::strcmp(v, "csv"))       opt.format = OutputFormat::Csv;
+            else if (!std::strcmp(v, "json")) opt.format = OutputFormat::Json;
+            else if (!std::strcmp(v, "layout")) opt.format = OutputFormat::Layout;
+            else if (!std::strcmp(v, "svg"))  opt.format = OutputFormat::Svg;
+            else if (!std::strcmp(v, "png"))  opt.format = OutputFormat::Png;
+            else if (!std::strcmp(v, "pam"))  opt.format = OutputFormat::Pam;
+            else if (!std::strcmp(v, "tif"))  opt.format = OutputFormat::Tif;
+            else if (!std::strcmp(v, "tiles")) opt.format = OutputFormat::Tiles;
+            else if (!std::strcmp(v, "frames")) opt.format = OutputFormat::Frames;
+            else if (!std::strcmp(v, "none")) opt.format = OutputFormat::None;
+            else { std::fprintf(stderr, "unknown format: %s\n", v); return false; }
+        } else if (!std::strcmp(a, "-j")) {
+            opt.threads = std::atoi(v);
+        } else if (!std::strcmp(a, "-r")) {
+            opt.radiusStep = float(std::atof(v));
+        } else if (!std::strcmp(a, "-p")) {
+            opt.precision = std::atoi(v);
+        } else if (!std::strcmp(a, "-s")) {
+            const char* x = std::strchr(v, 'x');
+            opt.width = std::clamp(std::atoi(v), 1, 1 << 20);
+            opt.height = x ? std::clamp(std::atoi(x + 1), 1, 1 << 20) : opt.width;
+        } else if (!std::strcmp(a, "-t")) {
+            opt.tileSize = std::clamp(std::atoi(v) / 16 * 16, 16, 1 << 14);
+        } else if (!std::strcmp(a, "-L")) {
+            opt.levels = std::clamp(std::atoi(v), 1, 16);
+        } else if (!std::strcmp(a, "-n")) {
+            opt.frames = std::clamp(std::atoi(v), 1, 1000000);
+        } else if (!std::strcmp(a, "-b")) {
+            opt.benchRuns = std::max(1, std::atoi(v));
+        } else {
+            std::fprintf(stderr, "unknown option: %s\n", a);
+            return false;
+        }
+    }
+    if (opt.tileSize == 0) opt.tileSize = opt.format == OutputFormat::Tiles ? 256 : 512;
+    bool inMemory = opt.benchRuns > 0 || opt.format == OutputFormat::Png || opt.format == OutputFormat::Pam ||
+                    opt.format == OutputFormat::Frames;
+    if (inMemory && std::max(opt.width, opt.height) > (1 << 15)) {
+        std::fprintf(stderr, "-s %dx%d is too large for one image; use -f tif\n", opt.width, opt.height);
+        return false;
+    }
+    return !opt.inputs.empty();
+}
+
+// Output file for an input: its base name with the format's extension, in
+// outDir if given, else next to the input.
+static std::string outputPath(const Options& opt, const char* input, const char* ext) {
+    std::string in = input;
+    size_t slash = in.find_last_of('/');
+    std::string dir  = slash == std::string::npos ? std::string() : in.substr(0, slash + 1);
+    std::string base = slash == std::string::npos ? in : in.substr(slash + 1);
+    size_t dot = base.find_last_of('.');
+    if (dot != std::string::npos && dot > 0) base.resize(dot);
+    if (!opt.outDir.empty()) dir = opt.outDir + "/";
+    return dir + base + ext;
+}
+
+// ---------------------------- Export ----------------------------
+
+// The whole map fitted into a WxH image.
+static RasterStats renderMap(const Options& opt, const MindMap& map, RasterImage& image, int threads) {
+    RasterOptions ro;
+    ro.radiusStep = opt.radiusStep;
+    auto ranges = placedRanges(map);
+    RasterView view = fitRasterView(map.nodes, ranges, map.root.get(), ro, opt.width, opt.height);
+    SoftRaster raster(view.width, view.height);
+    rasterMap(raster, map.nodes, ranges, map.root.get(), ro, view);
+    return raster.render(image, rasterColor(1.0f, 1.0f, 1.0f, 1.0f), threads);
+}
+
+// ---------------------------- Layout File Check ----------------------------
+
+// Map a written layout file back in place and compare every row with the
+// nodes it was exported from: same order, parents through their rows' IDs,
+// and bit-identical numbers.
+static bool checkLayoutFile(const char* path, const MindMap& map) {
+    LayoutFile lf;
+    if (!lf.open(path)) return false;
+
+    size_t row = 0;
+    const char* bad = nullptr;
+    std::vector<int32_t> rowOf(map.nodes.size(), -1);
+    forEachSlot(map.nodes, placedRanges(map), [&](const Node* n) {
+        if (bad) return;
+        if (row >= lf.rows) { bad = "row count"; return; }
+        rowOf[size_t(n->index)] = int32_t(row);
+        int32_t p = lf.parent[row];
+        if (n->parent ? (p < 0 || size_t(p) >= row || lf.id(size_t(p)) != n->parent->id) : p != -1)
+            bad = "parent";
+        else if (lf.depth[row] != n->depth || lf.leaves[row] != n->leafCount)
+            bad = "depth or leaves";
+        else if (std::memcmp(&lf.angle[row], &n->angle, sizeof(float)) != 0 ||
+                 std::memcmp(&lf.radius[row], &n->radius, sizeof(float)) != 0 ||
+                 std::memcmp(&lf.x[row], &n->x, sizeof(float)) != 0 ||
+                 std::memcmp(&lf.y[row], &n->y, sizeof(float)) != 0)
+            bad = "angle, radius or position";
+        else if (lf.id(row) != n->id)
+            bad = "id";
+        else if (n->parent && rowOf[size_t(n->parent->index)] != p)
+            bad = "parent row";
+        if (!bad) ++row;
+    });
+    if (!bad && row != lf.rows) bad = "row count";
+    if (bad) std::fprintf(stderr, "%s: %s differs from the map at row %zu\n", path, bad, row);
+    return !bad;
+}
+
+// ---------------------------- Batch ----------------------------
+
+struct FileResult {
+    bool ok = false;
+    size_t nodes = 0;
+    double parseMs = 0.0, layoutMs = 0.0, exportMs = 0.0;
+};
+
+static double msSince(std::chrono::steady_clock::time_point t0) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+}
+
+static FileResult processFile(const Options& opt, const char* input) {
+    FileResult r;
+    MindMap map;
+    int autoId = 1;
+
+    auto t0 = std::chrono::steady_clock::now();
+    map.root = loadFreeMind(input, autoId);
+    r.parseMs = msSince(t0);
+    if (!map.root) return r;
+
+    t0 = std::chrono::steady_clock::now();
+    layoutMindMap(map, opt.radiusStep);
+    r.layoutMs = msSince(t0);
+    r.nodes = map.nodes.size();
+
+    t0 = std::chrono::steady_clock::now();
+    switch (opt.format) {
+    case OutputFormat::None: r.ok = true; break;
+    case OutputFormat::Csv:
+        r.ok = exportLayoutCsv(outputPath(opt, input, ".csv").c_str(), map.nodes, placedRanges(map),
+                               opt.rasterThreads);
+        break;
+    case OutputFormat::Json:
+        r.ok = exportLayoutJson(outputPath(opt, input, ".json").c_str(), map.nodes, placedRanges(map),
+                                opt.rasterThreads);
+        break;
+    case OutputFormat::Layout: {
+        std::string path = outputPath(opt, input, ".layout");
+        r.ok = exportLayoutBinary(path.c_str(), map.nodes, placedRanges(map)) && checkLayoutFile(path.c_str(), map);
+        break;
+    }
+    case OutputFormat::Svg: {
+        SvgOptions svg;
+        svg.radiusStep = opt.radiusStep;
+        svg.precision = opt.precision;
+        r.ok = exportSvg(outputPath(opt, input, ".svg").c_str(), map.nodes, placedRanges(map), map.root.get(), svg);
+        break;
+    }
+    case OutputFormat::Png: {
+        RasterImage image;
+        renderMap(opt, map, image, opt.rasterThreads);
+        r.ok = writePng(outputPath(opt, input, ".png").c_str(), image.rgba.data(), image.width, image.height,
+                        false, opt.rasterThreads);
+        break;
+    }
+    case OutputFormat::Tif: {
+        RasterOptions ro;
+        ro.radiusStep = opt.radiusStep;
+        ro.threads = opt.rasterThreads;
+        auto ranges = placedRanges(map);
+        RasterView view = fitRasterView(map.nodes, ranges, map.root.get(), ro, opt.width, opt.height);
+        r.ok = writePosterTiff(outputPath(opt, input, ".tif").c_str(), map.nodes, ranges, map.root.get(),
+                               ro, view, opt.tileSize);
+        break;
+    }
+    case OutputFormat::Tiles: {
+        RasterOptions ro;
+        ro.radiusStep = opt.radiusStep;
+        ro.threads = opt.rasterThreads;
+        r.ok = writeTilePyramid(outputPath(opt, input, ".tiles").c_str(), map.nodes, placedRanges(map),
+                                map.root.get(), ro, opt.tileSize, opt.levels);
+        break;
+    }
+    case OutputFormat::Frames: {
+        RasterOptions ro;
+        ro.radiusStep = opt.radiusStep;
+        ro.threads = opt.rasterThreads;
+        auto ranges = placedRanges(map);
+        RasterView view = fitRasterView(map.nodes, ranges, map.root.get(), ro, opt.width, opt.height);
+        r.ok = writeRotationFrames(outputPath(opt, input, ""), map.nodes, ranges, map.root.get(), ro, view,
+                                   opt.frames);
+        break;
+    }
+    case OutputFormat::Pam: {
+        RasterImage image;
+        renderMap(opt, map, image, opt.rasterThreads);
+        r.ok = writePam(outputPath(opt, input, ".pam").c_str(), image);
+        break;
+    }
+    }
+    r.exportMs = msSince(t0);
+    return r;
+}
+
+// ---------------------------- Rasterizer Benchmark ----------------------------
+
+template <typename Fn>
+static double bestOfMs(int runs, Fn fn) {
+    double best = 1e30;
+    for (int r = 0; r < runs; ++r) {
+        auto t0 = std::chrono::steady_clock::now();
+        fn();
+        best = std::min(best, msSince(t0));
+    }
+    return best;
+}
+
+// Scene recording, then binning plus rasterization on one thread and on all
+// workers. Throughput counts output pixels and recorded primitives.
+static int runRasterBenchmark(const Options& opt, size_t workers) {
+    std::printf("Rasterizer benchmark: %dx%d, best of %d\n", opt.width, opt.height, opt.benchRuns);
+    std::printf("%10s %10s %9s  %-28s  %-28s  %s\n", "nodes", "prims", "scene ms",
+                "1 thread: ms  MP/s  Mprim/s", "all threads: ms  MP/s  Mprim/s", "file");
+    int failed = 0;
+    for (const char* input : opt.inputs) {
+        MindMap map;
+        int autoId = 1;
+        map.root = loadFreeMind(input, autoId);
+        if (!map.root) { ++failed; continue; }
+        layoutMindMap(map, opt.radiusStep);
+
+        RasterOptions ro;
+        ro.radiusStep = opt.radiusStep;
+        auto ranges = placedRanges(map);
+        RasterView view = fitRasterView(map.nodes, ranges, map.root.get(), ro, opt.width, opt.height);
+        SoftRaster raster(view.width, view.height);
+        double sceneMs = bestOfMs(opt.benchRuns, [&]() {
+            raster.prims.clear();
+            rasterMap(raster, map.nodes, ranges, map.root.get(), ro, view);
+        });
+
+        RasterImage image;
+        uint32_t white = rasterColor(1.0f, 1.0f, 1.0f, 1.0f);
+        double ms[2];
+        int threads[2] = { 1, int(workers) };
+        for (int k = 0; k < 2; ++k)
+            ms[k] = bestOfMs(opt.benchRuns, [&]() { raster.render(image, white, threads[k]); });
+
+        double mpix = double(opt.width) * double(opt.height) * 1e-6;
+        double mprims = double(raster.prims.size()) * 1e-6;
+        std::printf("%10zu %10zu %9.2f  %9.2f %7.1f %8.2f    %9.2f %7.1f %8.2f (%zu)  %s\n",
+                    map.nodes.size(), raster.prims.size(), sceneMs,
+                    ms[0], mpix / (ms[0] * 1e-3), mprims / (ms[0] * 1e-3),
+                    ms[1], mpix / (ms[1] * 1e-3), mprims / (ms[1] * 1e-3), workers, input);
+    }
+    return failed ? 1 : 0;
+}
+
+int main(int argc, char** argv) {
+    Options opt;
+    if (!parseOptions(argc, argv, opt)) { printUsage(); return 2; }
+
+    size_t files = opt.inputs.size();
+    size_t cores = opt.threads > 0 ? size_t(opt.threads) : std::max(1u, std::thread::hardware_concurrency());
+    if (opt.benchRuns > 0) return runRasterBenchmark(opt, cores);
+
+    // Maps are spread over the pool; cores left over go to each map's rasterizer.
+    size_t threads = std::min(cores, files);
+    opt.rasterThreads = int(std::max<size_t>(1, cores / threads));
+
+    // Workers take the next file index until the list runs out; each result
+    // has its own slot, so nothing else is shared.
+    std::vector<FileResult> results(files);
+    std::atomic<size_t> next{ 0 };
+    auto worker = [&]() {
+        for (size_t i; (i = next.fetch_add(1)) < files; )
+            results[i] = processFile(opt, opt.inputs[i]);
+    };
+
+    auto t0 = std::chrono::steady_clock::now();
+    std::vector<std::thread> pool;
+    for (size_t t = 1; t < threads; ++t) pool.emplace_back(worker);
+    worker();
+    for (auto& th : pool) th.join();
+    double wallMs = msSince(t0);
+
+    int failed = 0;
+    size_t totalNodes = 0;
+    double parseMs = 0.0, layoutMs = 0.0, exportMs = 0.0;
+    std::printf("%10s %10s %10s %10s  %s\n", "nodes", "parse ms", "layout ms", "export ms", "file");
+    for (size_t i = 0; i < files; ++i) {
+        const FileResult& r = results[i];
+        if (r.ok) {
+            std::printf("%10zu %10.2f %10.2f %10.2f  %s\n", r.nodes, r.parseMs, r.layoutMs, r.exportMs, opt.inputs[i]);
+        } else {
+            std::printf("%10s %10s %10s %10s  %s\n", "-", "-", "-", "-", opt.inputs[i]);
+            ++failed;
+        }
+        totalNodes += r.nodes;
+        parseMs += r.parseMs;
+        layoutMs += r.layoutMs;
+        exportMs += r.exportMs;
+    }
+    std::printf("%10zu %10.2f %10.2f %10.2f  total (%zu files, %d failed, %zu threads, %.2f ms wall)\n",
+                totalNodes, parseMs, layoutMs, exportMs, files, failed, threads, wallMs);
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,105 @@
+// radialfeed.cpp - follow a running viewer's live layout feed.
+//
+// An example client of layoutfeed.h: maps the viewer's shared memory and,
+// whenever the layout or the camera changes, prints a line about it. Layout
+// figures (bounds, deepest node) are computed on the published arrays in
+// place and thrown away if the viewer overwrote them meanwhile. Waits for the
+// feed to appear and follows it across segment replacements; given a PID,
+// exits once that process has quit.
+//
+// Usage:
+//   radialfeed PID|NAME [INTERVAL_MS]
+//
+// PID is the viewer's process ID (the feed is /radialgl-<pid>); NAME is a
+// shared memory name starting with '/'. INTERVAL_MS is the polling interval
+// (default: 50).
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+#include <signal.h>
+
+#include "layoutfeed.h"
+
+// Bounds and depth of a layout, straight from the feed.
+struct LayoutSummary {
+    size_t rows = 0;
+    float x0 = 0.0f, y0 = 0.0f, x1 = 0.0f, y1 = 0.0f;
+    int depth = 0;
+};
+
+static bool summarize(const LayoutFeedReader& feed, uint64_t& update, LayoutSummary& s) {
+    for (;;) {
+        LayoutFeedReader::Layout L;
+        if (!feed.begin(L)) return false;
+        s = LayoutSummary();
+        s.rows = L.rows;
+        if (L.rows) {
+            s.x0 = s.x1 = L.x[0];
+            s.y0 = s.y1 = L.y[0];
+        }
+        for (size_t i = 0; i < L.rows; ++i) {
+            s.x0 = std::min(s.x0, L.x[i]); s.x1 = std::max(s.x1, L.x[i]);
+            s.y0 = std::min(s.y0, L.y[i]); s.y1 = std::max(s.y1, L.y[i]);
+            s.depth = std::max(s.depth, int(L.depth[i]));
+        }
+        if (feed.end(L)) { update = L.update; return true; }
+    }
+}
+
+static bool sameView(const LayoutFeedView& a, const LayoutFeedView& b) {
+    return a.layout == b.layout && a.panX == b.panX && a.panY == b.panY && a.zoom == b.zoom &&
+           a.rotDeg == b.rotDeg && a.winW == b.winW && a.winH == b.winH && a.flags == b.flags;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::fprintf(stderr, "usage: radialfeed PID|NAME [INTERVAL_MS]\n");
+        return 2;
+    }
+    std::string name = argv[1][0] == '/' ? std::string(argv[1]) : layoutFeedName(std::atoi(argv[1]));
+    int intervalMs = argc >= 3 ? std::max(1, std::atoi(argv[2])) : 50;
+    int pid = argv[1][0] == '/' ? 0 : std::atoi(argv[1]);
+
+    LayoutFeedReader feed;
+    uint64_t shownLayout = 0;
+    LayoutFeedView shownView;
+    bool announced = false;
+    for (;;) {
+        if (feed.stale()) {
+            if (!feed.open(name.c_str())) {
+                if (pid > 0 && ::kill(pid, 0) != 0) break; // the viewer is gone
+                if (!announced) { std::printf("waiting for %s\n", name.c_str()); std::fflush(stdout); announced = true; }
+                std::this_thread::sleep_for(std::chrono::milliseconds(intervalMs));
+                continue;
+            }
+            std::printf("opened %s\n", name.c_str());
+            shownLayout = 0;
+            shownView = LayoutFeedView();
+        }
+
+        uint64_t update = 0;
+        LayoutSummary s;
+        LayoutFeedReader::Layout peek;
+        if (feed.begin(peek) && peek.update != shownLayout && summarize(feed, update, s)) {
+            std::printf("layout %llu: %zu nodes, depth %d, x %.1f..%.1f, y %.1f..%.1f\n",
+                        (unsigned long long)update, s.rows, s.depth, s.x0, s.x1, s.y0, s.y1);
+            shownLayout = update;
+        }
+
+        LayoutFeedView v;
+        if (feed.view(v) && !sameView(v, shownView)) {
+            std::printf("view: pan %.2f %.2f, zoom %.3f, rotation %.1f, %dx%d, focus row %d%s\n",
+                        v.panX, v.panY, v.zoom, v.rotDeg, v.winW, v.winH, v.focus,
+                        (v.flags & FEED_HYPERBOLIC) ? ", hyperbolic" : "");
+            shownView = v;
+        }
+        std::fflush(stdout);
+        std::this_thread::sleep_for(std::chrono::milliseconds(intervalMs));
+    }
+    return 0;
+}
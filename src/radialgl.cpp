@@ -1,28 +1,76 @@
 //
+// Usage:
+//   radialgl [map.mm]           open the map (default: example.mm)
+//   radialgl --bench map.mm     time the render kernels, no window
+//   radialgl --compare map.mm [size]  error of the software rasterizer against GL
+//   (headless batch layout and export without GL: see radialcli.cpp)
+//
 // Controls:
 //   - Mouse wheel: zoom (or +/- keys if wheel not supported)
 //   - Left drag: pan
+//   - Left click: select node (hover highlights the node under the cursor)
+//   - Right click: fold/unfold the subtree under the cursor
+//   - Middle click: re-center the layout on the node under the cursor (H: back to the root)
 //   - L: toggle leaf-only labels
 //   - F: toggle fullscreen
 //   - R: toggle rotation animation (around Z)
 //   - [ / ]: rotation speed down/up
 //   - T: toggle "constant screen-size" labels (scale ~ 1/g_zoom)
 //   - C: toggle curved Bezier links vs straight links
+//   - , / .: ring spacing down/up
+//   - V: toggle level-of-detail aggregation of subpixel subtrees
+//   - Z: toggle semantic zoom (deeper levels appear as you zoom in)
+//   - G: toggle progressive rendering (bounded work per frame, refined over frames)
+//   - P: toggle hyperbolic (Poincare disk) view; left drag then moves the focus
+//   - F5: reload the map file (nodes are matched by ID and animate to their new places)
+//   - D: toggle label decluttering (skip/truncate overlapping labels)
+//   - E: export the current view as SVG (<map name>.svg in the working directory)
+//   - S: screenshot at up to 8K (<map name>-<n>.png), read back and encoded in the background
+//   - B: toggle the live feed: layout and camera in shared memory for other processes
+//        (/radialgl-<pid>, see layoutfeed.h; radialfeed prints it)
+//   - M: toggle tile mode: with a tile pyramid next to the map (radialcli -f tiles), overview
+//        zoom levels are drawn from its tiles; deeper zoom and edited layouts are drawn live
+//   - /: incremental search (type to filter, Enter: next match, ESC: leave search)
 //   - ESC: quit
 
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <cctype>
 #include <string>
 #include <vector>
 #include <memory>
 #include <cmath>
 #include <algorithm>
-
-#include "tinyxml2.h"
-
+#include <chrono>
+#include <cstdint>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <list>
+#include <unordered_map>
+#include <unordered_set>
+
+#include <unistd.h>
+
+#include "mindmap.h"
+#include "svgexport.h"
+#include "pngwriter.h"
+#include "pngreader.h"
+#include "tilepyramid.h"
+#include "layoutfeed.h"
+#include "strokefont.h"
+#include "softraster.h"
+
+#define GL_GLEXT_PROTOTYPES // glMultiDrawArrays (GL 1.4)
 #include <GL/glut.h>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
 #endif
@@ -36,37 +84,100 @@ static float RADIUS_STEP        = 35.0f;   // distance per depth
 static bool  LINKS_CURVED       = true;    // press 'C' to toggle
 static int   BEZIER_SAMPLES     = 28;      // segments per edge curve (if LINKS_CURVED)
 
-// Stroke text (rotatable)
-static void* LABEL_STROKE_FONT  = GLUT_STROKE_ROMAN;
+// Stroke text (rotatable), in the built-in Roman stroke font (strokefont.h)
 static float LABEL_STROKE_SCALE = 0.020f; // world scaling; tune for your data
 static float LABEL_RADIAL_PAD   = 3.0f;   // label anchor offset past node tip (world units)
 static bool  LABEL_CONST_SCREEN_SIZE = false; // if true: scale ~ 1/g_zoom
 
+// Label decluttering (screen-space collision grid)
+static bool  LABEL_DECLUTTER    = true;   // press 'D' to toggle
+static float LABEL_MIN_PIXEL_H  = 5.0f;   // labels smaller than this on screen are skipped
+static float LABEL_TRUNC_MIN    = 0.4f;   // truncate only if at least this fraction of chars fits
+
 // Endpoint circles
 static float ENDPOINT_RADIUS    = 0.75f;   // world units
 static int   CIRCLE_SEGS        = 18;
 
+// Refocus (re-rooting)
+static float FOCUS_BACK_WEDGE_DEG = 40.0f; // wedge reserved for the ancestor path
+static float FOCUS_BACK_STEP      = 0.45f; // ancestor spacing, in RADIUS_STEP units
+static int   TRANSITION_MS        = 400;   // layout transition duration
+
+// Level of detail
+static bool  LOD_ENABLED        = true;   // press 'V' to toggle
+static float LOD_PX             = 1.5f;   // subtrees whose outer arc is narrower than this (pixels) are aggregated
+static bool  SEMANTIC_ZOOM      = true;   // press 'Z' to toggle
+static int   SEMANTIC_BASE_DEPTH = 4;     // levels below the focus shown at zoom 1
+static float SEMANTIC_LEVELS_PER_OCTAVE = 1.0f; // extra levels per doubling of the zoom
+
+// Time-sliced layout
+static int   LAYOUT_SLICE_US    = 8000;   // layout work per idle call while a map is first laid out
+
+// Streaming load
+static int   LOAD_BATCH_NODES   = 4096;   // nodes per batch handed from the loader thread
+static int   LOAD_BATCH_MS      = 50;     // ...or fewer, once the batch is this old
+static int   LOAD_RELAYOUT_MS   = 250;    // minimum time between provisional layouts while loading
+static constexpr size_t LOAD_QUEUE_BATCHES = 256; // loader -> main thread ring capacity
+
+// Parallel geometry
+static int   GEOMETRY_THREADS   = 0;      // workers for buffer and label cache rebuilds (0: one per core)
+static int   GEOMETRY_GRAIN     = 8192;   // fewer nodes than this per worker are not worth a thread
+
+// Progressive rendering
+static bool  PROGRESSIVE_RENDER = true;   // press 'G' to toggle
+static float PROGRESSIVE_BUDGET_MS = 12.0f; // drawing time per frame before continuing on the next
+static int   PROGRESSIVE_CHUNK  = 512;    // nodes drawn (or labels placed) between budget checks; labels are drawn one per check
+
+// Hyperbolic (Poincare disk) view
+static bool  HYPERBOLIC_VIEW    = false;  // press 'P' to toggle
+static float HYPER_SCALE        = 2.0f;   // layout distance (RADIUS_STEP units) per unit sinh of hyperbolic distance
+static float HYPER_DISK_FRAC    = 0.95f;  // disk radius as a fraction of BASE_HALF_H
+static float HYPER_CULL_PX      = 1.0f;   // subtrees whose incoming link projects shorter than this are culled
+
+// Screenshots
+static int   SCREENSHOT_LONG_SIDE = 7680;  // pixels along the longer window side (0: window size)
+static int   SCREENSHOT_THREADS   = 0;     // PNG encoder workers (0: one per core)
+static int   SCREENSHOT_BAND_PIXELS = 1 << 20; // drawn and read back at a time (rows of the full width)
+
+// Tile pyramid (radialcli -f tiles)
+static bool  TILE_MODE          = true;   // press 'M' to toggle
+static int   TILE_CACHE_TILES   = 384;    // decoded tiles kept as textures (least recently drawn go first)
+static int   TILE_LOADERS       = 2;      // threads reading and decoding tile files
+static int   TILE_UPLOADS_PER_FRAME = 16; // textures created per frame
+
+// Live feed (layoutfeed.h)
+static bool  LIVE_FEED          = true;   // press 'B' to toggle
+
 // Base view height in world units (used for ortho & pixel->world conversion)
 static float BASE_HALF_H        = 400.0f;
 
-// ---------------------------- Data Model ----------------------------
-
-struct Node {
-    std::string id;
-    std::string text;
-    Node* parent = nullptr;
-    std::vector<std::unique_ptr<Node>> children;
+// Search
+static int   SEARCH_HASH_BITS   = 20;      // trigram buckets = 2^bits (collisions are verified away)
+static int   SEARCH_MAX_MARKS   = 20000;   // highlighted hits per frame
+static float SEARCH_FOCUS_ZOOM  = 4.0f;    // minimum zoom when jumping to a match
 
-    int depth = 0;
-    int leafCount = 0;
+// ---------------------------- Data Model ----------------------------
 
-    float angle = 0.0f;     // radians
-    float radius = 0.0f;    // world units
-    float x = 0.0f, y = 0.0f;
-};
+// Node, loadFreeMind() and the layout passes live in mindmap.h/.cpp.
 
 static int g_autoId = 1;
 static std::unique_ptr<Node> g_root;
+static Node* g_focus = nullptr; // center of the radial layout (g_root unless refocused)
+static const char* g_mapPath = nullptr;
+
+static float g_curveBlend = 1.0f; // link shape: 0 straight .. 1 Bezier (animated by transitions)
+
+// All nodes in preorder, so every subtree is a contiguous index range.
+static std::vector<Node*> g_nodes;
+// Preorder [begin, end) ranges not hidden by a collapsed ancestor.
+static std::vector<std::pair<int, int>> g_visibleRanges;
+static bool g_buffersDirty = true; // render buffers need refilling for g_visibleRanges
+static uint64_t g_geometryVersion = 0; // counts changes of node positions or visibility
+
+static void geometryChanged() {
+    g_buffersDirty = true;
+    ++g_geometryVersion;
+}
 
 // ---------------------------- Window / Camera / Interaction ----------------------------
 
@@ -78,6 +189,12 @@ static float g_panX = 0.0f, g_panY = 0.0f;
 
 static bool  g_dragging = false;
 static int   g_lastMouseX = 0, g_lastMouseY = 0;
+static int   g_pressX = 0, g_pressY = 0;             // left-button press position (click vs drag)
+static int   CLICK_SLOP_PX = 4;
+
+// Picking
+static const Node* g_hoverNode = nullptr;
+static const Node* g_selectedNode = nullptr;
 
 // Fullscreen
 static bool g_fullscreen = false;
@@ -90,11 +207,91 @@ static float g_rotDeg = 0.0f;
 static float g_rotDegPerSec = 15.0f;
 static int   g_lastTimeMs = 0;
 
+// Hyperbolic view focus, in disk coordinates (|c| < 1)
+static float g_hypCx = 0.0f, g_hypCy = 0.0f;
+
+// A camera and the pixel size it is drawn at, or a band of rows [y0, y1)
+// of that (counted from the bottom). The window draws windowViewport(); a
+// screenshot draws a copy of it at its own size, band by band, so drawing a
+// view never depends on the window's size or camera.
+struct Viewport {
+    int w, h;
+    float zoom, panX, panY, rotDeg;
+    bool hyperbolic;
+    float hypCx, hypCy;
+    int y0, y1;
+    bool operator==(const Viewport& o) const {
+        return w == o.w && h == o.h && zoom == o.zoom && panX == o.panX && panY == o.panY &&
+               rotDeg == o.rotDeg && hyperbolic == o.hyperbolic && hypCx == o.hypCx && hypCy == o.hypCy &&
+               y0 == o.y0 && y1 == o.y1;
+    }
+};
+
+static Viewport windowViewport() {
+    return { g_winW, g_winH, g_zoom, g_panX, g_panY, g_rotDeg, HYPERBOLIC_VIEW, g_hypCx, g_hypCy, 0, g_winH };
+}
+
 // ---------------------------- Helpers ----------------------------
 
 static float radiansToDegrees(float r) { return r * (180.0f / float(M_PI)); }
 static float degreesToRadians(float d) { return d * (float(M_PI) / 180.0f); }
 
+// Stable LSD radix sort of 0..keys.size()-1 by 32-bit key (three 11-bit passes).
+static void radixSortIndices(const std::vector<uint32_t>& keys, std::vector<int>& order) {
+    size_t n = keys.size();
+    order.resize(n);
+    for (size_t i = 0; i < n; ++i) order[i] = int(i);
+    std::vector<int> tmp(n);
+
+    for (int shift = 0; shift < 32; shift += 11) {
+        size_t count[2049] = {};
+        for (size_t i = 0; i < n; ++i) ++count[((keys[i] >> shift) & 2047u) + 1];
+        for (int b = 0; b < 2048; ++b) count[b + 1] += count[b];
+        for (size_t i = 0; i < n; ++i) tmp[count[(keys[order[i]] >> shift) & 2047u]++] = order[i];
+        order.swap(tmp);
+    }
+}
+
+// Run fn(begin, end, chunk) over [0, n) split into contiguous chunks, one per
+// worker; the calling thread takes chunk 0. Chunks are disjoint, so workers
+// that only write their own elements need no locking.
+template <typename Fn>
+static void parallelChunks(size_t n, size_t chunks, Fn fn) {
+    if (chunks <= 1) { fn(size_t(0), n, size_t(0)); return; }
+    std::vector<std::thread> pool;
+    for (size_t c = 1; c < chunks; ++c) pool.emplace_back(fn, n * c / chunks, n * (c + 1) / chunks, c);
+    fn(size_t(0), n / chunks, size_t(0));
+    for (auto& t : pool) t.join();
+}
+
+static size_t geometryChunks(size_t n) {
+    size_t threads = (GEOMETRY_THREADS > 0) ? size_t(GEOMETRY_THREADS)
+                                             : std::max(1u, std::thread::hardware_concurrency());
+    return std::max<size_t>(1, std::min(threads, n / size_t(std::max(1, GEOMETRY_GRAIN))));
+}
+
+// fn(slot) for positions [b, e) of the concatenation of the slot ranges.
+template <typename Fn>
+static void forRangeSlots(const std::vector<std::pair<int, int>>& ranges, size_t b, size_t e, Fn fn) {
+    size_t pos = 0;
+    for (const auto& r : ranges) {
+        if (pos >= e) break;
+        size_t len = size_t(r.second - r.first);
+        if (pos + len > b) {
+            int lo = r.first + int(std::max(b, pos) - pos);
+            int hi = r.first + int(std::min(e, pos + len) - pos);
+            for (int i = lo; i < hi; ++i) fn(i);
+        }
+        pos += len;
+    }
+}
+
+static size_t rangeSlotCount(const std::vector<std::pair<int, int>>& ranges) {
+    size_t n = 0;
+    for (const auto& r : ranges) n += size_t(r.second - r.first);
+    return n;
+}
+
 static void drawFilledCircle(float cx, float cy, float r, int segs) {
     glBegin(GL_TRIANGLE_FAN);
     glVertex2f(cx, cy);
@@ -109,11 +306,15 @@ static void drawFilledCircle(float cx, float cy, float r, int segs) {
 
 enum class TextAlign { Start, Center, End };
 
-// Approximate stroke text width in *stroke units* (pre-scale).
-static float strokeTextWidth(void* font, const std::string& s) {
-    float w = 0.0f;
-    for (unsigned char c : s) w += float(glutStrokeWidth(font, c));
-    return w;
+// Label width in stroke units (pre-scale). Table lookups only, so it works
+// before glutInit() and without a window.
+static float labelTextWidth(const std::string& s, size_t count = std::string::npos) {
+    return strokeTextWidth(s, count);
+}
+
+static void cacheLabelWidths(Node* n) {
+    n->textWidth = labelTextWidth(n->text);
+    for (auto& ch : n->children) cacheLabelWidths(ch.get());
 }
 
 // Draw a stroke string at world (x,y), rotated about Z by angleDeg, scaled by "scale".
@@ -121,7 +322,6 @@ static float strokeTextWidth(void* font, const std::string& s) {
 static void drawStrokeStringRotatedAligned(float x, float y,
                                            float angleDeg,
                                            float scale,
-                                           void* font,
                                            const std::string& s,
                                            TextAlign align)
 {
@@ -130,72 +330,375 @@ static void drawStrokeStringRotatedAligned(float x, float y,
     glRotatef(angleDeg, 0.0f, 0.0f, 1.0f);
     glScalef(scale, scale, 1.0f);
 
-    float w = strokeTextWidth(font, s);
+    float w = strokeTextWidth(s);
+    float pen = 0.0f;
     if (align == TextAlign::Center) {
-        glTranslatef(-0.5f * w, 0.0f, 0.0f);
+        pen = -0.5f * w;
     } else if (align == TextAlign::End) {
-        glTranslatef(-w, 0.0f, 0.0f);
-    } // Start => no translate
-
-    for (unsigned char c : s) glutStrokeCharacter(font, c);
+        pen = -w;
+    } // Start => no offset
+
+    for (unsigned char c : s) {
+        forEachStrokeStrip(c, [pen](const float* v, int count) {
+            glBegin(GL_LINE_STRIP);
+            for (int k = 0; k < count; ++k) glVertex2f(pen + v[2*k], v[2*k + 1]);
+            glEnd();
+        });
+        pen += strokeAdvance(c);
+    }
     glPopMatrix();
 }
 
-// ---------------------------- XML Parsing (FreeMind) ----------------------------
+// ---------------------------- Streaming Loader ----------------------------
 
-static std::string getAttr(tinyxml2::XMLElement* el, const char* name) {
-    const char* v = el->Attribute(name);
-    return v ? std::string(v) : std::string();
-}
+// At startup the map is read by a loader thread instead of loadFreeMind(): it
+// scans the file tag by tag (only <node> elements matter, everything else is
+// skipped) and hands the nodes to the main thread in batches through a
+// single-producer/single-consumer ring. A batch is a preorder event list: a
+// node opens an element, nullptr closes the innermost open one. Ownership of
+// every node moves with its batch; the loader never touches it again.
+struct LoadBatch {
+    std::vector<std::unique_ptr<Node>> events;
+};
 
-static std::unique_ptr<Node> parseNode(tinyxml2::XMLElement* xmlNode, Node* parent) {
-    auto n = std::make_unique<Node>();
-    n->parent = parent;
+template <typename T, size_t N>
+struct SpscQueue {
+    T slots[N];
+    std::atomic<size_t> head{0};  // next slot to pop (consumer)
+    std::atomic<size_t> tail{0};  // next slot to push (producer)
+
+    // Leaves v untouched when the ring is full.
+    bool push(T& v) {
+        size_t t = tail.load(std::memory_order_relaxed);
+        size_t next = (t + 1) % N;
+        if (next == head.load(std::memory_order_acquire)) return false;
+        slots[t] = std::move(v);
+        tail.store(next, std::memory_order_release);
+        return true;
+    }
 
-    n->text = getAttr(xmlNode, "TEXT");
-    n->id   = getAttr(xmlNode, "ID");
+    bool pop(T& v) {
+        size_t h = head.load(std::memory_order_relaxed);
+        if (h == tail.load(std::memory_order_acquire)) return false;
+        v = std::move(slots[h]);
+        head.store((h + 1) % N, std::memory_order_release);
+        return true;
+    }
 
-    if (n->id.empty()) n->id = "auto_" + std::to_string(g_autoId++);
-    if (n->text.empty()) n->text = n->id;
+    // Consumer side: nothing left to pop.
+    bool empty() const {
+        return head.load(std::memory_order_relaxed) == tail.load(std::memory_order_acquire);
+    }
+};
 
-    for (tinyxml2::XMLElement* c = xmlNode->FirstChildElement("node"); c; c = c->NextSiblingElement("node")) {
-        auto child = parseNode(c, n.get());
-        n->children.insert(n->children.begin(), std::move(child));
+static SpscQueue<std::unique_ptr<LoadBatch>, LOAD_QUEUE_BATCHES> g_loadQueue;
+static std::thread g_loadThread;
+static std::atomic<bool> g_loadFinished{false};  // loader: every batch is queued
+static std::atomic<bool> g_loadFailed{false};
+static std::atomic<bool> g_loadCancel{false};
+static bool g_loading = false;                   // main thread: the map is still arriving
+static std::vector<Node*> g_loadStack;           // main thread: open elements
+static size_t g_loadedNodes = 0;
+
+struct XmlScanner {
+    FILE* f;
+    std::string buf;
+    size_t pos = 0;
+    bool eof = false;
+
+    bool readMore() {
+        if (eof) return false;
+        buf.erase(0, pos);
+        pos = 0;
+        const size_t chunk = 1 << 20;
+        size_t old = buf.size();
+        buf.resize(old + chunk);
+        size_t got = std::fread(&buf[old], 1, chunk, f);
+        buf.resize(old + got);
+        if (got == 0) eof = true;
+        return got > 0;
+    }
+
+    // Contents of the next tag, between '<' and '>'. Comments, CDATA sections and
+    // processing instructions are returned whole and skipped by the caller.
+    bool nextTag(std::string& tag) {
+        for (;;) {
+            size_t lt = buf.find('<', pos);
+            if (lt == std::string::npos) {
+                pos = buf.size();
+                if (!readMore()) return false;
+                continue;
+            }
+            pos = lt;
+            if (buf.size() - lt < 9 && !eof) { readMore(); continue; }
+
+            const char* term = ">";
+            if (buf.compare(lt, 4, "<!--") == 0)           term = "-->";
+            else if (buf.compare(lt, 9, "<![CDATA[") == 0) term = "]]>";
+
+            size_t end = std::string::npos;
+            if (term[1]) {
+                end = buf.find(term, lt + 1);
+                if (end != std::string::npos) end += std::strlen(term) - 1;
+            } else {
+                char quote = 0; // '>' may appear inside attribute values
+                for (size_t i = lt + 1; i < buf.size(); ++i) {
+                    char c = buf[i];
+                    if (quote) { if (c == quote) quote = 0; }
+                    else if (c == '"' || c == '\'') quote = c;
+                    else if (c == '>') { end = i; break; }
+                }
+            }
+            if (end == std::string::npos) {
+                if (!readMore()) return false;
+                continue;
+            }
+            tag.assign(buf, lt + 1, end - lt - 1);
+            pos = end + 1;
+            return true;
+        }
+    }
+};
+
+static void appendUtf8(std::string& out, unsigned long cp) {
+    if (cp < 0x80) {
+        out += char(cp);
+    } else if (cp < 0x800) {
+        out += char(0xC0 | (cp >> 6));
+        out += char(0x80 | (cp & 0x3F));
+    } else if (cp < 0x10000) {
+        out += char(0xE0 | (cp >> 12));
+        out += char(0x80 | ((cp >> 6) & 0x3F));
+        out += char(0x80 | (cp & 0x3F));
+    } else {
+        out += char(0xF0 | (cp >> 18));
+        out += char(0x80 | ((cp >> 12) & 0x3F));
+        out += char(0x80 | ((cp >> 6) & 0x3F));
+        out += char(0x80 | (cp & 0x3F));
     }
-    return n;
 }
 
-static std::unique_ptr<Node> loadFreeMind(const char* path) {
-    tinyxml2::XMLDocument doc;
-    if (doc.LoadFile(path) != tinyxml2::XML_SUCCESS) {
-        std::fprintf(stderr, "Failed to load %s\n", path);
-        return nullptr;
+// Attribute value as tinyxml2 reports it: entities and character references
+// resolved, CR LF and lone CR turned into LF.
+static std::string decodeXmlAttr(const char* b, const char* e) {
+    static const struct { const char* name; char c; } named[] = {
+        { "amp;", '&' }, { "lt;", '<' }, { "gt;", '>' }, { "quot;", '"' }, { "apos;", '\'' },
+    };
+    std::string out;
+    out.reserve(size_t(e - b));
+    for (const char* p = b; p < e; ++p) {
+        if (*p == '\r') {
+            out += '\n';
+            if (p + 1 < e && p[1] == '\n') ++p;
+            continue;
+        }
+        if (*p != '&') { out += *p; continue; }
+
+        const char* semi = static_cast<const char*>(std::memchr(p, ';', size_t(e - p)));
+        if (semi && p[1] == '#') {
+            bool hex = (p[2] == 'x');
+            unsigned long cp = std::strtoul(p + (hex ? 3 : 2), nullptr, hex ? 16 : 10);
+            appendUtf8(out, cp);
+            p = semi;
+            continue;
+        }
+        bool done = false;
+        for (const auto& en : named) {
+            size_t len = std::strlen(en.name);
+            if (size_t(e - p - 1) >= len && std::strncmp(p + 1, en.name, len) == 0) {
+                out += en.c;
+                p += len;
+                done = true;
+                break;
+            }
+        }
+        if (!done) out += '&';
+    }
+    return out;
+}
+
+// Value of attribute `name` in a start tag's contents ("node A=\"v\" ..."):
+// the tag is read as name = "value" pairs, so text inside another
+// attribute's value is never taken for an attribute.
+static bool findXmlAttr(const std::string& tag, const char* name, std::string& value) {
+    auto space = [&](size_t k) { return std::isspace((unsigned char)tag[k]) != 0; };
+    size_t i = 0, n = tag.size();
+    while (i < n && !space(i) && tag[i] != '/') ++i; // element name
+    while (i < n) {
+        while (i < n && space(i)) ++i;
+        size_t nameBegin = i;
+        while (i < n && !space(i) && tag[i] != '=' && tag[i] != '/') ++i;
+        size_t nameEnd = i;
+        while (i < n && space(i)) ++i;
+        if (i >= n || tag[i] != '=') {
+            if (i < n && nameEnd == nameBegin) ++i; // stray '/'
+            continue;
+        }
+        ++i;
+        while (i < n && space(i)) ++i;
+        if (i >= n || (tag[i] != '"' && tag[i] != '\'')) return false;
+        size_t close = tag.find(tag[i], i + 1);
+        if (close == std::string::npos) return false;
+        if (tag.compare(nameBegin, nameEnd - nameBegin, name) == 0) {
+            value = decodeXmlAttr(tag.data() + i + 1, tag.data() + close);
+            return true;
+        }
+        i = close + 1;
     }
+    return false;
+}
+
+static std::string xmlTagName(const std::string& tag, size_t from) {
+    size_t e = from;
+    while (e < tag.size() && !std::isspace((unsigned char)tag[e]) && tag[e] != '/') ++e;
+    return tag.substr(from, e - from);
+}
+
+// Loader thread: the first <node> inside <map>, streamed. Same node fields as
+// parseNode(), including generated IDs (g_autoId is the loader's until it finishes).
+static void loaderMain(FILE* f) {
+    XmlScanner S{ f };
+    auto batch = std::make_unique<LoadBatch>();
+    auto batchStart = std::chrono::steady_clock::now();
+
+    auto flush = [&]() {
+        if (batch->events.empty()) return;
+        while (!g_loadQueue.push(batch)) {
+            if (g_loadCancel.load(std::memory_order_relaxed)) return;
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        batch = std::make_unique<LoadBatch>();
+        batchStart = std::chrono::steady_clock::now();
+    };
+    auto batchDue = [&]() {
+        if (int(batch->events.size()) >= LOAD_BATCH_NODES) return true;
+        if (batch->events.size() % 256 != 0) return false;
+        return std::chrono::steady_clock::now() - batchStart >= std::chrono::milliseconds(LOAD_BATCH_MS);
+    };
+
+    std::string tag;
+    bool inMap = false, sawRoot = false;
+    int depth = 0;
+    while (!g_loadCancel.load(std::memory_order_relaxed) && S.nextTag(tag)) {
+        if (tag.empty() || tag[0] == '!' || tag[0] == '?') continue;
+
+        bool closing = (tag[0] == '/');
+        std::string name = xmlTagName(tag, closing ? 1 : 0);
+        if (name == "map") {
+            if (closing) break;
+            inMap = true;
+            continue;
+        }
+        if (name != "node" || !inMap) continue;
 
-    auto* mapEl = doc.FirstChildElement("map");
-    if (!mapEl) { std::fprintf(stderr, "No <map> element.\n"); return nullptr; }
+        if (closing) {
+            if (depth == 0) continue;
+            batch->events.push_back(nullptr);
+            if (--depth == 0) break; // root closed
+        } else {
+            if (depth == 0 && sawRoot) break;
+            sawRoot = true;
+
+            auto n = std::make_unique<Node>();
+            findXmlAttr(tag, "TEXT", n->text);
+            findXmlAttr(tag, "ID", n->id);
+            if (n->id.empty()) n->id = "auto_" + std::to_string(g_autoId++);
+            if (n->text.empty()) n->text = n->id;
+            batch->events.push_back(std::move(n));
+
+            if (tag.back() == '/') batch->events.push_back(nullptr);
+            else ++depth;
+            if (tag.back() == '/' && depth == 0) break;
+        }
+        if (batchDue()) flush();
+    }
+    flush();
+    std::fclose(f);
 
-    auto* rootEl = mapEl->FirstChildElement("node");
-    if (!rootEl) { std::fprintf(stderr, "No root <node> element.\n"); return nullptr; }
+    if (!sawRoot || depth != 0) {
+        std::fprintf(stderr, sawRoot ? "Unexpected end of map file.\n" : "No <map>/<node> element.\n");
+        g_loadFailed.store(true, std::memory_order_relaxed);
+    }
+    g_loadFinished.store(true, std::memory_order_release);
+}
 
-    return parseNode(rootEl, nullptr);
+static void stopLoader() {
+    g_loadCancel.store(true);
+    if (g_loadThread.joinable()) g_loadThread.join();
 }
 
-// ---------------------------- Layout ----------------------------
+static bool startLoader(const char* path) {
+    FILE* f = std::fopen(path, "rb");
+    if (!f) {
+        std::fprintf(stderr, "Failed to load %s\n", path);
+        return false;
+    }
+    g_loading = true;
+    g_loadThread = std::thread(loaderMain, f);
+    std::atexit(stopLoader); // before g_loadThread is destroyed
+    return true;
+}
+
+// Attach queued nodes for about budgetUs. Each new node is inserted at the front
+// of its parent's children, as parseNode() does. Returns the nodes attached.
+static size_t drainLoadQueue(int budgetUs) {
+    auto t0 = std::chrono::steady_clock::now();
+    size_t added = 0;
+    std::unique_ptr<LoadBatch> batch;
+    while (g_loadQueue.pop(batch)) {
+        for (auto& ev : batch->events) {
+            if (!ev) {
+                g_loadStack.pop_back();
+                continue;
+            }
+            Node* n = ev.get();
+            n->textWidth = labelTextWidth(n->text);
+            if (g_loadStack.empty()) {
+                g_root = std::move(ev);
+            } else {
+                n->parent = g_loadStack.back();
+                n->parent->children.insert(n->parent->children.begin(), std::move(ev));
+            }
+            g_loadStack.push_back(n);
+            ++added;
+        }
+        if (std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - t0).count()
+            >= budgetUs)
+            break;
+    }
+    g_loadedNodes += added;
+    return added;
+}
 
-static int computeDepthAndLeaves(Node* n, int depth) {
-    n->depth = depth;
-    if (n->children.empty()) { n->leafCount = 1; return 1; }
+// ---------------------------- Layout ----------------------------
 
-    int sum = 0;
-    for (auto& ch : n->children) sum += computeDepthAndLeaves(ch.get(), depth + 1);
-    n->leafCount = std::max(1, sum);
-    return n->leafCount;
+// Ancestors of the focus (single-node ranges, on the back wedge) followed by
+// the focus subtree minus collapsed subtrees.
+static void computeVisibleRanges() {
+    g_visibleRanges.clear();
+    std::vector<int> path;
+    for (const Node* a = g_focus->parent; a; a = a->parent) path.push_back(a->index);
+    for (auto it = path.rbegin(); it != path.rend(); ++it) g_visibleRanges.push_back({ *it, *it + 1 });
+
+    int count = g_focus->subtreeEnd;
+    int start = g_focus->index, i = start;
+    while (i < count) {
+        const Node* n = g_nodes[i];
+        if (n->collapsed && n->subtreeEnd > i + 1) {
+            g_visibleRanges.push_back({ start, i + 1 });
+            i = start = n->subtreeEnd;
+        } else {
+            ++i;
+        }
+    }
+    if (start < count) g_visibleRanges.push_back({ start, count });
 }
 
 static void assignAngles(Node* n, float a0, float a1) {
     n->angle = 0.5f * (a0 + a1);
-    if (n->children.empty()) return;
+    n->angle0 = a0;
+    n->angle1 = a1;
+    if (n->children.empty() || n->collapsed) return;
 
     float span = (a1 - a0);
     float cur = a0;
@@ -213,16 +716,337 @@ static void assignAngles(Node* n, float a0, float a1) {
 }
 
 static void assignRadiiAndPositions(Node* n, float radiusStep) {
-    n->radius = n->depth * radiusStep;
+    n->radius = (n->depth - g_focus->depth) * radiusStep;
     n->x = std::cos(n->angle) * n->radius;
     n->y = std::sin(n->angle) * n->radius;
+    if (n->collapsed) return;
     for (auto& ch : n->children) assignRadiiAndPositions(ch.get(), radiusStep);
 }
 
+// ---------------------------- Label Cache ----------------------------
+
+// Label anchors and directions, computed once per layout and sorted by angle.
+// Only the left/right flip depends on g_rotDeg; it is updated incrementally
+// for the labels whose screen angle crosses the vertical axis.
+struct LabelEntry {
+    const Node* node;
+    float angle;     // node->angle in [0, 2pi)
+    float x, y;      // anchor, world units (before view rotation)
+    float baseDeg;   // text angle (relative to the modelview) when not flipped
+    bool leaf;
+    bool flipped;    // left half of the screen: rotate 180 and end-align
+};
+
+static std::vector<LabelEntry> g_labelCache;  // non-root labels, sorted by angle
+static std::vector<int> g_labelOrder;         // declutter priority: shallow depth, large leafCount first
+static float g_labelFlipRotDeg = 0.0f;        // rotation the flip states correspond to
+static size_t g_labelFlipsLastStep = 0;       // entries re-evaluated by the last syncLabelFlips()
+static bool g_labelCacheMoved = false;        // entries moved off their sorted angles (mid-transition)
+
+static bool labelFlippedAt(float angle, float rotDeg) {
+    return std::cos(angle + degreesToRadians(rotDeg)) < 0.0f;
+}
+
+// Rebuilt on every layout change (including folds), so both orderings use
+// radix sorts rather than comparison sorts. The entries are made in parallel:
+// each chunk of the visible slots counts its labels, a prefix sum over the
+// counts gives every chunk its own output offset.
+static void buildLabelCache() {
+    size_t total = rangeSlotCount(g_visibleRanges);
+    size_t chunks = geometryChunks(total);
+    std::vector<size_t> offset(chunks + 1, 0);
+    parallelChunks(total, chunks, [&](size_t b, size_t e, size_t c) {
+        size_t count = 0;
+        forRangeSlots(g_visibleRanges, b, e, [&](int i) { count += (g_nodes[i] != g_focus); });
+        offset[c + 1] = count;
+    });
+    for (size_t c = 0; c < chunks; ++c) offset[c + 1] += offset[c];
+
+    std::vector<LabelEntry> entries(offset[chunks]);
+    std::vector<uint32_t> keys(offset[chunks]);
+    parallelChunks(total, chunks, [&](size_t b, size_t end, size_t c) {
+        size_t out = offset[c];
+        forRangeSlots(g_visibleRanges, b, end, [&](int i) {
+            const Node* n = g_nodes[i];
+            if (n == g_focus) return; // drawn by placeRootLabel()
+            LabelEntry e;
+            e.node = n;
+            e.angle = std::fmod(n->angle, 2.0f * float(M_PI));
+            if (e.angle < 0.0f) e.angle += 2.0f * float(M_PI);
+
+            // Non-root nodes have radius > 0: the radial direction is position / radius.
+            float k = 1.0f + LABEL_RADIAL_PAD / n->radius;
+            e.x = n->x * k;
+            e.y = n->y * k;
+            e.baseDeg = radiansToDegrees(n->angle);
+            e.leaf = n->children.empty();
+            e.flipped = labelFlippedAt(e.angle, g_rotDeg);
+            entries[out] = e;
+
+            uint32_t bits;  // non-negative floats order like their bit patterns
+            std::memcpy(&bits, &e.angle, sizeof(bits));
+            keys[out++] = bits;
+        });
+    });
+    g_labelFlipRotDeg = g_rotDeg;
+    g_labelCacheMoved = false;
+
+    std::vector<int> order;
+    radixSortIndices(keys, order);
+    g_labelCache.resize(entries.size());
+
+    // Gather, then priority keys: depth ascending, then leafCount descending.
+    size_t n = entries.size();
+    parallelChunks(n, geometryChunks(n), [&](size_t b, size_t e, size_t) {
+        for (size_t i = b; i < e; ++i) {
+            g_labelCache[i] = entries[order[i]];
+            const Node* nd = g_labelCache[i].node;
+            uint32_t leaves = uint32_t(std::min(nd->leafCount, 0xFFFFF));
+            keys[i] = (uint32_t(std::min(nd->depth, 0xFFF)) << 20) | (0xFFFFFu - leaves);
+        }
+    });
+    radixSortIndices(keys, g_labelOrder);
+}
+
+// Re-evaluate flip state for labels with angle in [a0, a1] (mod 2pi).
+static void refreshLabelFlips(float a0, float a1, float rotDeg) {
+    const float twoPi = 2.0f * float(M_PI);
+    auto less = [](const LabelEntry& e, float a) { return e.angle < a; };
+    auto refresh = [&](size_t i0, size_t i1) {
+        for (size_t i = i0; i < i1; ++i)
+            g_labelCache[i].flipped = labelFlippedAt(g_labelCache[i].angle, rotDeg);
+        g_labelFlipsLastStep += i1 - i0;
+    };
+
+    float len = a1 - a0;
+    if (len >= twoPi) { refresh(0, g_labelCache.size()); return; }
+
+    a0 = std::fmod(a0, twoPi);
+    if (a0 < 0.0f) a0 += twoPi;
+    float end = a0 + len;
+
+    auto first = std::lower_bound(g_labelCache.begin(), g_labelCache.end(), a0, less);
+    if (end <= twoPi) {
+        auto last = std::lower_bound(first, g_labelCache.end(), end, less);
+        refresh(size_t(first - g_labelCache.begin()), size_t(last - g_labelCache.begin()));
+    } else {
+        auto last = std::lower_bound(g_labelCache.begin(), g_labelCache.end(), end - twoPi, less);
+        refresh(size_t(first - g_labelCache.begin()), g_labelCache.size());
+        refresh(0, size_t(last - g_labelCache.begin()));
+    }
+}
+
+// Bring flip states from g_labelFlipRotDeg to g_rotDeg. A label flips when its
+// screen angle crosses 90 or 270 degrees, so only the angular arcs swept by those
+// two boundaries need to be revisited.
+static void syncLabelFlips() {
+    g_labelFlipsLastStep = 0;
+
+    float d = g_rotDeg - g_labelFlipRotDeg;
+    d = std::fmod(d, 360.0f);
+    if (d > 180.0f)   d -= 360.0f;
+    if (d <= -180.0f) d += 360.0f;
+    if (d == 0.0f) return;
+
+    if (std::fabs(d) >= 90.0f || g_labelCacheMoved) {
+        refreshLabelFlips(0.0f, 2.0f * float(M_PI), g_rotDeg);
+    } else {
+        const float pad = 1e-3f; // re-evaluating extra labels is harmless; missing one is not
+        float r0 = degreesToRadians(g_labelFlipRotDeg);
+        float r1 = r0 + degreesToRadians(d);
+        const float bounds[2] = { 0.5f * float(M_PI), 1.5f * float(M_PI) };
+        for (float B : bounds) {
+            float lo = std::min(B - r0, B - r1) - pad;
+            float hi = std::max(B - r0, B - r1) + pad;
+            refreshLabelFlips(lo, hi, g_rotDeg);
+        }
+    }
+    g_labelFlipRotDeg = g_rotDeg;
+}
+
+// Lay out the focus subtree around the origin. With a focus below the root,
+// a wedge centered on the -x axis is reserved and the ancestors are placed
+// along it, nearest first. Cost is O(visible focus subtree + depth).
+static void layoutFocus() {
+    Node* F = g_focus;
+    float back = F->parent ? degreesToRadians(FOCUS_BACK_WEDGE_DEG) : 0.0f;
+    float a0 = F->parent ? float(M_PI) + 0.5f * back : 0.0f;
+    assignAngles(F, a0, a0 + 2.0f * float(M_PI) - back);
+    assignRadiiAndPositions(F, RADIUS_STEP);
+
+    int k = 1;
+    for (Node* a = F->parent; a; a = a->parent, ++k) {
+        a->angle = float(M_PI);
+        a->radius = float(k) * FOCUS_BACK_STEP * RADIUS_STEP;
+        a->x = -a->radius;
+        a->y = 0.0f;
+    }
+}
+
+// The initial layout of g_root as an explicit state machine, so that a large
+// map can be laid out in slices from idle() while frames keep being drawn.
+// Each pass is a loop over the preorder array with a resumable cursor:
+//   INDEX:  preorder numbering and depth (explicit DFS stack)
+//   LEAVES: subtreeEnd, height and leafCount, children before parents (reverse preorder)
+//   PLACE:  wedges, radii and positions, parents before children (preorder)
+//   FINISH: visible ranges and the label cache (one step, in a slice of its own)
+// While the map is still streaming in, provisional passes skip FINISH; each
+// one starts over on the larger tree with the leaf counts known so far.
+// While PLACE runs, g_visibleRanges covers the nodes placed so far; the subtrees
+// still waiting already own their wedges and are drawn as placeholders.
+enum LayoutStage { LAYOUT_INDEX, LAYOUT_LEAVES, LAYOUT_PLACE, LAYOUT_FINISH, LAYOUT_DONE };
+
+struct LayoutJob {
+    LayoutStage stage = LAYOUT_DONE;
+    std::vector<Node*> stack;  // INDEX: DFS stack
+    size_t cursor = 0;         // LEAVES: slots left to visit; PLACE: next slot
+    bool final = true;         // false: provisional pass while loading, no FINISH
+    int pass = 0;              // bumped by beginLayout()
+};
+
+static LayoutJob g_layoutJob;
+static int g_layoutEdits = 0; // relayouts (folds, refocus, ring spacing) since the last full layout
+
+static bool layoutPending() {
+    return g_layoutJob.stage != LAYOUT_DONE;
+}
+
+static void beginLayout(bool final = true) {
+    g_nodes.clear();
+    g_visibleRanges.clear();
+    g_focus = nullptr;
+    g_layoutJob.stage = LAYOUT_INDEX;
+    g_layoutJob.stack.assign(1, g_root.get());
+    g_layoutJob.cursor = 0;
+    g_layoutJob.final = final;
+    ++g_layoutJob.pass;
+    g_layoutEdits = 0;
+}
+
+// Place node i and extend the visible ranges over it. Returns the next slot:
+// collapsed subtrees are skipped.
+static size_t layoutPlaceStep(size_t i) {
+    Node* n = g_nodes[i];
+    bool open = layoutPlaceNode(n, RADIUS_STEP);
+
+    if (!g_visibleRanges.empty() && g_visibleRanges.back().second == int(i)) g_visibleRanges.back().second++;
+    else g_visibleRanges.push_back({ int(i), int(i) + 1 });
+
+    return open ? i + 1 : size_t(n->subtreeEnd);
+}
+
+// Run the layout for about budgetUs microseconds (< 0: to completion).
+// Returns true once the layout is complete.
+static bool stepLayout(int budgetUs) {
+    auto t0 = std::chrono::steady_clock::now();
+    auto spent = [&]() {
+        return budgetUs >= 0 &&
+               std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - t0).count()
+               >= budgetUs;
+    };
+    LayoutJob& J = g_layoutJob;
+    const int batch = 4096; // nodes between clock reads
+
+    while (J.stage != LAYOUT_DONE) {
+        if (spent()) return false;
+        switch (J.stage) {
+        case LAYOUT_INDEX:
+            for (int k = 0; k < batch && !J.stack.empty(); ++k) {
+                Node* n = J.stack.back();
+                J.stack.pop_back();
+                layoutIndexNode(n, g_nodes, J.stack);
+            }
+            if (J.stack.empty()) { J.stage = LAYOUT_LEAVES; J.cursor = g_nodes.size(); }
+            break;
+        case LAYOUT_LEAVES:
+            for (int k = 0; k < batch && J.cursor > 0; ++k) layoutCountLeaves(g_nodes[--J.cursor]);
+            if (J.cursor == 0) { J.stage = LAYOUT_PLACE; g_focus = g_root.get(); }
+            break;
+        case LAYOUT_PLACE:
+            for (int k = 0; k < batch && J.cursor < g_nodes.size(); ++k) J.cursor = layoutPlaceStep(J.cursor);
+            if (J.cursor >= g_nodes.size()) J.stage = J.final ? LAYOUT_FINISH : LAYOUT_DONE;
+            break;
+        case LAYOUT_FINISH:
+            computeVisibleRanges();
+            buildLabelCache();
+            geometryChanged();
+            J.stage = LAYOUT_DONE;
+            break;
+        case LAYOUT_DONE:
+            break;
+        }
+    }
+    return true;
+}
+
 static void computeLayout() {
-    computeDepthAndLeaves(g_root.get(), 0);
-    assignAngles(g_root.get(), 0.0f, 2.0f * float(M_PI));
-    assignRadiiAndPositions(g_root.get(), RADIUS_STEP);
+    beginLayout();
+    stepLayout(-1);
+}
+
+// Fold/unfold without a full relayout. Only leafCount on the ancestor chain
+// changes (O(depth)); angles and positions are then reassigned for the visible
+// nodes only, since collapsed subtrees are skipped and keep their stale data.
+static void setCollapsed(Node* n, bool collapsed) {
+    if (n->children.empty() || n->collapsed == collapsed) return;
+    n->collapsed = collapsed;
+
+    int leaves = 1;
+    if (!collapsed) {
+        leaves = 0;
+        for (auto& ch : n->children) leaves += ch->leafCount;
+        leaves = std::max(1, leaves);
+    }
+    int delta = leaves - n->leafCount;
+    for (Node* a = n; a; a = a->parent) a->leafCount += delta;
+}
+
+// The label cache is left to the caller: a transition builds it over the
+// old and new visible nodes together (startTransition()).
+static void relayoutVisible() {
+    ++g_layoutEdits;
+    layoutFocus();
+    computeVisibleRanges();
+    geometryChanged();
+}
+
+static bool inFocusSubtree(const Node* n) {
+    return n->index >= g_focus->index && n->index < g_focus->subtreeEnd;
+}
+
+// Not drawn: outside the focus subtree (and not on its ancestor path), or
+// below a collapsed node.
+static bool nodeHidden(const Node* n) {
+    if (!inFocusSubtree(n)) return !(g_focus->index > n->index && g_focus->index < n->subtreeEnd);
+    for (const Node* a = n->parent; a && inFocusSubtree(a); a = a->parent)
+        if (a->collapsed) return true;
+    return false;
+}
+
+// Mid-transition, nodes keep their target layout and are drawn where the
+// transition kernel (lerpPolarKernel()) puts them: g_lerp* by g_nodes index.
+static bool g_transitionActive = false;
+static std::vector<float> g_lerpAngle, g_lerpRadius, g_lerpX, g_lerpY;
+
+// Where a node is drawn, as policies for the slot fill: its layout position,
+// or its interpolated one while a transition runs.
+struct NodePose {
+    static float x(const Node* n)      { return n->x; }
+    static float y(const Node* n)      { return n->y; }
+    static float angle(const Node* n)  { return n->angle; }
+    static float radius(const Node* n) { return n->radius; }
+};
+
+struct LerpPose {
+    static float x(const Node* n)      { return g_lerpX[n->index]; }
+    static float y(const Node* n)      { return g_lerpY[n->index]; }
+    static float angle(const Node* n)  { return g_lerpAngle[n->index]; }
+    static float radius(const Node* n) { return g_lerpRadius[n->index]; }
+};
+
+static void drawnPosition(const Node* n, float& x, float& y) {
+    x = g_transitionActive ? LerpPose::x(n) : n->x;
+    y = g_transitionActive ? LerpPose::y(n) : n->y;
 }
 
 // ---------------------------- Link Drawing ----------------------------
@@ -243,180 +1067,2630 @@ static void bezier3(float p0x, float p0y,
     outy = b0*p0y + b1*p1y + b2*p2y + b3*p3y;
 }
 
-static void polar(float r, float a, float& x, float& y) {
-    x = std::cos(a) * r;
-    y = std::sin(a) * r;
+// Writes BEZIER_SAMPLES + 1 xy pairs.
+template <typename Pose>
+static void bezierLinkVertices(const Node* parent, const Node* child, float* out) {
+    float p0x = Pose::x(parent), p0y = Pose::y(parent);
+    float p3x = Pose::x(child),  p3y = Pose::y(child);
+
+    float p1x, p1y, p2x, p2y;
+    linkControlPoints(Pose::angle(parent), Pose::radius(parent), Pose::angle(child), Pose::radius(child),
+                      RADIUS_STEP, p1x, p1y, p2x, p2y);
+
+    // Mid-transition between link styles: blend towards the straight line's control points.
+    if (g_curveBlend < 1.0f) {
+        float b = g_curveBlend;
+        p1x = b * p1x + (1.0f - b) * (p0x + (p3x - p0x) / 3.0f);
+        p1y = b * p1y + (1.0f - b) * (p0y + (p3y - p0y) / 3.0f);
+        p2x = b * p2x + (1.0f - b) * (p0x + 2.0f * (p3x - p0x) / 3.0f);
+        p2y = b * p2y + (1.0f - b) * (p0y + 2.0f * (p3y - p0y) / 3.0f);
+    }
+
+    for (int i = 0; i <= BEZIER_SAMPLES; ++i) {
+        float t = float(i) / float(BEZIER_SAMPLES);
+        bezier3(p0x, p0y, p1x, p1y, p2x, p2y, p3x, p3y, t, out[2*i], out[2*i + 1]);
+    }
 }
 
-static void drawLinkStraight(const Node* parent, const Node* child) {
-    glBegin(GL_LINES);
-    glVertex2f(parent->x, parent->y);
-    glVertex2f(child->x,  child->y);
-    glEnd();
+// ---------------------------- Render Buffers ----------------------------
+
+// Retained client-side vertex arrays with one fixed-size slot per node in
+// preorder: the link from the node's parent (line strip) and the node's endpoint
+// circle (triangle fan). A subtree is a contiguous slot range, so collapsed
+// subtrees are skipped when filling and drawing, and each visible range is a
+// single glMultiDrawArrays call.
+static std::vector<float>   g_edgeVerts, g_circleVerts;  // xy pairs
+static std::vector<GLint>   g_edgeFirst, g_circleFirst;  // per node slot start (vertices)
+static std::vector<GLsizei> g_edgeCount, g_circleCount;  // per node slot size (vertices)
+static int g_edgeStride = 0, g_circleStride = 0;
+static std::vector<float>   g_circleUnit;                // CIRCLE_SEGS + 1 unit ring points
+static std::vector<float>   g_nodeXY;                    // node positions, xy per g_nodes index
+
+// How a slot's link is generated. Root and Path occur only on the focus path
+// (a handful of slots); every other slot is Curved or Line depending on the
+// link style, which is fixed for a whole rebuild.
+enum class LinkKind { Root, Path, Curved, Line };
+
+// Vertices per link for the current link style.
+static int linkStride() {
+    return (g_curveBlend > 0.0f) ? BEZIER_SAMPLES + 1 : 2;
 }
 
-static void drawLinkBezier(const Node* parent, const Node* child) {
-    float p0x = parent->x, p0y = parent->y;
-    float p3x = child->x,  p3y = child->y;
+// The link into n: stride xy pairs (linkStride() for the current link style).
+template <LinkKind K, typename Pose = NodePose>
+static void writeLinkVertices(const Node* n, float* e, int stride) {
+    float x = Pose::x(n), y = Pose::y(n);
+    if constexpr (K == LinkKind::Root) {
+        for (int k = 0; k < stride; ++k) { e[2*k] = x; e[2*k + 1] = y; }
+    } else if constexpr (K == LinkKind::Path) {
+        // Ancestor path on the back wedge: collinear, so straight.
+        float px = Pose::x(n->parent), py = Pose::y(n->parent);
+        for (int k = 0; k < stride; ++k) {
+            float t = float(k) / float(stride - 1);
+            e[2*k]     = px + (x - px) * t;
+            e[2*k + 1] = py + (y - py) * t;
+        }
+    } else if constexpr (K == LinkKind::Curved) {
+        bezierLinkVertices<Pose>(n->parent, n, e);
+    } else {
+        e[0] = Pose::x(n->parent); e[1] = Pose::y(n->parent);
+        e[2] = x;                  e[3] = y;
+    }
+}
 
-    float mid1r = parent->radius + 0.55f * RADIUS_STEP;
-    float mid2r = child->radius  - 0.55f * RADIUS_STEP;
+template <LinkKind K, typename Pose = NodePose>
+static void writeSlotGeometry(int i) {
+    const Node* n = g_nodes[i];
+    float x = Pose::x(n), y = Pose::y(n);
+    g_nodeXY[2*i]     = x;
+    g_nodeXY[2*i + 1] = y;
+
+    writeLinkVertices<K, Pose>(n, &g_edgeVerts[size_t(i) * size_t(g_edgeStride) * 2], g_edgeStride);
+
+    float* c = &g_circleVerts[size_t(i) * size_t(g_circleStride) * 2];
+    float r = ENDPOINT_RADIUS;
+    c[0] = x;
+    c[1] = y;
+    for (int k = 0; k <= CIRCLE_SEGS; ++k) {
+        c[2*k + 2] = x + g_circleUnit[2*k]     * r;
+        c[2*k + 3] = y + g_circleUnit[2*k + 1] * r;
+    }
+}
 
-    float p1x, p1y, p2x, p2y;
-    polar(mid1r, parent->angle, p1x, p1y);
-    polar(mid2r, child->angle,  p2x, p2y);
+static LinkKind linkKindOf(const Node* n) {
+    if (!n->parent) return LinkKind::Root;
+    if (n->depth <= g_focus->depth) return LinkKind::Path;
+    return (g_curveBlend > 0.0f) ? LinkKind::Curved : LinkKind::Line;
+}
 
-    glBegin(GL_LINE_STRIP);
-    for (int i = 0; i <= BEZIER_SAMPLES; ++i) {
-        float t = float(i) / float(BEZIER_SAMPLES);
-        float x, y;
-        bezier3(p0x, p0y, p1x, p1y, p2x, p2y, p3x, p3y, t, x, y);
-        glVertex2f(x, y);
+// Any single slot, dispatched per node. Bulk rebuilds use fillSlots<K, Pose>() instead.
+template <typename Pose = NodePose>
+static void writeNodeGeometry(int i) {
+    switch (linkKindOf(g_nodes[i])) {
+    case LinkKind::Root:   writeSlotGeometry<LinkKind::Root, Pose>(i);   break;
+    case LinkKind::Path:   writeSlotGeometry<LinkKind::Path, Pose>(i);   break;
+    case LinkKind::Curved: writeSlotGeometry<LinkKind::Curved, Pose>(i); break;
+    case LinkKind::Line:   writeSlotGeometry<LinkKind::Line, Pose>(i);   break;
     }
-    glEnd();
 }
 
-static void drawEdgesRecursive(const Node* n) {
-    for (const auto& ch : n->children) {
-        glColor4f(0.45f, 0.45f, 0.45f, 0.55f);
-        glLineWidth(1.0f);
-
-        if (LINKS_CURVED) drawLinkBezier(n, ch.get());
-        else              drawLinkStraight(n, ch.get());
+template <typename Pose>
+static void writeNodeLinkAs(const Node* n, float* e, int stride) {
+    switch (linkKindOf(n)) {
+    case LinkKind::Root:   writeLinkVertices<LinkKind::Root, Pose>(n, e, stride);   break;
+    case LinkKind::Path:   writeLinkVertices<LinkKind::Path, Pose>(n, e, stride);   break;
+    case LinkKind::Curved: writeLinkVertices<LinkKind::Curved, Pose>(n, e, stride); break;
+    case LinkKind::Line:   writeLinkVertices<LinkKind::Line, Pose>(n, e, stride);   break;
+    }
+}
 
-        glColor4f(0.30f, 0.30f, 0.30f, 0.95f);
-        float r = ENDPOINT_RADIUS;
-        drawFilledCircle(n->x,  n->y,  r, CIRCLE_SEGS);
-        drawFilledCircle(ch->x, ch->y, r, CIRCLE_SEGS);
+// The link into n exactly as its slot has it, dispatched per node.
+static void writeNodeLink(const Node* n, float* e, int stride) {
+    if (g_transitionActive) writeNodeLinkAs<LerpPose>(n, e, stride);
+    else                    writeNodeLinkAs<NodePose>(n, e, stride);
+}
 
-        drawEdgesRecursive(ch.get());
+// Size the slot arrays for g_nodes and the current link style.
+static void allocRenderBuffers() {
+    int edgeStride = linkStride();
+    int circleStride = CIRCLE_SEGS + 2;
+    size_t count = g_nodes.size();
+    g_nodeXY.resize(2 * count);
+
+    // A new stride discards the slots; a new node count keeps the common prefix
+    // (the map grows while it streams in).
+    if (edgeStride != g_edgeStride) {
+        g_edgeStride = edgeStride;
+        g_edgeFirst.clear();
+        g_edgeVerts.clear();
+    }
+    if (g_edgeFirst.size() != count) {
+        size_t old = std::min(g_edgeFirst.size(), count);
+        g_edgeVerts.resize(count * size_t(edgeStride) * 2, 0.0f);
+        g_edgeFirst.resize(count);
+        g_edgeCount.assign(count, edgeStride);
+        for (size_t i = old; i < count; ++i) g_edgeFirst[i] = GLint(i * size_t(edgeStride));
+    }
+    if (circleStride != g_circleStride) {
+        g_circleStride = circleStride;
+        g_circleFirst.clear();
+        g_circleVerts.clear();
+    }
+    if (g_circleFirst.size() != count) {
+        size_t old = std::min(g_circleFirst.size(), count);
+        g_circleVerts.resize(count * size_t(circleStride) * 2, 0.0f);
+        g_circleFirst.resize(count);
+        g_circleCount.assign(count, circleStride);
+        for (size_t i = old; i < count; ++i) g_circleFirst[i] = GLint(i * size_t(circleStride));
+
+        g_circleUnit.resize(2 * (CIRCLE_SEGS + 1));
+        for (int k = 0; k <= CIRCLE_SEGS; ++k) {
+            float a = (2.0f * float(M_PI)) * (float(k) / float(CIRCLE_SEGS));
+            g_circleUnit[2*k]     = std::cos(a);
+            g_circleUnit[2*k + 1] = std::sin(a);
+        }
     }
 }
 
-// ---------------------------- Label Drawing ----------------------------
+// (Re)fill the slots of all visible nodes; collapsed subtrees keep stale slots
+// until they are unfolded. Slots have a fixed size per node, so a worker's
+// output offsets follow from its slot numbers and the workers fill disjoint
+// parts of the shared arrays directly; GL reads them in one go when drawing.
+static std::vector<std::pair<int, int>> g_fillRanges;  // visible slots below the focus
+
+template <LinkKind K, typename Pose = NodePose>
+static void fillSlots(const std::vector<std::pair<int, int>>& ranges) {
+    size_t n = rangeSlotCount(ranges);
+    parallelChunks(n, geometryChunks(n), [&](size_t b, size_t e, size_t) {
+        forRangeSlots(ranges, b, e, [](int i) { writeSlotGeometry<K, Pose>(i); });
+    });
+}
 
-static void drawLabelsRecursive(const Node* n) {
-    glColor4f(0.10f, 0.10f, 0.10f, 1.0f);
+// The focus and its ancestors come first in their ranges; the rest is
+// uniform, so the link style is dispatched once for all of it.
+template <typename Pose>
+static void fillVisibleSlots() {
+    g_fillRanges.clear();
+    for (const auto& r : g_visibleRanges) {
+        int b = r.first;
+        for (; b < r.second && g_nodes[b]->depth <= g_focus->depth; ++b) writeNodeGeometry<Pose>(b);
+        if (b < r.second) g_fillRanges.push_back({ b, r.second });
+    }
+    if (g_curveBlend > 0.0f) fillSlots<LinkKind::Curved, Pose>(g_fillRanges);
+    else                     fillSlots<LinkKind::Line, Pose>(g_fillRanges);
+}
 
-    float scale = LABEL_CONST_SCREEN_SIZE ? (LABEL_STROKE_SCALE / g_zoom) : LABEL_STROKE_SCALE;
-    float rotRad = degreesToRadians(g_rotDeg);
+// Mid-transition the slots are filled straight from the kernel output, so a
+// frame of a transition costs the kernel plus this fill.
+static void fillRenderBuffers() {
+    allocRenderBuffers();
+    if (g_transitionActive) fillVisibleSlots<LerpPose>();
+    else                    fillVisibleSlots<NodePose>();
+    g_buffersDirty = false;
+}
 
-    if (n == g_root.get()) {
-        // Root label: keep horizontal & readable even while rotating (counter-rotate)
-        float desiredAngleDeg = 0.0f;
-        float anglePassed = desiredAngleDeg - g_rotDeg;
-        drawStrokeStringRotatedAligned(3.0f, 0.0f, anglePassed, scale,
-                                       LABEL_STROKE_FONT, n->text, TextAlign::Start);
-    } else {
-        bool isLeaf = n->children.empty();
-        if (!LABEL_LEAVES_ONLY || isLeaf) {
-            float len = std::sqrt(n->x*n->x + n->y*n->y);
-            float dx = (len > 1e-6f) ? (n->x / len) : 1.0f;
-            float dy = (len > 1e-6f) ? (n->y / len) : 0.0f;
+// Links and endpoint circles for the given slot ranges, from the given arrays
+// (the retained buffers or a projected copy of them).
+static void drawBufferRanges(const std::vector<std::pair<int, int>>& ranges,
+                             const float* edgeVerts, const float* circleVerts)
+{
+    glEnableClientState(GL_VERTEX_ARRAY);
+
+    glColor4f(0.45f, 0.45f, 0.45f, 0.55f);
+    glLineWidth(1.0f);
+    glVertexPointer(2, GL_FLOAT, 0, edgeVerts);
+    for (const auto& r : ranges) {
+        int b = std::max(r.first, 1); // root has no incoming link
+        if (b < r.second) glMultiDrawArrays(GL_LINE_STRIP, &g_edgeFirst[b], &g_edgeCount[b], r.second - b);
+    }
 
-            float lx = n->x + dx * LABEL_RADIAL_PAD;
-            float ly = n->y + dy * LABEL_RADIAL_PAD;
+    glColor4f(0.30f, 0.30f, 0.30f, 0.95f);
+    glVertexPointer(2, GL_FLOAT, 0, circleVerts);
+    for (const auto& r : ranges)
+        glMultiDrawArrays(GL_TRIANGLE_FAN, &g_circleFirst[r.first], &g_circleCount[r.first], r.second - r.first);
 
-            float screenAngleRad = n->angle + rotRad;
-            bool leftSideScreen = (std::cos(screenAngleRad) < 0.0f);
+    glDisableClientState(GL_VERTEX_ARRAY);
+}
 
-            float desiredAngleDeg = radiansToDegrees(screenAngleRad); // parallel to radial
-            TextAlign align = TextAlign::Start;
+// ---------------------------- View State ----------------------------
 
-            if (leftSideScreen) {
-                desiredAngleDeg += 180.0f; // keep readable
-                align = TextAlign::End;    // end-align to anchor
-            }
+struct LabelPlacement {
+    float x, y;       // anchor, world units (before view rotation)
+    float angleDeg;   // relative to the modelview, which already rotates by the view's rotDeg
+    TextAlign align;
+};
 
-            // Modelview already rotates by g_rotDeg, so pass relative angle.
-            float anglePassed = desiredAngleDeg - g_rotDeg;
+struct PlacedLabel {
+    const Node* node;
+    LabelPlacement place;
+    size_t chars;   // glyphs of node->text to draw
+    bool ellipsis;
+    float scale;    // stroke units -> world units
+    LabelBox box;   // view pixels
+};
 
-            drawStrokeStringRotatedAligned(lx, ly, anglePassed, scale,
-                                           LABEL_STROKE_FONT, n->text, align);
-        }
-    }
+// Links, then circles, then labels: placed (decluttered) for the whole view
+// first, then drawn. A band of a screenshot starts from labels placed for
+// the whole screenshot (ViewFrame::prePlaced) and skips PROG_PLACE.
+enum ProgressStage { PROG_LINKS, PROG_CIRCLES, PROG_PLACE, PROG_LABELS, PROG_DONE };
+
+// Everything derived from a Viewport while drawing it: what is culled or
+// aggregated, where labels went, how far a progressive pass has come. The
+// window and a screenshot in progress each have one, so neither disturbs
+// the state the other's next frame starts from.
+struct ViewFrame {
+    Viewport vp;
+
+    // Nodes drawn in the current frame (after culling / LOD), for the label passes.
+    std::vector<int> drawn;
+    int frameNo = 0;
+
+    // Level of detail: slot ranges drawn in full, plus aggregate fans
+    // (xy triangles, rgba per vertex) for the subtrees cut.
+    std::vector<std::pair<int, int>> lodRanges;
+    std::vector<float> lodVerts, lodColors;
+    size_t lodAggregates = 0;
+
+    // Label decluttering: grid cells hold indices into placed.
+    std::vector<PlacedLabel> placed;
+    std::vector<std::vector<int>> grid;
+    int gridCols = 0, gridRows = 0;
+    bool prePlaced = false;
+
+    // Hyperbolic projection of the retained buffers; hypRanges are the
+    // visible ranges minus culled subtrees.
+    std::vector<float> hypNodeXY, hypEdgeVerts, hypCircleVerts;
+    std::vector<std::pair<int, int>> hypRanges;
+
+    // Progressive pass
+    ProgressStage stage = PROG_DONE;
+    size_t cursor = 0;
+    std::vector<int> slots;     // drawn slots, shallow depths first
+};
+
+static ViewFrame g_windowFrame;
 
-    for (const auto& ch : n->children) drawLabelsRecursive(ch.get());
+static void beginDrawnFrame(ViewFrame& f) {
+    f.drawn.resize(g_nodes.size(), 0);
+    ++f.frameNo;
 }
 
-// ---------------------------- Rendering ----------------------------
+static bool nodeDrawn(const ViewFrame& f, const Node* n) {
+    return f.drawn[n->index] == f.frameNo;
+}
 
-static void setupOrtho() {
-    glMatrixMode(GL_PROJECTION);
-    glLoadIdentity();
+// ---------------------------- Label Placement ----------------------------
 
-    float aspect = (g_winH != 0) ? float(g_winW) / float(g_winH) : 1.0f;
-    float halfH = BASE_HALF_H / g_zoom;
-    float halfW = halfH * aspect;
+static float labelScale(const Viewport& vp) {
+    return LABEL_CONST_SCREEN_SIZE ? (LABEL_STROKE_SCALE / vp.zoom) : LABEL_STROKE_SCALE;
+}
 
-    glOrtho(-halfW, halfW, -halfH, halfH, -1, 1);
+// Which labels a loop wants. ByFlag tests LABEL_LEAVES_ONLY for every entry;
+// All and Leaves have it resolved once per loop (forEachWantedLabel()).
+enum class LabelFilter { All, Leaves, ByFlag };
 
-    glMatrixMode(GL_MODELVIEW);
-    glLoadIdentity();
+template <LabelFilter F>
+static bool wantLabel(const ViewFrame& f, const LabelEntry& e) {
+    if constexpr (F == LabelFilter::All)         return nodeDrawn(f, e.node);
+    else if constexpr (F == LabelFilter::Leaves) return e.leaf && nodeDrawn(f, e.node);
+    else                                         return (!LABEL_LEAVES_ONLY || e.leaf) && nodeDrawn(f, e.node);
+}
 
-    glTranslatef(-g_panX, -g_panY, 0.0f);
-    glRotatef(g_rotDeg, 0.0f, 0.0f, 1.0f);
+// Per-entry flag test, for the few single-label checks.
+static bool labelWanted(const ViewFrame& f, const LabelEntry& e) {
+    return wantLabel<LabelFilter::ByFlag>(f, e);
 }
 
-static void display() {
-    glClearColor(1,1,1,1);
-    glClear(GL_COLOR_BUFFER_BIT);
+// fn(entry) for the wanted labels of g_labelCache[order[b..e)] (order == nullptr: cache order).
+template <LabelFilter F, typename Fn>
+static void forEachLabel(const ViewFrame& f, const int* order, size_t b, size_t e, Fn&& fn) {
+    for (size_t i = b; i < e; ++i) {
+        const LabelEntry& le = g_labelCache[order ? size_t(order[i]) : i];
+        if (wantLabel<F>(f, le)) fn(le);
+    }
+}
 
-    setupOrtho();
+template <typename Fn>
+static void forEachWantedLabel(const ViewFrame& f, const int* order, size_t b, size_t e, Fn&& fn) {
+    if (LABEL_LEAVES_ONLY) forEachLabel<LabelFilter::Leaves>(f, order, b, e, fn);
+    else                   forEachLabel<LabelFilter::All>(f, order, b, e, fn);
+}
 
-    drawEdgesRecursive(g_root.get());
-    drawLabelsRecursive(g_root.get());
+static void placeRootLabel(const Viewport& vp, LabelPlacement& p) {
+    // Root label: keep horizontal & readable even while rotating (counter-rotate)
+    float desiredAngleDeg = 0.0f;
+    p.x = 3.0f;
+    p.y = 0.0f;
+    p.angleDeg = desiredAngleDeg - vp.rotDeg;
+    p.align = TextAlign::Start;
+}
 
-    glutSwapBuffers();
+static void placeLabel(const Viewport& vp, const LabelEntry& e, LabelPlacement& p) {
+    // The cached flip states follow the window's rotation (syncLabelFlips());
+    // a view at another rotation works its own out.
+    bool flipped = (vp.rotDeg == g_labelFlipRotDeg) ? e.flipped : labelFlippedAt(e.angle, vp.rotDeg);
+    p.x = e.x;
+    p.y = e.y;
+    // Flipped labels turn 180 to stay readable and end-align to the anchor.
+    p.angleDeg = flipped ? e.baseDeg + 180.0f : e.baseDeg;
+    p.align    = flipped ? TextAlign::End : TextAlign::Start;
 }
 
-// ---------------------------- Animation ----------------------------
+// ---------------------------- Label Decluttering ----------------------------
 
-static void idle() {
-    if (!g_rotateAnim) return;
+// World -> view pixel transform for a viewport (matches setupOrtho()).
+struct ScreenXform {
+    float c, s;      // rotation by rotDeg
+    float ppw;       // pixels per world unit
+    float ox, oy;    // view center
+    float panX, panY, rotDeg;
+    int w, h;        // view size, pixels
+    int y0, y1;      // rows drawn
+};
 
-    int now = glutGet(GLUT_ELAPSED_TIME);
-    if (g_lastTimeMs == 0) g_lastTimeMs = now;
+static ScreenXform screenXform(const Viewport& vp) {
+    float rot = degreesToRadians(vp.rotDeg);
+    ScreenXform X;
+    X.c = std::cos(rot);
+    X.s = std::sin(rot);
+    X.ppw = float(vp.h) / (2.0f * BASE_HALF_H / vp.zoom);
+    X.ox = 0.5f * float(vp.w);
+    X.oy = 0.5f * float(vp.h);
+    X.panX = vp.panX;
+    X.panY = vp.panY;
+    X.rotDeg = vp.rotDeg;
+    X.w = vp.w;
+    X.h = vp.h;
+    X.y0 = vp.y0;
+    X.y1 = vp.y1;
+    return X;
+}
 
-    int dtMs = now - g_lastTimeMs;
-    g_lastTimeMs = now;
+static ScreenXform currentScreenXform() {
+    return screenXform(windowViewport());
+}
 
-    float dt = float(dtMs) / 1000.0f;
-    g_rotDeg += g_rotDegPerSec * dt;
+static void worldToScreen(const ScreenXform& X, float wx, float wy, float& sx, float& sy) {
+    float vx = X.c * wx - X.s * wy - X.panX;
+    float vy = X.s * wx + X.c * wy - X.panY;
+    sx = X.ox + vx * X.ppw;
+    sy = X.oy + vy * X.ppw;
+}
 
-    if (g_rotDeg >= 360.0f) g_rotDeg -= 360.0f;
-    if (g_rotDeg < 0.0f)    g_rotDeg += 360.0f;
+static LabelBox makeLabelBox(const ScreenXform& X, const LabelPlacement& p,
+                             float widthStroke, float pxPerStroke)
+{
+    // View pixels are y up here, so the up direction is the baseline turned left.
+    float a = degreesToRadians(p.angleDeg + X.rotDeg);
+    float ux = std::cos(a), uy = std::sin(a);
+
+    float len = widthStroke * pxPerStroke;
+    float u0 = 0.0f, u1 = len;                        // Start
+    if (p.align == TextAlign::Center)   { u0 = -0.5f * len; u1 = 0.5f * len; }
+    else if (p.align == TextAlign::End) { u0 = -len;        u1 = 0.0f; }
+
+    float sx, sy;
+    worldToScreen(X, p.x, p.y, sx, sy);
+    return labelTextBox(sx, sy, ux, uy, -uy, ux, u0, u1, pxPerStroke);
+}
 
-    glutPostRedisplay();
+// Grid cells touched by the box's axis-aligned bounds; false if fully off-screen.
+static bool labelBoxCells(const ViewFrame& f, const LabelBox& b, int& c0, int& r0, int& c1, int& r1) {
+    float ex, ey;
+    labelBoxBounds(b, ex, ey);
+    if (b.cx + ex < 0.0f || b.cy + ey < 0.0f ||
+        b.cx - ex > float(f.vp.w) || b.cy - ey > float(f.vp.h)) return false;
+
+    c0 = std::max(0, int((b.cx - ex) / LABEL_GRID_CELL_PX));
+    r0 = std::max(0, int((b.cy - ey) / LABEL_GRID_CELL_PX));
+    c1 = std::min(f.gridCols - 1, int((b.cx + ex) / LABEL_GRID_CELL_PX));
+    r1 = std::min(f.gridRows - 1, int((b.cy + ey) / LABEL_GRID_CELL_PX));
+    return true;
 }
 
-// ---------------------------- Interaction ----------------------------
+static bool labelBoxCollides(const ViewFrame& f, const LabelBox& b, int c0, int r0, int c1, int r1) {
+    for (int r = r0; r <= r1; ++r)
+        for (int c = c0; c <= c1; ++c)
+            for (int idx : f.grid[r * f.gridCols + c])
+                if (labelBoxesOverlap(b, f.placed[idx].box)) return true;
+    return false;
+}
 
-static void reshape(int w, int h) {
-    g_winW = std::max(1, w);
-    g_winH = std::max(1, h);
-    glViewport(0, 0, g_winW, g_winH);
-    glutPostRedisplay();
+// Append to f.placed and, when decluttering, to the grid cells the label touches.
+static void addPlacedLabel(ViewFrame& f, const PlacedLabel& pl, int c0, int r0, int c1, int r1) {
+    int idx = int(f.placed.size());
+    f.placed.push_back(pl);
+    if (!LABEL_DECLUTTER) return;
+    for (int r = r0; r <= r1; ++r)
+        for (int c = c0; c <= c1; ++c)
+            f.grid[r * f.gridCols + c].push_back(idx);
 }
 
-static void keyboard(unsigned char key, int, int) {
-    if (key == 27) std::exit(0); // ESC
+static void resetDeclutterGrid(ViewFrame& f) {
+    f.placed.clear();
 
-    if (key == '+' || key == '=') g_zoom = std::min(20.0f, g_zoom * 1.1f);
-    if (key == '-' || key == '_') g_zoom = std::max(0.1f,  g_zoom * 0.9f);
+    f.gridCols = std::max(1, int(std::ceil(float(f.vp.w) / LABEL_GRID_CELL_PX)));
+    f.gridRows = std::max(1, int(std::ceil(float(f.vp.h) / LABEL_GRID_CELL_PX)));
+    f.grid.resize(size_t(f.gridCols) * size_t(f.gridRows));
+    for (auto& cell : f.grid) cell.clear();
+}
 
-    if (key == 'l' || key == 'L') LABEL_LEAVES_ONLY = !LABEL_LEAVES_ONLY;
+// Longest prefix of n->text + "..." whose box (returned in box) fits among
+// the labels placed so far; 0 if none does. Shorter prefixes shrink the box
+// from its outer end, so the collision test is monotonic.
+static size_t truncateLabel(const ViewFrame& f, const ScreenXform& X, float pxPerStroke, float ellipsisW,
+                            const Node* n, const LabelPlacement& p, LabelBox& box)
+{
+    size_t len = n->text.size();
+    size_t lo = std::max<size_t>(3, size_t(std::ceil(LABEL_TRUNC_MIN * float(len))));
+    size_t hi = (len > 0) ? len - 1 : 0;
+    size_t best = 0;
+    while (lo <= hi) {
+        size_t mid = (lo + hi) / 2;
+        LabelBox t = makeLabelBox(X, p, labelTextWidth(n->text, mid) + ellipsisW, pxPerStroke);
+        int tc0, tr0, tc1, tr1;
+        if (labelBoxCells(f, t, tc0, tr0, tc1, tr1) && !labelBoxCollides(f, t, tc0, tr0, tc1, tr1)) {
+            best = mid;
+            box = t;
+            lo = mid + 1;
+        } else {
+            hi = mid - 1;
+        }
+    }
+    return best;
+}
 
-    // Toggle curved/straight links
-    if (key == 'c' || key == 'C') LINKS_CURVED = !LINKS_CURVED;
+// Place one on-screen label drawn at 'scale' if it (or a truncation of it)
+// fits among those placed so far; without decluttering, it always does.
+static void declutterOne(ViewFrame& f, const ScreenXform& X, float pxPerStroke, float scale, float ellipsisW,
+                         const Node* n, const LabelPlacement& p)
+{
+    int c0, r0, c1, r1;
+    LabelBox box = makeLabelBox(X, p, n->textWidth, pxPerStroke);
+    if (!labelBoxCells(f, box, c0, r0, c1, r1)) return;
 
-    // Fullscreen toggle
-    if (key == 'f' || key == 'F') {
-        if (!g_fullscreen) {
-            g_fullscreen = true;
-            g_winW_prev = g_winW;
-            g_winH_prev = g_winH;
-            g_winX = glutGet(GLUT_WINDOW_X);
+    if (!LABEL_DECLUTTER || !labelBoxCollides(f, box, c0, r0, c1, r1)) {
+        addPlacedLabel(f, { n, p, n->text.size(), false, scale, box }, c0, r0, c1, r1);
+        return;
+    }
+
+    // Almost enough room: longest prefix + "..." that fits.
+    size_t best = truncateLabel(f, X, pxPerStroke, ellipsisW, n, p, box);
+    if (best == 0) return;
+
+    labelBoxCells(f, box, c0, r0, c1, r1);
+    addPlacedLabel(f, { n, p, best, true, scale, box }, c0, r0, c1, r1);
+}
+
+// Greedy placement in priority order into f.placed: k = 0 is the root, k > 0
+// the cached label g_labelOrder[k - 1]. A progressive pass places [b, e) a
+// piece at a time on a grid reset before k = 0.
+static void declutterRange(ViewFrame& f, size_t b, size_t e) {
+    ScreenXform X = screenXform(f.vp);
+    float scale = labelScale(f.vp);
+    float pxPerStroke = scale * X.ppw;
+    if (b >= e || (LABEL_DECLUTTER && STROKE_ROMAN_HEIGHT * pxPerStroke < LABEL_MIN_PIXEL_H)) return;
+
+    float ellipsisW = labelTextWidth("...");
+
+    LabelPlacement p;
+    if (b == 0) {
+        placeRootLabel(f.vp, p);
+        declutterOne(f, X, pxPerStroke, scale, ellipsisW, g_focus, p);
+    }
+    forEachWantedLabel(f, g_labelOrder.data(), std::max<size_t>(b, 1) - 1, e - 1, [&](const LabelEntry& le) {
+        placeLabel(f.vp, le, p);
+        declutterOne(f, X, pxPerStroke, scale, ellipsisW, le.node, p);
+    });
+}
+
+static void declutterLabels(ViewFrame& f) {
+    resetDeclutterGrid(f);
+    declutterRange(f, 0, g_labelOrder.size() + 1);
+}
+
+// ---------------------------- Label Drawing ----------------------------
+
+static void drawAllLabels(const ViewFrame& f) {
+    float scale = labelScale(f.vp);
+
+    LabelPlacement p;
+    placeRootLabel(f.vp, p);
+    drawStrokeStringRotatedAligned(p.x, p.y, p.angleDeg, scale, g_focus->text, p.align);
+
+    forEachWantedLabel(f, nullptr, 0, g_labelCache.size(), [&](const LabelEntry& e) {
+        placeLabel(f.vp, e, p);
+        drawStrokeStringRotatedAligned(p.x, p.y, p.angleDeg, scale, e.node->text, p.align);
+    });
+}
+
+static void drawPlacedLabel(const PlacedLabel& pl) {
+    const LabelPlacement& p = pl.place;
+    if (pl.ellipsis) {
+        drawStrokeStringRotatedAligned(p.x, p.y, p.angleDeg, pl.scale,
+                                       pl.node->text.substr(0, pl.chars) + "...", p.align);
+    } else {
+        drawStrokeStringRotatedAligned(p.x, p.y, p.angleDeg, pl.scale, pl.node->text, p.align);
+    }
+}
+
+static void drawDeclutteredLabels(ViewFrame& f) {
+    declutterLabels(f);
+    for (const PlacedLabel& pl : f.placed) drawPlacedLabel(pl);
+}
+
+static void drawLabels(ViewFrame& f) {
+    syncLabelFlips();
+
+    glColor4f(0.10f, 0.10f, 0.10f, 1.0f);
+    if (LABEL_DECLUTTER) drawDeclutteredLabels(f);
+    else                 drawAllLabels(f);
+}
+
+// ---------------------------- Hyperbolic View ----------------------------
+
+// Layout positions are mapped into the Poincare disk: a point at layout radius
+// rho is placed at hyperbolic distance asinh(rho / S), which keeps the ring
+// circumferences of the layout, i.e. Poincare radius x / (1 + sqrt(1 + x^2))
+// with x = rho / S. A Mobius translation then moves the focus c to the center.
+// Everything is re-projected per frame from the retained buffers, for the
+// focus (hypCx, hypCy) of the viewport drawn.
+
+static float hyperDiskRadius() { return HYPER_DISK_FRAC * BASE_HALF_H; }
+
+// Project 'points' interleaved xy pairs from layout space to the view disk.
+static void hyperbolicKernel(const Viewport& vp, const float* in, float* out, size_t points) {
+    const float invS = 1.0f / (HYPER_SCALE * RADIUS_STEP);
+    const float D = hyperDiskRadius();
+    const float cx = vp.hypCx, cy = vp.hypCy;
+
+    size_t i = 0;
+#if defined(__SSE2__)
+    const __m128 vInvS = _mm_set1_ps(invS), vD = _mm_set1_ps(D), one = _mm_set1_ps(1.0f);
+    const __m128 vcx = _mm_set1_ps(cx), vcy = _mm_set1_ps(cy);
+    for (; i + 4 <= points; i += 4) {
+        __m128 a = _mm_loadu_ps(in + 2*i), b = _mm_loadu_ps(in + 2*i + 4);
+        __m128 x = _mm_mul_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)), vInvS);
+        __m128 y = _mm_mul_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)), vInvS);
+
+        __m128 rr = _mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y));
+        __m128 k = _mm_div_ps(one, _mm_add_ps(one, _mm_sqrt_ps(_mm_add_ps(one, rr))));
+        __m128 ux = _mm_mul_ps(x, k), uy = _mm_mul_ps(y, k);
+
+        __m128 nx = _mm_sub_ps(ux, vcx), ny = _mm_sub_ps(uy, vcy);
+        __m128 dr = _mm_sub_ps(_mm_sub_ps(one, _mm_mul_ps(vcx, ux)), _mm_mul_ps(vcy, uy));
+        __m128 di = _mm_sub_ps(_mm_mul_ps(vcy, ux), _mm_mul_ps(vcx, uy));
+        __m128 inv = _mm_div_ps(vD, _mm_add_ps(_mm_mul_ps(dr, dr), _mm_mul_ps(di, di)));
+        __m128 wx = _mm_mul_ps(_mm_add_ps(_mm_mul_ps(nx, dr), _mm_mul_ps(ny, di)), inv);
+        __m128 wy = _mm_mul_ps(_mm_sub_ps(_mm_mul_ps(ny, dr), _mm_mul_ps(nx, di)), inv);
+
+        _mm_storeu_ps(out + 2*i,     _mm_unpacklo_ps(wx, wy));
+        _mm_storeu_ps(out + 2*i + 4, _mm_unpackhi_ps(wx, wy));
+    }
+#endif
+    for (; i < points; ++i) {
+        float x = in[2*i] * invS, y = in[2*i + 1] * invS;
+        float k = 1.0f / (1.0f + std::sqrt(1.0f + x*x + y*y));
+        float ux = x * k, uy = y * k;
+        float nx = ux - cx, ny = uy - cy;
+        float dr = 1.0f - cx*ux - cy*uy, di = cy*ux - cx*uy;
+        float inv = D / (dr*dr + di*di);
+        out[2*i]     = (nx*dr + ny*di) * inv;
+        out[2*i + 1] = (ny*dr - nx*di) * inv;
+    }
+}
+
+// Projected point plus the local (tangential) magnification, for labels and markers.
+static void hyperbolicPoint(const Viewport& vp, float px, float py, float& ox, float& oy, float& mag) {
+    float in[2] = { px, py }, out[2];
+    hyperbolicKernel(vp, in, out, 1);
+    ox = out[0];
+    oy = out[1];
+
+    float invS = 1.0f / (HYPER_SCALE * RADIUS_STEP);
+    float x = px * invS, y = py * invS;
+    float k = 1.0f / (1.0f + std::sqrt(1.0f + x*x + y*y));
+    float ux = x * k, uy = y * k;
+    float dr = 1.0f - vp.hypCx*ux - vp.hypCy*uy, di = vp.hypCy*ux - vp.hypCx*uy;
+    float cc = vp.hypCx*vp.hypCx + vp.hypCy*vp.hypCy;
+    mag = hyperDiskRadius() * invS * k * (1.0f - cc) / (dr*dr + di*di);
+}
+
+// View-disk point (world units) back to layout space; false outside the disk.
+static bool hyperbolicUnproject(float wx, float wy, float& px, float& py) {
+    float D = hyperDiskRadius();
+    wx /= D; wy /= D;
+    if (wx*wx + wy*wy >= 0.9999f) return false;
+
+    // u = (w + c) / (1 + conj(c) w)
+    float nx = wx + g_hypCx, ny = wy + g_hypCy;
+    float dr = 1.0f + g_hypCx*wx + g_hypCy*wy, di = g_hypCx*wy - g_hypCy*wx;
+    float inv = 1.0f / (dr*dr + di*di);
+    float ux = (nx*dr + ny*di) * inv, uy = (ny*dr - nx*di) * inv;
+
+    float r = std::sqrt(ux*ux + uy*uy);
+    if (r < 1e-7f) { px = py = 0.0f; return true; }
+    float x = 2.0f * r / (1.0f - r*r); // inverse of x / (1 + sqrt(1 + x^2))
+    float s = x * (HYPER_SCALE * RADIUS_STEP) / r;
+    px = ux * s;
+    py = uy * s;
+    return true;
+}
+
+// Drag: pick the focus c' for which the layout point under w1 lands on w2
+// (both in world units inside the view disk). Solving (u - c') / (1 - conj(c') u) = w2
+// for the Mobius translation gives c' = (m + k conj(m)) / (1 - |k|^2), k = w2 u, m = u - w2.
+static void hyperbolicDrag(float w1x, float w1y, float w2x, float w2y) {
+    float D = hyperDiskRadius();
+    auto clampDisk = [](float& x, float& y) {
+        float r = std::sqrt(x*x + y*y);
+        if (r > 0.98f) { x *= 0.98f / r; y *= 0.98f / r; }
+    };
+    w1x /= D; w1y /= D; w2x /= D; w2y /= D;
+    clampDisk(w1x, w1y);
+    clampDisk(w2x, w2y);
+
+    float nx = w1x + g_hypCx, ny = w1y + g_hypCy;
+    float dr = 1.0f + g_hypCx*w1x + g_hypCy*w1y, di = g_hypCx*w1y - g_hypCy*w1x;
+    float inv = 1.0f / (dr*dr + di*di);
+    float ux = (nx*dr + ny*di) * inv, uy = (ny*dr - nx*di) * inv;
+
+    float kx = w2x*ux - w2y*uy, ky = w2x*uy + w2y*ux;
+    float mx = ux - w2x, my = uy - w2y;
+    float kk = kx*kx + ky*ky;
+    if (kk >= 0.9999f) return;
+    float cx = (mx + kx*mx + ky*my) / (1.0f - kk);
+    float cy = (my + ky*mx - kx*my) / (1.0f - kk);
+    clampDisk(cx, cy);
+    g_hypCx = cx;
+    g_hypCy = cy;
+}
+
+// Move the focus so that layout point (px, py) is at the disk center.
+static void hyperbolicFocusOn(float px, float py) {
+    float invS = 1.0f / (HYPER_SCALE * RADIUS_STEP);
+    float x = px * invS, y = py * invS;
+    float k = 1.0f / (1.0f + std::sqrt(1.0f + x*x + y*y));
+    g_hypCx = x * k;
+    g_hypCy = y * k;
+}
+
+// Project node positions, cull subtrees whose incoming link is below
+// HYPER_CULL_PX, then project only the surviving edge and circle slots.
+static void projectHyperbolic(ViewFrame& f) {
+    const Viewport& vp = f.vp;
+    size_t count = g_nodes.size();
+    f.hypNodeXY.resize(2 * count);
+    f.hypEdgeVerts.resize(g_edgeVerts.size());
+    f.hypCircleVerts.resize(g_circleVerts.size());
+    beginDrawnFrame(f);
+
+    for (const auto& r : g_visibleRanges)
+        hyperbolicKernel(vp, &g_nodeXY[2 * size_t(r.first)], &f.hypNodeXY[2 * size_t(r.first)],
+                         size_t(r.second - r.first));
+
+    float minLen = HYPER_CULL_PX / screenXform(vp).ppw;
+    const std::vector<float>& xy = f.hypNodeXY;
+    f.hypRanges.clear();
+    for (const auto& r : g_visibleRanges) {
+        int start = r.first, i = r.first;
+        while (i < r.second) {
+            const Node* n = g_nodes[i];
+            f.drawn[i] = f.frameNo;
+            int end = std::min(n->subtreeEnd, r.second);
+            if (n->parent && end > i + 1) {
+                int p = n->parent->index;
+                float dx = xy[2*i] - xy[2*p], dy = xy[2*i + 1] - xy[2*p + 1];
+                if (dx*dx + dy*dy < minLen * minLen) {
+                    f.hypRanges.push_back({ start, i + 1 });
+                    i = start = end;
+                    continue;
+                }
+            }
+            ++i;
+        }
+        if (start < r.second) f.hypRanges.push_back({ start, r.second });
+    }
+
+    for (const auto& r : f.hypRanges) {
+        size_t e0 = size_t(r.first) * size_t(g_edgeStride), e1 = size_t(r.second) * size_t(g_edgeStride);
+        hyperbolicKernel(vp, &g_edgeVerts[2 * e0], &f.hypEdgeVerts[2 * e0], e1 - e0);
+        size_t c0 = size_t(r.first) * size_t(g_circleStride), c1 = size_t(r.second) * size_t(g_circleStride);
+        hyperbolicKernel(vp, &g_circleVerts[2 * c0], &f.hypCircleVerts[2 * c0], c1 - c0);
+    }
+}
+
+static void drawHyperbolicDisk() {
+    glColor4f(0.80f, 0.80f, 0.85f, 1.0f);
+    glBegin(GL_LINE_LOOP);
+    for (int k = 0; k < 128; ++k) {
+        float a = (2.0f * float(M_PI)) * (float(k) / 128.0f);
+        glVertex2f(std::cos(a) * hyperDiskRadius(), std::sin(a) * hyperDiskRadius());
+    }
+    glEnd();
+}
+
+// Selection / hover markers at their projected positions
+static void drawHyperbolicMarkers(const Viewport& vp) {
+    const Node* marks[2] = { g_selectedNode, g_hoverNode };
+    for (int k = 0; k < 2; ++k) {
+        if (!marks[k]) continue;
+        float wx, wy, px, py, mag;
+        drawnPosition(marks[k], wx, wy);
+        hyperbolicPoint(vp, wx, wy, px, py, mag);
+        if (k == 0) glColor4f(0.90f, 0.45f, 0.05f, 0.95f);
+        else        glColor4f(0.10f, 0.40f, 0.90f, 0.90f);
+        drawFilledCircle(px, py, 3.0f * ENDPOINT_RADIUS * std::max(0.3f, mag), CIRCLE_SEGS);
+    }
+}
+
+// Hyperbolic counterpart of declutterRange(): every label is placed along its
+// projected radial direction and scaled by the local magnification.
+static void declutterHyperbolicRange(ViewFrame& f, size_t b, size_t e) {
+    ScreenXform X = screenXform(f.vp);
+    float baseScale = labelScale(f.vp);
+    float ellipsisW = labelTextWidth("...");
+
+    for (size_t k = b; k < e; ++k) {
+        const Node* n = (k == 0) ? g_focus : g_labelCache[g_labelOrder[k - 1]].node;
+        if (k > 0 && !labelWanted(f, g_labelCache[g_labelOrder[k - 1]])) continue;
+        if (!nodeDrawn(f, n)) continue;
+
+        float wx, wy, px, py, mag;
+        drawnPosition(n, wx, wy);
+        hyperbolicPoint(f.vp, wx, wy, px, py, mag);
+        float pxPerStroke = baseScale * mag * X.ppw;
+        if (STROKE_ROMAN_HEIGHT * pxPerStroke < LABEL_MIN_PIXEL_H) continue;
+
+        float x = f.hypNodeXY[2 * n->index], y = f.hypNodeXY[2 * n->index + 1];
+        float len = std::sqrt(x*x + y*y);
+        float dx = (len > 1e-6f) ? x / len : 1.0f, dy = (len > 1e-6f) ? y / len : 0.0f;
+        float deg = radiansToDegrees(std::atan2(dy, dx));
+        bool flipped = n != g_focus && labelFlippedAt(degreesToRadians(deg), f.vp.rotDeg);
+
+        LabelPlacement p;
+        p.x = x + dx * LABEL_RADIAL_PAD * mag;
+        p.y = y + dy * LABEL_RADIAL_PAD * mag;
+        p.angleDeg = flipped ? deg + 180.0f : deg;
+        p.align = flipped ? TextAlign::End : TextAlign::Start;
+        if (n == g_focus) p.angleDeg = -f.vp.rotDeg; // keep the center label horizontal
+
+        declutterOne(f, X, pxPerStroke, baseScale * mag, ellipsisW, n, p);
+    }
+}
+
+static void drawHyperbolic(ViewFrame& f) {
+    if (g_buffersDirty) fillRenderBuffers();
+    projectHyperbolic(f);
+
+    drawHyperbolicDisk();
+    drawBufferRanges(f.hypRanges, f.hypEdgeVerts.data(), f.hypCircleVerts.data());
+    drawHyperbolicMarkers(f.vp);
+
+    resetDeclutterGrid(f);
+    declutterHyperbolicRange(f, 0, g_labelOrder.size() + 1);
+    glColor4f(0.10f, 0.10f, 0.10f, 1.0f);
+    for (const PlacedLabel& pl : f.placed) drawPlacedLabel(pl);
+}
+
+// ---------------------------- Layout Transitions ----------------------------
+
+// Every layout change (refocus, fold, spacing, curve toggle, reload) animates
+// from the captured per-node polar coordinates to the new ones. Arrays are
+// indexed like g_nodes. Nodes that appear start from their parent's old
+// position; nodes that disappear end at their parent's new position.
+static int  g_transitionStartMs = 0;
+static std::vector<float> g_fromAngle, g_fromRadius, g_toAngle, g_toRadius;
+static std::vector<std::pair<int, int>> g_transitionOld;  // visible ranges at capture
+static std::vector<std::pair<int, int>> g_targetRanges;   // visible ranges after the transition
+static std::vector<int> g_visStamp;                       // per node: generation it was last seen visible
+static int g_visGeneration = 0, g_fromGeneration = 0;
+static float g_fromPanX = 0.0f, g_fromPanY = 0.0f, g_toPanX = 0.0f, g_toPanY = 0.0f;
+static float g_fromCurve = 1.0f;
+
+// Union of two sorted, disjoint range lists.
+static std::vector<std::pair<int, int>> mergeRanges(const std::vector<std::pair<int, int>>& a,
+                                                    const std::vector<std::pair<int, int>>& b)
+{
+    std::vector<std::pair<int, int>> all(a);
+    all.insert(all.end(), b.begin(), b.end());
+    std::sort(all.begin(), all.end());
+    std::vector<std::pair<int, int>> out;
+    for (const auto& r : all) {
+        if (!out.empty() && r.first <= out.back().second) out.back().second = std::max(out.back().second, r.second);
+        else out.push_back(r);
+    }
+    return out;
+}
+
+// Interpolate [i0, i1) in polar space: angle along the shorter arc, radius
+// linearly, then back to Cartesian. Four nodes per step with SSE2; sin/cos use
+// a quadrant reduction and minimax polynomials (|error| < 1e-6 on the layout range).
+static void lerpPolarKernel(int i0, int i1, float e) {
+    const float* fa = g_fromAngle.data();
+    const float* fr = g_fromRadius.data();
+    const float* ta = g_toAngle.data();
+    const float* tr = g_toRadius.data();
+    float* oa = g_lerpAngle.data();
+    float* orad = g_lerpRadius.data();
+    float* ox = g_lerpX.data();
+    float* oy = g_lerpY.data();
+    const float twoPi = 2.0f * float(M_PI);
+
+    int i = i0;
+#if defined(__SSE2__)
+    const __m128 ve = _mm_set1_ps(e);
+    const __m128 vTwoPi = _mm_set1_ps(twoPi), vInvTwoPi = _mm_set1_ps(1.0f / twoPi);
+    const __m128 vTwoOverPi = _mm_set1_ps(2.0f / float(M_PI));
+    const __m128 dp1 = _mm_set1_ps(1.5703125f), dp2 = _mm_set1_ps(4.837512969970703125e-4f),
+                 dp3 = _mm_set1_ps(7.54978995489188216e-8f);
+    const __m128 one = _mm_set1_ps(1.0f), half = _mm_set1_ps(0.5f);
+    const __m128 signBit = _mm_set1_ps(-0.0f);
+    const __m128i i1v = _mm_set1_epi32(1), i2v = _mm_set1_epi32(2);
+
+    for (; i + 4 <= i1; i += 4) {
+        __m128 a0 = _mm_loadu_ps(fa + i), a1 = _mm_loadu_ps(ta + i);
+        __m128 r0 = _mm_loadu_ps(fr + i), r1 = _mm_loadu_ps(tr + i);
+
+        __m128 d = _mm_sub_ps(a1, a0);
+        d = _mm_sub_ps(d, _mm_mul_ps(vTwoPi, _mm_cvtepi32_ps(_mm_cvtps_epi32(_mm_mul_ps(d, vInvTwoPi)))));
+        __m128 a = _mm_add_ps(a0, _mm_mul_ps(d, ve));
+        __m128 r = _mm_add_ps(r0, _mm_mul_ps(_mm_sub_ps(r1, r0), ve));
+
+        __m128i q = _mm_cvtps_epi32(_mm_mul_ps(a, vTwoOverPi));
+        __m128 qf = _mm_cvtepi32_ps(q);
+        __m128 x = _mm_sub_ps(a, _mm_mul_ps(qf, dp1));
+        x = _mm_sub_ps(x, _mm_mul_ps(qf, dp2));
+        x = _mm_sub_ps(x, _mm_mul_ps(qf, dp3));
+        __m128 z = _mm_mul_ps(x, x);
+
+        __m128 sp = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(-1.9515295891e-4f), z), _mm_set1_ps(8.3321608736e-3f));
+        sp = _mm_add_ps(_mm_mul_ps(sp, z), _mm_set1_ps(-1.6666654611e-1f));
+        sp = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(sp, z), x), x);
+        __m128 cp = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(2.443315711809948e-5f), z), _mm_set1_ps(-1.388731625493765e-3f));
+        cp = _mm_add_ps(_mm_mul_ps(cp, z), _mm_set1_ps(4.166664568298827e-2f));
+        cp = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(_mm_mul_ps(cp, z), z), _mm_mul_ps(half, z)), one);
+
+        // Quadrant: odd swaps sin/cos; bit 1 negates sin; bit 1 of q+1 negates cos.
+        __m128 swap = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(q, i1v), i1v));
+        __m128 sn = _mm_or_ps(_mm_and_ps(swap, cp), _mm_andnot_ps(swap, sp));
+        __m128 cs = _mm_or_ps(_mm_and_ps(swap, sp), _mm_andnot_ps(swap, cp));
+        __m128 negS = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(q, i2v), i2v));
+        __m128 negC = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(_mm_add_epi32(q, i1v), i2v), i2v));
+        sn = _mm_xor_ps(sn, _mm_and_ps(negS, signBit));
+        cs = _mm_xor_ps(cs, _mm_and_ps(negC, signBit));
+
+        _mm_storeu_ps(oa + i, a);
+        _mm_storeu_ps(orad + i, r);
+        _mm_storeu_ps(ox + i, _mm_mul_ps(cs, r));
+        _mm_storeu_ps(oy + i, _mm_mul_ps(sn, r));
+    }
+#endif
+    for (; i < i1; ++i) {
+        float d = std::remainder(ta[i] - fa[i], twoPi);
+        oa[i] = fa[i] + d * e;
+        orad[i] = fr[i] + (tr[i] - fr[i]) * e;
+        ox[i] = std::cos(oa[i]) * orad[i];
+        oy[i] = std::sin(oa[i]) * orad[i];
+    }
+}
+
+// Snapshot the visible nodes (at their current, possibly mid-transition,
+// positions) as the start of the next transition. Call before changing the layout.
+static void captureTransitionStart() {
+    size_t count = g_nodes.size();
+    for (auto* v : { &g_fromAngle, &g_fromRadius, &g_toAngle, &g_toRadius,
+                     &g_lerpAngle, &g_lerpRadius, &g_lerpX, &g_lerpY })
+        v->resize(count);
+    g_visStamp.resize(count, 0);
+
+    g_fromGeneration = ++g_visGeneration;
+    g_transitionOld = g_visibleRanges;
+    for (const auto& r : g_transitionOld) {
+        for (int i = r.first; i < r.second; ++i) {
+            const Node* n = g_nodes[i];
+            g_fromAngle[i] = g_transitionActive ? LerpPose::angle(n) : n->angle;
+            g_fromRadius[i] = g_transitionActive ? LerpPose::radius(n) : n->radius;
+            g_visStamp[i] = g_fromGeneration;
+        }
+    }
+    g_fromPanX = g_toPanX = g_panX;
+    g_fromPanY = g_toPanY = g_panY;
+    g_fromCurve = g_curveBlend;
+}
+
+// Move the label cache entries to the interpolated positions. The label set
+// and priorities stay those of startTransition(), so nothing is re-sorted;
+// only the angle order is lost, which syncLabelFlips() then allows for.
+static void moveLabelCache() {
+    size_t n = g_labelCache.size();
+    parallelChunks(n, geometryChunks(n), [](size_t b, size_t end, size_t) {
+        for (size_t i = b; i < end; ++i) {
+            LabelEntry& e = g_labelCache[i];
+            int k = e.node->index;
+            float a = g_lerpAngle[k], r = g_lerpRadius[k];
+            e.angle = std::fmod(a, 2.0f * float(M_PI));
+            if (e.angle < 0.0f) e.angle += 2.0f * float(M_PI);
+            float s = (r > 0.0f) ? 1.0f + LABEL_RADIAL_PAD / r : 0.0f;
+            e.x = g_lerpX[k] * s;
+            e.y = g_lerpY[k] * s;
+            e.baseDeg = radiansToDegrees(a);
+            e.flipped = labelFlippedAt(e.angle, g_rotDeg);
+        }
+    });
+    g_labelFlipRotDeg = g_rotDeg;
+    g_labelCacheMoved = true;
+}
+
+// Interpolate the visible nodes at eased time e in [0, 1]. The nodes keep
+// their target layout; slots, labels and markers are drawn from g_lerp*.
+static void applyTransition(float e) {
+    for (const auto& r : g_visibleRanges) lerpPolarKernel(r.first, r.second, e);
+    g_panX = g_fromPanX + (g_toPanX - g_fromPanX) * e;
+    g_panY = g_fromPanY + (g_toPanY - g_fromPanY) * e;
+    g_curveBlend = g_fromCurve + ((LINKS_CURVED ? 1.0f : 0.0f) - g_fromCurve) * e;
+    moveLabelCache();
+    g_buffersDirty = true;
+}
+
+// Start animating towards the layout now stored in the nodes and g_visibleRanges.
+static void startTransition() {
+    g_targetRanges = g_visibleRanges;
+
+    // Ranges are in preorder, so a parent is always resolved before its children.
+    int newGen = ++g_visGeneration;
+    for (const auto& r : g_targetRanges) {
+        for (int i = r.first; i < r.second; ++i) {
+            const Node* v = g_nodes[i];
+            g_toAngle[i] = v->angle;
+            g_toRadius[i] = v->radius;
+            if (g_visStamp[i] != g_fromGeneration) {
+                int p = v->parent ? v->parent->index : i;
+                g_fromAngle[i] = v->parent ? g_fromAngle[p] : v->angle;
+                g_fromRadius[i] = v->parent ? g_fromRadius[p] : 0.0f;
+            }
+            g_visStamp[i] = newGen;
+        }
+    }
+    for (const auto& r : g_transitionOld) {
+        for (int i = r.first; i < r.second; ++i) {
+            if (g_visStamp[i] == newGen) continue;
+            int p = g_nodes[i]->parent->index;
+            g_toAngle[i] = g_toAngle[p];
+            g_toRadius[i] = g_toRadius[p];
+        }
+    }
+
+    g_visibleRanges = mergeRanges(g_transitionOld, g_targetRanges);
+    g_transitionActive = true;
+    g_transitionStartMs = glutGet(GLUT_ELAPSED_TIME);
+
+    // One label cache for the whole transition, over the old and new visible
+    // nodes; the per-frame work is the kernel, moveLabelCache() and the slot fill.
+    buildLabelCache();
+    geometryChanged();
+    applyTransition(0.0f);
+}
+
+static void finishTransition() {
+    if (!g_transitionActive) return;
+    g_transitionActive = false;
+    g_panX = g_toPanX;
+    g_panY = g_toPanY;
+    g_curveBlend = LINKS_CURVED ? 1.0f : 0.0f;
+    g_visibleRanges = g_targetRanges;
+    buildLabelCache();
+    geometryChanged();
+}
+
+// Advance the running transition; called from idle().
+static void stepTransition() {
+    if (!g_transitionActive) return;
+
+    float t = float(glutGet(GLUT_ELAPSED_TIME) - g_transitionStartMs) / float(std::max(1, TRANSITION_MS));
+    if (t >= 1.0f) { finishTransition(); return; }
+    applyTransition(t * t * (3.0f - 2.0f * t)); // smoothstep
+}
+
+// Re-root the layout at n. Only the new focus subtree and its ancestor path are
+// laid out; the previously visible nodes are interpolated to their new places.
+static void refocus(Node* n) {
+    if (!n || n == g_focus) return;
+
+    captureTransitionStart();
+    g_focus = n;
+    relayoutVisible();
+    g_toPanX = g_toPanY = 0.0f;
+    startTransition();
+
+    if (g_selectedNode && nodeHidden(g_selectedNode)) g_selectedNode = nullptr;
+    g_hoverNode = nullptr;
+}
+
+static void animateFold(Node* n) {
+    captureTransitionStart();
+    setCollapsed(n, !n->collapsed);
+    relayoutVisible();
+    startTransition();
+}
+
+static void animateRadiusStep(float step) {
+    captureTransitionStart();
+    RADIUS_STEP = std::min(200.0f, std::max(8.0f, step));
+    relayoutVisible();
+    startTransition();
+}
+
+static void animateLinkStyle() {
+    captureTransitionStart();
+    LINKS_CURVED = !LINKS_CURVED;
+    startTransition();
+}
+
+// ---------------------------- Level of Detail ----------------------------
+
+// Per frame, a top-down pass over the visible preorder ranges decides what to
+// draw. A subtree whose annular sector is off-screen is skipped; one whose
+// outer arc is narrower than LOD_PX is replaced by a single shaded fan with
+// opacity growing with its leafCount. Either way only the subtree's own node
+// and incoming link are drawn, so the work follows what is on screen. The
+// results go to the ViewFrame of the view drawn.
+
+// Conservative: false only if the sector [r0, r1] x [a0, a1] is surely off
+// the rows drawn.
+static bool sectorOnScreen(const ScreenXform& X, float r0, float r1, float a0, float a1) {
+    if (a1 - a0 > 0.5f * float(M_PI)) return true;
+
+    float minX = 1e30f, minY = 1e30f, maxX = -1e30f, maxY = -1e30f;
+    auto add = [&](float r, float a) {
+        float sx, sy;
+        worldToScreen(X, std::cos(a) * r, std::sin(a) * r, sx, sy);
+        minX = std::min(minX, sx); maxX = std::max(maxX, sx);
+        minY = std::min(minY, sy); maxY = std::max(maxY, sy);
+    };
+    add(r0, a0); add(r0, a1); add(r1, a0); add(r1, a1);
+    add(r1 / std::cos(0.5f * (a1 - a0)), 0.5f * (a0 + a1)); // covers the outer arc's bulge
+
+    const float pad = 2.0f;
+    return maxX >= -pad && maxY >= float(X.y0) - pad && minX <= float(X.w) + pad && minY <= float(X.y1) + pad;
+}
+
+static void addAggregate(ViewFrame& f, const Node* n, float rOuter) {
+    float alpha = std::min(0.85f, 0.15f + 0.08f * std::log2(1.0f + float(n->leafCount)));
+    float am = 0.5f * (n->angle0 + n->angle1);
+    const float pts[3][2] = {
+        { std::cos(n->angle0) * rOuter, std::sin(n->angle0) * rOuter },
+        { std::cos(am) * rOuter,        std::sin(am) * rOuter },
+        { std::cos(n->angle1) * rOuter, std::sin(n->angle1) * rOuter },
+    };
+    for (int t = 0; t < 2; ++t) {
+        f.lodVerts.insert(f.lodVerts.end(), { n->x, n->y, pts[t][0], pts[t][1], pts[t + 1][0], pts[t + 1][1] });
+        for (int k = 0; k < 3; ++k)
+            f.lodColors.insert(f.lodColors.end(), { 0.45f, 0.45f, 0.45f, alpha });
+    }
+    ++f.lodAggregates;
+}
+
+// Semantic zoom: how many levels below the focus are drawn at a zoom.
+// Deeper subtrees are cut in the traversal below, so changing the limit
+// costs nothing beyond the frame that uses it.
+static int semanticDepthLimit(float zoom) {
+    if (!SEMANTIC_ZOOM) return INT32_MAX;
+    int extra = int(std::floor(std::log2(zoom) * SEMANTIC_LEVELS_PER_OCTAVE));
+    return std::max(1, SEMANTIC_BASE_DEPTH + extra);
+}
+
+static void computeLodRanges(ViewFrame& f) {
+    beginDrawnFrame(f);
+    f.lodRanges.clear();
+    f.lodVerts.clear();
+    f.lodColors.clear();
+    f.lodAggregates = 0;
+
+    // Mid-transition, wedges and positions disagree: only the depth cut applies.
+    bool sectors = !g_transitionActive;
+    int depthLimit = semanticDepthLimit(f.vp.zoom);
+
+    ScreenXform X = screenXform(f.vp);
+    for (const auto& r : g_visibleRanges) {
+        int start = r.first, i = r.first;
+        while (i < r.second) {
+            const Node* n = g_nodes[i];
+            f.drawn[i] = f.frameNo;
+            int end = std::min(n->subtreeEnd, r.second);
+
+            if (end > i + 1 && n->depth >= g_focus->depth && n != g_focus) {
+                float rOuter = n->radius + float(n->height) * RADIUS_STEP;
+                bool deep = n->depth - g_focus->depth >= depthLimit;
+                bool offScreen = sectors && !sectorOnScreen(X, n->radius, rOuter, n->angle0, n->angle1);
+                bool tiny = sectors && LOD_ENABLED && (n->angle1 - n->angle0) * rOuter * X.ppw < LOD_PX;
+                if (deep || offScreen || tiny) {
+                    if (sectors && !offScreen) addAggregate(f, n, rOuter);
+                    f.lodRanges.push_back({ start, i + 1 });
+                    i = start = end;
+                    continue;
+                }
+            }
+            ++i;
+        }
+        if (start < r.second) f.lodRanges.push_back({ start, r.second });
+    }
+}
+
+// Wedges standing in for the subtrees computeLodRanges() cut.
+static void drawLodAggregates(const ViewFrame& f) {
+    if (f.lodVerts.empty()) return;
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glEnableClientState(GL_COLOR_ARRAY);
+    glVertexPointer(2, GL_FLOAT, 0, f.lodVerts.data());
+    glColorPointer(4, GL_FLOAT, 0, f.lodColors.data());
+    glDrawArrays(GL_TRIANGLES, 0, GLsizei(f.lodVerts.size() / 2));
+    glDisableClientState(GL_COLOR_ARRAY);
+    glDisableClientState(GL_VERTEX_ARRAY);
+}
+
+static void drawFlatGeometry(ViewFrame& f) {
+    if (g_buffersDirty) fillRenderBuffers();
+    computeLodRanges(f);
+    drawLodAggregates(f);
+    drawBufferRanges(f.lodRanges, g_edgeVerts.data(), g_circleVerts.data());
+}
+
+// ---------------------------- Picking ----------------------------
+
+// Window pixel (GLUT, y down) -> world, undoing pan, zoom and g_rotDeg.
+static void screenToWorld(int mx, int my, float& wx, float& wy) {
+    ScreenXform X = currentScreenXform();
+    float vx = (float(mx) - X.ox) / X.ppw + g_panX;
+    float vy = (X.oy - float(my)) / X.ppw + g_panY;
+    wx =  X.c * vx + X.s * vy;
+    wy = -X.s * vx + X.c * vy;
+}
+
+// Node whose ring and angular wedge contain (wx, wy), or nullptr.
+// Siblings own contiguous wedges in increasing angle order (assignAngles), so
+// each level is a binary search over the children's wedge starts: O(depth * log k).
+static const Node* pickNode(float wx, float wy) {
+    const Node* n = g_focus;
+    if (!n) return nullptr;
+
+    float r = std::sqrt(wx*wx + wy*wy);
+    int ring = int(r / RADIUS_STEP + 0.5f);
+    if (!HYPERBOLIC_VIEW && ring > semanticDepthLimit(g_zoom)) return nullptr;
+
+    // Into the focus wedge's range [angle0, angle0 + 2pi)
+    float a = std::atan2(wy, wx);
+    while (a < n->angle0) a += 2.0f * float(M_PI);
+
+    float backStep = FOCUS_BACK_STEP * RADIUS_STEP;
+    if (n->parent && a >= n->angle1 && r >= 0.5f * backStep) {
+        // Back wedge: the ancestor path
+        int k = int(r / backStep + 0.5f);
+        const Node* anc = n;
+        for (int i = 0; i < k && anc; ++i) anc = anc->parent;
+        return anc;
+    }
+
+    for (int d = 0; d < ring; ++d) {
+        const auto& kids = n->children;
+        if (kids.empty() || n->collapsed) return nullptr;
+
+        auto it = std::upper_bound(kids.begin(), kids.end(), a,
+                                   [](float v, const std::unique_ptr<Node>& ch) { return v < ch->angle0; });
+        if (it == kids.begin()) return nullptr;
+        const Node* ch = (it - 1)->get();
+        if (a >= ch->angle1) return nullptr;
+        n = ch;
+    }
+    return n;
+}
+
+static const Node* pickNodeAtPixel(int mx, int my) {
+    float wx, wy;
+    screenToWorld(mx, my, wx, wy);
+    if (HYPERBOLIC_VIEW && !hyperbolicUnproject(wx, wy, wx, wy)) return nullptr;
+    return pickNode(wx, wy);
+}
+
+static void printNodeInfo(const Node* n) {
+    std::printf("Selected: \"%s\" (id=%s, depth=%d, leaves=%d, children=%zu)\n",
+                n->text.c_str(), n->id.c_str(), n->depth, n->leafCount, n->children.size());
+    std::fflush(stdout);
+}
+
+// ---------------------------- Highlight Drawing ----------------------------
+
+static std::vector<float> g_highlightVerts; // selection path links, linkStride() xy pairs each
+
+static void drawHighlights() {
+    // Selection: path from the root plus an enlarged endpoint. The links are
+    // generated like their slots, so each one lies on the link it marks.
+    if (g_selectedNode) {
+        int stride = linkStride();
+        size_t links = 0;
+        for (const Node* n = g_selectedNode; n->parent; n = n->parent) ++links;
+        g_highlightVerts.resize(links * size_t(stride) * 2);
+        size_t k = 0;
+        for (const Node* n = g_selectedNode; n->parent; n = n->parent, ++k)
+            writeNodeLink(n, &g_highlightVerts[k * size_t(stride) * 2], stride);
+
+        glColor4f(0.90f, 0.45f, 0.05f, 0.95f);
+        glLineWidth(2.5f);
+        glEnableClientState(GL_VERTEX_ARRAY);
+        glVertexPointer(2, GL_FLOAT, 0, g_highlightVerts.data());
+        for (k = 0; k < links; ++k) glDrawArrays(GL_LINE_STRIP, GLint(k * size_t(stride)), stride);
+        glDisableClientState(GL_VERTEX_ARRAY);
+        glLineWidth(1.0f);
+        float x, y;
+        drawnPosition(g_selectedNode, x, y);
+        drawFilledCircle(x, y, 3.0f * ENDPOINT_RADIUS, CIRCLE_SEGS);
+    }
+
+    // Hover: ring around the node under the cursor
+    if (g_hoverNode) {
+        glColor4f(0.10f, 0.40f, 0.90f, 0.90f);
+        glLineWidth(2.0f);
+        glBegin(GL_LINE_LOOP);
+        float r = 4.0f * ENDPOINT_RADIUS, x, y;
+        drawnPosition(g_hoverNode, x, y);
+        for (int i = 0; i < CIRCLE_SEGS; ++i) {
+            float a = (2.0f * float(M_PI)) * (float(i) / float(CIRCLE_SEGS));
+            glVertex2f(x + std::cos(a) * r, y + std::sin(a) * r);
+        }
+        glEnd();
+        glLineWidth(1.0f);
+    }
+}
+
+// ---------------------------- Search ----------------------------
+
+// Trigram index over the case-folded labels. Trigrams are hashed into
+// 2^SEARCH_HASH_BITS buckets with CSR posting lists of node indices; bucket
+// collisions only add candidates, which are verified against the label arena.
+struct SearchIndex {
+    std::vector<const Node*> nodes;     // preorder
+    std::string arena;                  // folded labels, each followed by '\0'
+    std::vector<uint32_t> labelStart;   // per node offset into arena (+1 sentinel)
+    std::vector<uint32_t> bucketStart;  // per bucket offset into postings (+1 sentinel)
+    std::vector<uint32_t> postings;     // node indices, ascending per bucket
+};
+
+static SearchIndex g_search;
+
+// A hit and its ranking key, computed once per query: exact label match,
+// then prefix match (bits 62-63), then shallow depth (32-61), then large
+// subtrees (0-31, inverted); ties in preorder.
+struct SearchHit {
+    uint64_t key;
+    uint32_t node;                           // index into g_search.nodes
+    bool operator<(const SearchHit& o) const {
+        return key != o.key ? key < o.key : node < o.node;
+    }
+};
+
+// Incremental search state
+static bool g_searchMode = false;
+static std::string g_searchQuery;
+static std::string g_searchMatchedQuery;     // query g_searchHits corresponds to
+static std::vector<SearchHit> g_searchHits;  // [0, g_searchRanked) best match first, the rest unordered
+static size_t g_searchRanked = 0;
+static size_t g_searchCursor = 0;
+
+static char foldChar(char c) {
+    return (c >= 'A' && c <= 'Z') ? char(c - 'A' + 'a') : c;
+}
+
+static uint32_t trigramBucket(const char* t) {
+    uint32_t k = (uint32_t((unsigned char)t[0]) << 16) |
+                 (uint32_t((unsigned char)t[1]) << 8)  |
+                  uint32_t((unsigned char)t[2]);
+    return (k * 2654435761u) >> (32 - SEARCH_HASH_BITS);
+}
+
+static void collectSearchNodes(const Node* n) {
+    g_search.labelStart.push_back(uint32_t(g_search.arena.size()));
+    g_search.nodes.push_back(n);
+    for (char c : n->text) g_search.arena.push_back(foldChar(c));
+    g_search.arena.push_back('\0');
+    for (const auto& ch : n->children) collectSearchNodes(ch.get());
+}
+
+static void buildSearchIndex() {
+    auto t0 = std::chrono::steady_clock::now();
+
+    SearchIndex& S = g_search;
+    S = SearchIndex();
+    collectSearchNodes(g_root.get());
+    S.labelStart.push_back(uint32_t(S.arena.size()));
+
+    const uint32_t nBuckets = 1u << SEARCH_HASH_BITS;
+    const uint32_t nNodes = uint32_t(S.nodes.size());
+    std::vector<uint32_t> lastNode(nBuckets, UINT32_MAX); // dedupe a bucket within one label
+    S.bucketStart.assign(nBuckets + 1, 0);
+
+    auto forEachBucket = [&](auto&& fn) {
+        std::fill(lastNode.begin(), lastNode.end(), UINT32_MAX);
+        for (uint32_t i = 0; i < nNodes; ++i) {
+            uint32_t b0 = S.labelStart[i], len = S.labelStart[i + 1] - b0 - 1;
+            for (uint32_t j = 0; j + 3 <= len; ++j) {
+                uint32_t b = trigramBucket(&S.arena[b0 + j]);
+                if (lastNode[b] == i) continue;
+                lastNode[b] = i;
+                fn(b, i);
+            }
+        }
+    };
+
+    // Count, prefix-sum, fill. Nodes are visited in order, so lists come out sorted.
+    forEachBucket([&](uint32_t b, uint32_t) { ++S.bucketStart[b + 1]; });
+    for (uint32_t b = 0; b < nBuckets; ++b) S.bucketStart[b + 1] += S.bucketStart[b];
+    S.postings.resize(S.bucketStart[nBuckets]);
+    std::vector<uint32_t> fill(S.bucketStart.begin(), S.bucketStart.end() - 1);
+    forEachBucket([&](uint32_t b, uint32_t i) { S.postings[fill[b]++] = i; });
+
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    size_t bytes = S.nodes.size() * sizeof(const Node*) + S.arena.size() +
+                   S.labelStart.size() * 4 + S.bucketStart.size() * 4 + S.postings.size() * 4;
+    std::printf("Search index: %zu labels, %zu postings, %.1f MB, built in %.1f ms\n",
+                S.nodes.size(), S.postings.size(), double(bytes) / (1024.0 * 1024.0), ms);
+}
+
+static bool labelContains(uint32_t i, const std::string& q) {
+    const char* b = g_search.arena.data() + g_search.labelStart[i];
+    return std::strstr(b, q.c_str()) != nullptr;
+}
+
+// Key every hit for query q (node set already in g_searchHits).
+static void keySearchHits(const std::string& q) {
+    for (SearchHit& h : g_searchHits) {
+        const char* b = g_search.arena.data() + g_search.labelStart[h.node];
+        size_t len = g_search.labelStart[h.node + 1] - g_search.labelStart[h.node] - 1;
+        uint64_t rank = (len == q.size() && std::memcmp(b, q.data(), len) == 0) ? 0
+                      : (std::strncmp(b, q.c_str(), q.size()) == 0)              ? 1 : 2;
+        const Node* n = g_search.nodes[h.node];
+        uint64_t depth = std::min<uint64_t>(uint64_t(n->depth), (1u << 30) - 1);
+        h.key = (rank << 62) | (depth << 32) | uint64_t(UINT32_MAX - uint32_t(n->leafCount));
+    }
+    g_searchRanked = 0;
+}
+
+// Order the hits up to (at least) position k, SEARCH_MAX_MARKS at a time:
+// a short query on a large map can match most labels, and only the marked
+// ones and those Enter has cycled to need an order.
+static void rankSearchHits(size_t k) {
+    size_t chunk = size_t(std::max(1, SEARCH_MAX_MARKS));
+    while (g_searchRanked <= k && g_searchRanked < g_searchHits.size()) {
+        auto b = g_searchHits.begin() + ptrdiff_t(g_searchRanked);
+        auto e = b + ptrdiff_t(std::min(chunk, g_searchHits.size() - g_searchRanked));
+        std::nth_element(b, e - 1, g_searchHits.end());
+        std::sort(b, e);
+        g_searchRanked += size_t(e - b);
+    }
+}
+
+static void runSearch() {
+    std::string q;
+    for (char c : g_searchQuery) q.push_back(foldChar(c));
+
+    if (q.empty()) {
+        g_searchHits.clear();
+    } else if (!g_searchMatchedQuery.empty() && q.find(g_searchMatchedQuery) != std::string::npos) {
+        // Query grew around the previous one: hits can only shrink.
+        std::vector<SearchHit> kept;
+        for (const SearchHit& h : g_searchHits) if (labelContains(h.node, q)) kept.push_back(h);
+        g_searchHits.swap(kept);
+    } else if (q.size() < 3) {
+        // Too short for trigrams: one scan over the arena.
+        g_searchHits.clear();
+        const std::string& A = g_search.arena;
+        for (size_t pos = A.find(q); pos != std::string::npos; ) {
+            auto it = std::upper_bound(g_search.labelStart.begin(), g_search.labelStart.end(), uint32_t(pos));
+            uint32_t i = uint32_t(it - g_search.labelStart.begin()) - 1;
+            g_searchHits.push_back({ 0, i });
+            pos = A.find(q, g_search.labelStart[i + 1]);
+        }
+    } else {
+        // Intersect the query's trigram buckets, smallest list first, then verify.
+        std::vector<uint32_t> buckets;
+        for (size_t j = 0; j + 3 <= q.size(); ++j) buckets.push_back(trigramBucket(&q[j]));
+        std::sort(buckets.begin(), buckets.end());
+        buckets.erase(std::unique(buckets.begin(), buckets.end()), buckets.end());
+        std::sort(buckets.begin(), buckets.end(), [](uint32_t a, uint32_t b) {
+            return g_search.bucketStart[a + 1] - g_search.bucketStart[a] <
+                   g_search.bucketStart[b + 1] - g_search.bucketStart[b];
+        });
+
+        const uint32_t* P = g_search.postings.data();
+        g_searchHits.clear();
+        for (uint32_t k = g_search.bucketStart[buckets[0]]; k < g_search.bucketStart[buckets[0] + 1]; ++k) {
+            uint32_t i = P[k];
+            bool inAll = true;
+            for (size_t b = 1; b < buckets.size() && inAll; ++b)
+                inAll = std::binary_search(P + g_search.bucketStart[buckets[b]],
+                                           P + g_search.bucketStart[buckets[b] + 1], i);
+            if (inAll && labelContains(i, q)) g_searchHits.push_back({ 0, i });
+        }
+    }
+
+    g_searchMatchedQuery = q;
+    keySearchHits(q);
+    rankSearchHits(0);
+    g_searchCursor = 0;
+}
+
+// Center the view on a node (undoing g_rotDeg) and zoom in if needed.
+static void focusNode(const Node* n) {
+    if (HYPERBOLIC_VIEW) {
+        hyperbolicFocusOn(n->x, n->y);
+        return;
+    }
+    float rot = degreesToRadians(g_rotDeg);
+    g_panX = std::cos(rot) * n->x - std::sin(rot) * n->y;
+    g_panY = std::sin(rot) * n->x + std::cos(rot) * n->y;
+    g_zoom = std::min(20.0f, std::max(g_zoom, SEARCH_FOCUS_ZOOM));
+}
+
+static void focusSearchHit() {
+    if (g_searchHits.empty()) return;
+    rankSearchHits(g_searchCursor);
+    const Node* n = g_search.nodes[g_searchHits[g_searchCursor].node];
+
+    // Re-center on the root and unfold collapsed ancestors so the hit is on screen.
+    if (nodeHidden(n)) {
+        finishTransition();
+        if (!inFocusSubtree(n)) g_focus = g_root.get();
+        for (Node* a = g_nodes[n->index]->parent; a; a = a->parent) setCollapsed(a, false);
+        relayoutVisible();
+        buildLabelCache();
+    }
+
+    g_selectedNode = n;
+    focusNode(n);
+}
+
+static void searchKey(unsigned char key) {
+    if (key == 27) {                         // ESC: leave search mode
+        g_searchMode = false;
+        g_searchQuery.clear();
+        g_searchMatchedQuery.clear();
+        g_searchHits.clear();
+        return;
+    }
+    if (key == 13 || key == '\n') {          // Enter: next match
+        if (!g_searchHits.empty()) {
+            g_searchCursor = (g_searchCursor + 1) % g_searchHits.size();
+            focusSearchHit();
+        }
+        return;
+    }
+    if (key == 8 || key == 127) {            // Backspace
+        if (g_searchQuery.empty()) return;
+        g_searchQuery.pop_back();
+        g_searchMatchedQuery.clear();
+    } else if (key >= 32 && key < 127) {
+        g_searchQuery.push_back(char(key));
+    } else {
+        return;
+    }
+
+    runSearch();
+    focusSearchHit();
+}
+
+static void drawSearchHits() {
+    if (g_searchHits.empty()) return;
+    glColor4f(0.95f, 0.75f, 0.05f, 0.85f);
+    size_t n = std::min(g_searchHits.size(), size_t(SEARCH_MAX_MARKS));
+    for (size_t k = 0; k < n; ++k) {
+        const Node* h = g_search.nodes[g_searchHits[k].node];
+        if (nodeHidden(h)) continue;
+        float x, y;
+        drawnPosition(h, x, y);
+        drawFilledCircle(x, y, 2.5f * ENDPOINT_RADIUS, CIRCLE_SEGS);
+    }
+}
+
+// Query line in window pixels (bottom-left).
+static void drawSearchOverlay() {
+    if (!g_searchMode) return;
+
+    glMatrixMode(GL_PROJECTION);
+    glPushMatrix();
+    glLoadIdentity();
+    glOrtho(0, g_winW, 0, g_winH, -1, 1);
+    glMatrixMode(GL_MODELVIEW);
+    glPushMatrix();
+    glLoadIdentity();
+
+    char status[64];
+    if (g_searchHits.empty()) std::snprintf(status, sizeof(status), "   (no match)");
+    else std::snprintf(status, sizeof(status), "   (%zu/%zu)", g_searchCursor + 1, g_searchHits.size());
+    std::string line = "/" + g_searchQuery + "_" + (g_searchQuery.empty() ? "" : status);
+
+    glColor4f(0.10f, 0.10f, 0.10f, 1.0f);
+    glRasterPos2f(10.0f, 10.0f);
+    for (unsigned char c : line) glutBitmapCharacter(GLUT_BITMAP_HELVETICA_18, c);
+
+    glPopMatrix();
+    glMatrixMode(GL_PROJECTION);
+    glPopMatrix();
+    glMatrixMode(GL_MODELVIEW);
+}
+
+// ---------------------------- Reload ----------------------------
+
+// Re-read g_mapPath and animate from the old layout: nodes are matched by
+// Node::id; new nodes grow out of their parent, removed nodes just vanish.
+static void reloadMap() {
+    std::vector<std::pair<std::string, std::pair<float, float>>> prev;
+    for (const auto& r : g_visibleRanges)
+        for (int i = r.first; i < r.second; ++i)
+            prev.push_back({ g_nodes[i]->id, { g_transitionActive ? g_lerpAngle[i] : g_nodes[i]->angle,
+                                               g_transitionActive ? g_lerpRadius[i] : g_nodes[i]->radius } });
+    std::sort(prev.begin(), prev.end());
+
+    g_autoId = 1; // keep generated IDs stable across reloads
+    auto fresh = loadFreeMind(g_mapPath, g_autoId);
+    if (!fresh) return;
+
+    g_transitionActive = false;
+    g_selectedNode = g_hoverNode = nullptr;
+    g_searchMode = false;
+    g_searchHits.clear();
+
+    g_root = std::move(fresh);
+    computeLayout();
+    cacheLabelWidths(g_root.get());
+    buildSearchIndex();
+
+    // Start state: matched nodes at their old place, the rest grow out of their parent.
+    std::vector<std::pair<int, int>> target = g_visibleRanges;
+    g_visibleRanges.clear(); // nothing of the new tree is on screen yet
+    captureTransitionStart();
+    g_visibleRanges = target;
+    for (const auto& r : target) {
+        for (int i = r.first; i < r.second; ++i) {
+            auto it = std::lower_bound(prev.begin(), prev.end(), g_nodes[i]->id,
+                                       [](const std::pair<std::string, std::pair<float, float>>& e,
+                                          const std::string& id) { return e.first < id; });
+            if (it == prev.end() || it->first != g_nodes[i]->id) continue;
+            g_fromAngle[i] = it->second.first;
+            g_fromRadius[i] = it->second.second;
+            g_visStamp[i] = g_fromGeneration;
+        }
+    }
+    startTransition();
+}
+
+// ---------------------------- Export ----------------------------
+
+// Base name of the map file plus suffix, in the working directory.
+static std::string mapOutputPath(const std::string& suffix) {
+    std::string path = g_mapPath;
+    size_t slash = path.find_last_of('/');
+    if (slash != std::string::npos) path.erase(0, slash + 1);
+    size_t dot = path.find_last_of('.');
+    if (dot != std::string::npos && dot > 0) path.resize(dot);
+    return path + suffix;
+}
+
+// The whole visible layout (no culling, LOD or decluttering) as the viewer
+// would draw it at the current rotation, link style and label settings.
+static void exportViewSvg() {
+    std::string path = mapOutputPath(".svg");
+
+    SvgOptions opt;
+    opt.radiusStep = RADIUS_STEP;
+    opt.curved = LINKS_CURVED;
+    opt.endpointRadius = ENDPOINT_RADIUS;
+    opt.leavesOnly = LABEL_LEAVES_ONLY;
+    opt.labelScale = labelScale(windowViewport());
+    opt.labelPad = LABEL_RADIAL_PAD;
+    opt.rotDeg = g_rotDeg;
+
+    auto t0 = std::chrono::steady_clock::now();
+    if (!exportSvg(path.c_str(), g_nodes, g_visibleRanges, g_focus, opt)) return;
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    std::printf("Exported %zu nodes to %s (%.0f ms)\n", rangeSlotCount(g_visibleRanges), path.c_str(), ms);
+}
+
+// ---------------------------- Progressive Rendering ----------------------------
+
+// The flat view is drawn over several frames when it does not fit the budget:
+// links, then circles, then labels, each shallow depth first, into a texture
+// attached to an offscreen framebuffer (g_progFbo). Every frame adds to that
+// image where the last one stopped and shows it in the window; the window's
+// own pixels are never read back. Any change of the view or the scene
+// restarts the pass, so input is handled between bounded frames. Screenshots
+// run the same pass over their own ViewFrames, in either view.
+static bool g_progRestart = true;        // set by input handlers and scene changes
+static std::vector<GLint> g_progFirst;
+static std::vector<GLsizei> g_progCount;
+static GLuint g_progFbo = 0, g_progTex = 0;
+static int g_progTexW = 0, g_progTexH = 0;
+
+static void invalidateProgressive() {
+    g_progRestart = true;
+}
+
+// Labels [b, e) in priority order, placed for the view f draws.
+static void declutterLabelRange(ViewFrame& f, size_t b, size_t e) {
+    if (f.vp.hyperbolic) declutterHyperbolicRange(f, b, e);
+    else                 declutterRange(f, b, e);
+}
+
+// Cull (or project) f.vp and order the drawn slots for stepProgressivePass().
+static void beginProgressivePass(ViewFrame& f) {
+    if (g_buffersDirty) fillRenderBuffers();
+    if (f.vp.hyperbolic) projectHyperbolic(f);
+    else                 computeLodRanges(f);
+    syncLabelFlips();
+    const std::vector<std::pair<int, int>>& ranges = f.vp.hyperbolic ? f.hypRanges : f.lodRanges;
+
+    // Counting sort of the drawn slots by depth (stable, so preorder within a level).
+    int maxDepth = 0;
+    for (const auto& r : ranges)
+        for (int i = r.first; i < r.second; ++i) maxDepth = std::max(maxDepth, g_nodes[i]->depth);
+    std::vector<int> start(size_t(maxDepth) + 2, 0);
+    for (const auto& r : ranges)
+        for (int i = r.first; i < r.second; ++i) ++start[size_t(g_nodes[i]->depth) + 1];
+    for (size_t d = 1; d < start.size(); ++d) start[d] += start[d - 1];
+    f.slots.resize(size_t(start.back()));
+    for (const auto& r : ranges)
+        for (int i = r.first; i < r.second; ++i) f.slots[size_t(start[size_t(g_nodes[i]->depth)]++)] = i;
+
+    f.stage = PROG_LINKS;
+    f.cursor = 0;
+}
+
+// Links or circles for f.slots[b, e).
+static void drawSlotChunk(const ViewFrame& f, size_t b, size_t e, bool links) {
+    g_progFirst.clear();
+    g_progCount.clear();
+    for (size_t k = b; k < e; ++k) {
+        int i = f.slots[k];
+        if (links && i == 0) continue; // root has no incoming link
+        g_progFirst.push_back(links ? g_edgeFirst[i] : g_circleFirst[i]);
+        g_progCount.push_back(links ? g_edgeCount[i] : g_circleCount[i]);
+    }
+    if (g_progFirst.empty()) return;
+
+    glEnableClientState(GL_VERTEX_ARRAY);
+    if (links) {
+        glColor4f(0.45f, 0.45f, 0.45f, 0.55f);
+        glLineWidth(1.0f);
+        glVertexPointer(2, GL_FLOAT, 0, f.vp.hyperbolic ? f.hypEdgeVerts.data() : g_edgeVerts.data());
+        glMultiDrawArrays(GL_LINE_STRIP, g_progFirst.data(), g_progCount.data(), GLsizei(g_progFirst.size()));
+    } else {
+        glColor4f(0.30f, 0.30f, 0.30f, 0.95f);
+        glVertexPointer(2, GL_FLOAT, 0, f.vp.hyperbolic ? f.hypCircleVerts.data() : g_circleVerts.data());
+        glMultiDrawArrays(GL_TRIANGLE_FAN, g_progFirst.data(), g_progCount.data(), GLsizei(g_progFirst.size()));
+    }
+    glDisableClientState(GL_VERTEX_ARRAY);
+}
+
+// Continue f's pass until it is done or budgetMs is spent.
+static void stepProgressivePass(ViewFrame& f, float budgetMs) {
+    auto t0 = std::chrono::steady_clock::now();
+    auto spent = [&]() {
+        return std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - t0).count() >= budgetMs;
+    };
+    size_t chunk = size_t(std::max(16, PROGRESSIVE_CHUNK));
+
+    // At least one chunk per frame, so even a tiny budget makes progress.
+    do {
+        switch (f.stage) {
+        case PROG_LINKS:
+        case PROG_CIRCLES: {
+            bool links = (f.stage == PROG_LINKS);
+            if (links && f.cursor == 0) {
+                if (f.vp.hyperbolic) drawHyperbolicDisk();
+                else                 drawLodAggregates(f);
+            }
+            size_t e = std::min(f.slots.size(), f.cursor + chunk);
+            drawSlotChunk(f, f.cursor, e, links);
+            f.cursor = e;
+            if (e == f.slots.size()) {
+                f.cursor = 0;
+                if (links) {
+                    f.stage = PROG_CIRCLES;
+                } else {
+                    if (f.vp.hyperbolic) drawHyperbolicMarkers(f.vp);
+                    if (!f.prePlaced) resetDeclutterGrid(f);
+                    f.stage = f.prePlaced ? PROG_LABELS : PROG_PLACE;
+                }
+            }
+            break;
+        }
+        case PROG_PLACE: {
+            // Root, then the cached labels in priority order.
+            size_t total = g_labelOrder.size() + 1;
+            size_t e = std::min(total, f.cursor + chunk);
+            declutterLabelRange(f, f.cursor, e);
+            f.cursor = e;
+            if (e == total) {
+                f.cursor = 0;
+                f.stage = PROG_LABELS;
+            }
+            break;
+        }
+        case PROG_LABELS: {
+            // One at a time: a label's cost grows with its size in pixels.
+            glColor4f(0.10f, 0.10f, 0.10f, 1.0f);
+            if (f.cursor < f.placed.size()) drawPlacedLabel(f.placed[f.cursor++]);
+            if (f.cursor == f.placed.size()) f.stage = PROG_DONE;
+            break;
+        }
+        case PROG_DONE:
+            break;
+        }
+    } while (f.stage != PROG_DONE && !spent());
+}
+
+static void drawWindowQuad(float u, float v) {
+    glMatrixMode(GL_PROJECTION);
+    glPushMatrix();
+    glLoadIdentity();
+    glOrtho(0, g_winW, 0, g_winH, -1, 1);
+    glMatrixMode(GL_MODELVIEW);
+    glPushMatrix();
+    glLoadIdentity();
+
+    glBegin(GL_QUADS);
+    glTexCoord2f(0, 0); glVertex2f(0, 0);
+    glTexCoord2f(u, 0); glVertex2f(float(g_winW), 0);
+    glTexCoord2f(u, v); glVertex2f(float(g_winW), float(g_winH));
+    glTexCoord2f(0, v); glVertex2f(0, float(g_winH));
+    glEnd();
+
+    glPopMatrix();
+    glMatrixMode(GL_PROJECTION);
+    glPopMatrix();
+    glMatrixMode(GL_MODELVIEW);
+}
+
+// Bind g_progFbo, its texture grown to the window size as needed, for
+// drawing. False if the framebuffer cannot be made complete.
+static bool bindProgressTarget() {
+    if (!g_progFbo) {
+        glGenFramebuffers(1, &g_progFbo);
+        glGenTextures(1, &g_progTex);
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, g_progFbo);
+    if (g_progTexW < g_winW || g_progTexH < g_winH) {
+        g_progTexW = std::max(g_progTexW, g_winW);
+        g_progTexH = std::max(g_progTexH, g_winH);
+        glBindTexture(GL_TEXTURE_2D, g_progTex);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, g_progTexW, g_progTexH, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        glBindTexture(GL_TEXTURE_2D, 0);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, g_progTex, 0);
+    }
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        return false;
+    }
+    glViewport(0, 0, g_winW, g_winH);
+    return true;
+}
+
+// The pass so far, into the window.
+static void showProgressImage() {
+    glBindTexture(GL_TEXTURE_2D, g_progTex);
+    glEnable(GL_TEXTURE_2D);
+    glDisable(GL_BLEND);
+    glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_REPLACE);
+    drawWindowQuad(float(g_winW) / float(g_progTexW), float(g_winH) / float(g_progTexH));
+    glEnable(GL_BLEND);
+    glDisable(GL_TEXTURE_2D);
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+static void drawProgressive(const Viewport& vp) {
+    ViewFrame& f = g_windowFrame;
+    // Mid-transition every frame differs anyway: restart each time.
+    bool restart = g_progRestart || g_transitionActive || g_buffersDirty || !(vp == f.vp);
+
+    if (restart || f.stage != PROG_DONE) {
+        f.vp = vp;
+        if (!bindProgressTarget()) {
+            std::fprintf(stderr, "Progressive rendering: no offscreen framebuffer, turned off\n");
+            PROGRESSIVE_RENDER = false;
+            drawFlatGeometry(f);
+            drawSearchHits();
+            drawHighlights();
+            drawLabels(f);
+            return;
+        }
+        if (restart) {
+            beginProgressivePass(f);
+            g_progRestart = false;
+            glClear(GL_COLOR_BUFFER_BIT);
+        }
+        stepProgressivePass(f, PROGRESSIVE_BUDGET_MS);
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        glViewport(0, 0, g_winW, g_winH);
+    }
+    showProgressImage();
+
+    drawSearchHits();
+    drawHighlights();
+
+    if (f.stage != PROG_DONE) glutPostRedisplay();
+}
+
+// ---------------------------- Layout Progress ----------------------------
+
+// Drawn instead of the map while it loads or the time-sliced layout runs: the
+// nodes placed so far from the retained buffers (slots are filled as they are
+// placed), placeholder wedges for the subtrees still waiting, and a status line.
+// A pass after the first draws over the picture of the previous one.
+static size_t g_layoutGeomDone = 0;  // slots of the current pass with geometry
+static size_t g_layoutGeomHigh = 0;  // slots with geometry from any pass
+static int g_layoutGeomPass = 0;
+
+static bool mapBusy() {
+    return g_loading || layoutPending();
+}
+
+static void drawPlaceholderWedge(const Node* n) {
+    float r0 = std::max(0.0f, n->radius - 0.5f * RADIUS_STEP);
+    float r1 = (float(n->depth + n->height) + 0.5f) * RADIUS_STEP;
+    int segs = std::max(1, std::min(64, int((n->angle1 - n->angle0) * 32.0f)));
+    glBegin(GL_TRIANGLE_STRIP);
+    for (int k = 0; k <= segs; ++k) {
+        float a = n->angle0 + (n->angle1 - n->angle0) * (float(k) / float(segs));
+        glVertex2f(std::cos(a) * r0, std::sin(a) * r0);
+        glVertex2f(std::cos(a) * r1, std::sin(a) * r1);
+    }
+    glEnd();
+}
+
+static void drawLayoutProgress() {
+    const LayoutJob& J = g_layoutJob;
+    if (J.stage == LAYOUT_PLACE || J.stage == LAYOUT_FINISH) {
+        if (J.pass != g_layoutGeomPass) {
+            g_layoutGeomPass = J.pass;
+            g_layoutGeomDone = 0;
+            allocRenderBuffers();
+        }
+        for (const auto& r : g_visibleRanges)
+            for (int i = std::max(r.first, int(g_layoutGeomDone)); i < r.second; ++i) writeNodeGeometry(i);
+        if (!g_visibleRanges.empty()) g_layoutGeomDone = size_t(g_visibleRanges.back().second);
+        g_layoutGeomHigh = std::max(g_layoutGeomHigh, g_layoutGeomDone);
+    }
+    if (g_layoutGeomHigh > 0)
+        drawBufferRanges({ { 0, int(g_layoutGeomHigh) } }, g_edgeVerts.data(), g_circleVerts.data());
+
+    if (J.stage == LAYOUT_PLACE) {
+        // Waiting subtrees: the next slot and, up its ancestor path, the later siblings.
+        if (J.cursor < g_nodes.size() && J.cursor >= g_layoutGeomHigh) {
+            glColor4f(0.45f, 0.45f, 0.45f, 0.15f);
+            const Node* n = g_nodes[J.cursor];
+            drawPlaceholderWedge(n);
+            for (; n->parent; n = n->parent) {
+                const auto& sib = n->parent->children;
+                for (size_t k = sib.size(); k-- > 0 && sib[k].get() != n; ) drawPlaceholderWedge(sib[k].get());
+            }
+        }
+    }
+
+    static const char* stageNames[] = { "indexing", "counting leaves", "placing", "finishing", "done" };
+    size_t done = (J.stage == LAYOUT_INDEX)  ? g_nodes.size()
+                : (J.stage == LAYOUT_LEAVES) ? g_nodes.size() - J.cursor
+                : J.cursor;
+    char line[96];
+    if (g_loading)
+        std::snprintf(line, sizeof(line), "Loading: %zu nodes", g_loadedNodes);
+    else
+        std::snprintf(line, sizeof(line), "Layout: %s %zu nodes", stageNames[J.stage], done);
+
+    glMatrixMode(GL_PROJECTION);
+    glPushMatrix();
+    glLoadIdentity();
+    glOrtho(0, g_winW, 0, g_winH, -1, 1);
+    glMatrixMode(GL_MODELVIEW);
+    glPushMatrix();
+    glLoadIdentity();
+
+    glColor4f(0.10f, 0.10f, 0.10f, 1.0f);
+    glRasterPos2f(10.0f, 10.0f);
+    for (const char* c = line; *c; ++c) glutBitmapCharacter(GLUT_BITMAP_HELVETICA_18, *c);
+
+    glPopMatrix();
+    glMatrixMode(GL_PROJECTION);
+    glPopMatrix();
+    glMatrixMode(GL_MODELVIEW);
+}
+
+// ---------------------------- Tile Pyramid ----------------------------
+
+// With a tile pyramid of the map (radialcli -f tiles: <map>.tiles/ next to
+// the map or in the working directory), the overview zoom levels are drawn
+// from its raster tiles instead of the geometry: the frame costs the same for
+// any map size. Tiles are read and decoded by loader threads, uploaded a few
+// per frame and kept in an LRU cache of textures; a tile not loaded yet is
+// stood in for by the part of its nearest loaded ancestor. Beyond the deepest
+// level, or once the layout no longer matches the one the tiles show (folds,
+// refocus, ring spacing, link style, rotation), the map is drawn live again.
+struct TileTexture {
+    GLuint tex = 0;                      // 0: nothing drawn on this tile
+    std::list<uint64_t>::iterator lru;
+};
+
+struct DecodedTile {
+    uint64_t key;
+    int w = 0, h = 0;
+    std::vector<uint8_t> rgba;           // empty: blank tile (no file)
+};
+
+static TilePyramid g_pyramid;
+static std::string g_pyramidDir;         // empty: no pyramid
+static std::unordered_map<uint64_t, TileTexture> g_tileCache;
+static std::list<uint64_t> g_tileLru;    // most recently drawn first
+
+// Main thread -> loaders: the tiles wanted now, most important first
+// (replaced every frame). Loaders -> main thread: decoded tiles. A key stays
+// in g_tileBusy from the request until its texture exists.
+static std::mutex g_tileLock;
+static std::condition_variable g_tileWake;
+static std::deque<uint64_t> g_tileRequests;
+static std::unordered_set<uint64_t> g_tileBusy;
+static std::vector<DecodedTile> g_tileDone;
+static std::atomic<bool> g_tilesArrived{false};
+static bool g_tileStop = false;
+static std::vector<std::thread> g_tileLoaders;
+
+static uint64_t tileKey(int z, int x, int y) {
+    return uint64_t(z) << 48 | uint64_t(x) << 24 | uint64_t(y);
+}
+
+static void openTilePyramid() {
+    std::string path = g_mapPath;
+    size_t slash = path.find_last_of('/');
+    size_t dot = path.find_last_of('.');
+    if (dot != std::string::npos && (slash == std::string::npos || dot > slash + 1)) path.resize(dot);
+    for (const std::string& dir : { path + ".tiles", mapOutputPath(".tiles") }) {
+        if (readTilePyramid(dir, g_pyramid)) {
+            g_pyramidDir = dir;
+            std::printf("Tile pyramid: %s (%d levels of %d px tiles)\n",
+                        dir.c_str(), g_pyramid.levels, g_pyramid.tileSize);
+            return;
+        }
+    }
+}
+
+static void tileLoaderMain() {
+    std::unique_lock<std::mutex> lock(g_tileLock);
+    for (;;) {
+        g_tileWake.wait(lock, [] { return g_tileStop || !g_tileRequests.empty(); });
+        if (g_tileStop) return;
+        uint64_t key = g_tileRequests.front();
+        g_tileRequests.pop_front();
+        lock.unlock();
+
+        DecodedTile t;
+        t.key = key;
+        int z = int(key >> 48), x = int((key >> 24) & 0xFFFFFF), y = int(key & 0xFFFFFF);
+        if (!readPng(tilePyramidPath(g_pyramidDir, z, x, y).c_str(), t.w, t.h, t.rgba)) t.rgba.clear();
+
+        lock.lock();
+        g_tileDone.push_back(std::move(t));
+        g_tilesArrived.store(true, std::memory_order_release);
+    }
+}
+
+static void stopTileLoaders() {
+    {
+        std::lock_guard<std::mutex> guard(g_tileLock);
+        g_tileStop = true;
+    }
+    g_tileWake.notify_all();
+    for (auto& t : g_tileLoaders) t.join();
+    g_tileLoaders.clear();
+}
+
+// Hand the wanted tiles that are neither cached nor on their way to the
+// loaders; requests from earlier frames that were not started are dropped.
+static void requestTiles(const std::vector<uint64_t>& wanted) {
+    if (g_tileLoaders.empty()) {
+        for (int i = 0; i < std::max(1, TILE_LOADERS); ++i) g_tileLoaders.emplace_back(tileLoaderMain);
+        std::atexit(stopTileLoaders);
+    }
+    {
+        std::lock_guard<std::mutex> guard(g_tileLock);
+        for (uint64_t key : g_tileRequests) g_tileBusy.erase(key);
+        g_tileRequests.clear();
+        for (uint64_t key : wanted) {
+            if (g_tileCache.count(key) || !g_tileBusy.insert(key).second) continue;
+            g_tileRequests.push_back(key);
+        }
+    }
+    g_tileWake.notify_all();
+}
+
+// Create textures for up to TILE_UPLOADS_PER_FRAME decoded tiles, then trim
+// the cache to its capacity (never below what this frame draws).
+static void uploadTiles(size_t drawn) {
+    std::vector<DecodedTile> done;
+    {
+        std::lock_guard<std::mutex> guard(g_tileLock);
+        size_t n = std::min(g_tileDone.size(), size_t(std::max(1, TILE_UPLOADS_PER_FRAME)));
+        done.assign(std::make_move_iterator(g_tileDone.begin()), std::make_move_iterator(g_tileDone.begin() + n));
+        g_tileDone.erase(g_tileDone.begin(), g_tileDone.begin() + n);
+        for (const DecodedTile& t : done) g_tileBusy.erase(t.key);
+        g_tilesArrived.store(!g_tileDone.empty(), std::memory_order_relaxed);
+    }
+
+    for (const DecodedTile& t : done) {
+        if (g_tileCache.count(t.key)) continue;
+        TileTexture& e = g_tileCache[t.key];
+        g_tileLru.push_front(t.key);
+        e.lru = g_tileLru.begin();
+        if (t.rgba.empty()) continue;
+        glGenTextures(1, &e.tex);
+        glBindTexture(GL_TEXTURE_2D, e.tex);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB8, t.w, t.h, 0, GL_RGBA, GL_UNSIGNED_BYTE, t.rgba.data());
+    }
+
+    size_t capacity = std::max(size_t(std::max(0, TILE_CACHE_TILES)), 2 * drawn);
+    while (g_tileCache.size() > capacity) {
+        auto it = g_tileCache.find(g_tileLru.back());
+        if (it->second.tex) glDeleteTextures(1, &it->second.tex);
+        g_tileCache.erase(it);
+        g_tileLru.pop_back();
+    }
+}
+
+// Cached entry for key, marked as just drawn; nullptr if not loaded.
+static const TileTexture* touchTile(uint64_t key) {
+    auto it = g_tileCache.find(key);
+    if (it == g_tileCache.end()) return nullptr;
+    g_tileLru.splice(g_tileLru.begin(), g_tileLru, it->second.lru);
+    return &it->second;
+}
+
+// The layout on screen is the one the tiles were rendered from, unrotated
+// (rotated tiles would turn their labels upside down).
+static bool tilesMatchLayout() {
+    return TILE_MODE && !g_pyramidDir.empty() && !mapBusy() && !HYPERBOLIC_VIEW && g_rotDeg == 0.0f &&
+           !g_transitionActive && g_layoutEdits == 0 && g_focus == g_root.get() &&
+           RADIUS_STEP == g_pyramid.radiusStep && LINKS_CURVED == g_pyramid.curved &&
+           rangeSlotCount(g_visibleRanges) == g_pyramid.nodes;
+}
+
+// Draw the view from the pyramid. Returns false (drawing nothing) if it has
+// to be drawn live: deeper than the last level, or a different layout.
+static bool drawTiles() {
+    if (!tilesMatchLayout()) return false;
+
+    // Coarsest level with at least one tile pixel per window pixel.
+    const int T = g_pyramid.tileSize;
+    const float E = g_pyramid.extent;
+    ScreenXform X = currentScreenXform();
+    float need = X.ppw * 2.0f * E / float(T); // tiles across the map at one tile pixel per window pixel
+    int z = need <= 1.0f ? 0 : int(std::ceil(std::log2(need) - 1e-4f));
+    if (z >= g_pyramid.levels) return false;
+
+    // Tiles under the window.
+    int across = 1 << z;
+    float tileWorld = 2.0f * E / float(across);
+    float x0 = 1e30f, y0 = 1e30f, x1 = -1e30f, y1 = -1e30f;
+    const int corners[4][2] = { { 0, 0 }, { g_winW, 0 }, { 0, g_winH }, { g_winW, g_winH } };
+    for (const auto& c : corners) {
+        float wx, wy;
+        screenToWorld(c[0], c[1], wx, wy);
+        x0 = std::min(x0, wx); x1 = std::max(x1, wx);
+        y0 = std::min(y0, wy); y1 = std::max(y1, wy);
+    }
+    int tx0 = std::max(0, int(std::floor((x0 + E) / tileWorld)));
+    int tx1 = std::min(across - 1, int(std::floor((x1 + E) / tileWorld)));
+    int ty0 = std::max(0, int(std::floor((E - y1) / tileWorld)));
+    int ty1 = std::min(across - 1, int(std::floor((E - y0) / tileWorld)));
+
+    // Level 0 first (the stand-in of last resort), then nearest the window center first.
+    std::vector<uint64_t> wanted = { tileKey(0, 0, 0) };
+    float cx = 0.5f * float(tx0 + tx1), cy = 0.5f * float(ty0 + ty1);
+    std::vector<std::pair<float, uint64_t>> order;
+    for (int ty = ty0; ty <= ty1; ++ty)
+        for (int tx = tx0; tx <= tx1; ++tx)
+            order.push_back({ std::hypot(float(tx) - cx, float(ty) - cy), tileKey(z, tx, ty) });
+    std::sort(order.begin(), order.end());
+    for (const auto& o : order) wanted.push_back(o.second);
+
+    uploadTiles(wanted.size());
+    requestTiles(wanted);
+
+    glEnable(GL_TEXTURE_2D);
+    glColor4f(1.0f, 1.0f, 1.0f, 1.0f);
+    for (int ty = ty0; ty <= ty1; ++ty) {
+        for (int tx = tx0; tx <= tx1; ++tx) {
+            // This tile or, until it is loaded, the matching part of an ancestor.
+            const TileTexture* t = nullptr;
+            int k = 0;
+            for (; k <= z && !t; ++k) t = touchTile(tileKey(z - k, tx >> k, ty >> k));
+            if (!t || !t->tex) continue;
+            --k;
+            float span = 1.0f / float(1 << k);
+            float s0 = float(tx - ((tx >> k) << k)) * span, t0 = float(ty - ((ty >> k) << k)) * span;
+
+            float wx = -E + float(tx) * tileWorld, wy = E - float(ty) * tileWorld;
+            glBindTexture(GL_TEXTURE_2D, t->tex);
+            glBegin(GL_QUADS);
+            glTexCoord2f(s0, t0);               glVertex2f(wx, wy);
+            glTexCoord2f(s0 + span, t0);        glVertex2f(wx + tileWorld, wy);
+            glTexCoord2f(s0 + span, t0 + span); glVertex2f(wx + tileWorld, wy - tileWorld);
+            glTexCoord2f(s0, t0 + span);        glVertex2f(wx, wy - tileWorld);
+            glEnd();
+        }
+    }
+    glDisable(GL_TEXTURE_2D);
+    return true;
+}
+
+// ---------------------------- Live Feed ----------------------------
+
+// With LIVE_FEED on, the placed nodes and the camera are published in shared
+// memory for other processes (layoutfeed.h): the layout whenever it has
+// changed since the last frame, the camera with every frame drawn.
+static LayoutFeedWriter g_feed;
+static uint64_t g_feedGeometry = ~uint64_t(0); // g_geometryVersion last published
+
+static void publishFeed() {
+    if (!LIVE_FEED || mapBusy()) return;
+    if (g_feedGeometry != g_geometryVersion) {
+        bool first = g_feed.name.empty();
+        if (first) g_feed.name = layoutFeedName(int(getpid()));
+        if (!g_feed.publishLayout(g_nodes, g_visibleRanges, g_focus)) { LIVE_FEED = false; return; }
+        if (first) std::printf("Live feed: %s\n", g_feed.name.c_str());
+        g_feedGeometry = g_geometryVersion;
+    }
+
+    LayoutFeedView v;
+    v.panX = g_panX;
+    v.panY = g_panY;
+    v.zoom = g_zoom;
+    v.rotDeg = g_rotDeg;
+    v.halfHeight = BASE_HALF_H / g_zoom;
+    v.winW = g_winW;
+    v.winH = g_winH;
+    v.flags = HYPERBOLIC_VIEW ? FEED_HYPERBOLIC : 0;
+    g_feed.publishView(v);
+}
+
+// ---------------------------- Rendering ----------------------------
+
+static void setupOrtho(const Viewport& vp) {
+    glMatrixMode(GL_PROJECTION);
+    glLoadIdentity();
+
+    float aspect = (vp.h != 0) ? float(vp.w) / float(vp.h) : 1.0f;
+    float halfH = BASE_HALF_H / vp.zoom;
+    float halfW = halfH * aspect;
+
+    glOrtho(-halfW, halfW, -halfH, halfH, -1, 1);
+
+    glMatrixMode(GL_MODELVIEW);
+    glLoadIdentity();
+
+    glTranslatef(-vp.panX, -vp.panY, 0.0f);
+    glRotatef(vp.rotDeg, 0.0f, 0.0f, 1.0f);
+}
+
+static void display() {
+    glClearColor(1,1,1,1);
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    Viewport vp = windowViewport();
+    setupOrtho(vp);
+
+    if (mapBusy()) {
+        drawLayoutProgress();
+        glutSwapBuffers();
+        return;
+    }
+
+    if (HYPERBOLIC_VIEW) {
+        syncLabelFlips();
+        g_windowFrame.vp = vp;
+        drawHyperbolic(g_windowFrame);
+    } else if (drawTiles()) {
+        drawSearchHits();
+        drawHighlights();
+    } else if (PROGRESSIVE_RENDER) {
+        drawProgressive(vp);
+    } else {
+        g_windowFrame.vp = vp;
+        drawFlatGeometry(g_windowFrame);
+        drawSearchHits();
+        drawHighlights();
+        drawLabels(g_windowFrame);
+    }
+    drawSearchOverlay();
+    publishFeed();
+
+    glutSwapBuffers();
+}
+
+// ---------------------------- Screenshot ----------------------------
+
+// A screenshot (up to SCREENSHOT_LONG_SIDE pixels, same aspect as the window)
+// is drawn from idle() in steps of at most PROGRESSIVE_BUDGET_MS, so no frame
+// waits for it and the window's view state is left alone. Its labels are
+// first placed for the whole image (frame). Then the image is drawn in bands
+// of SCREENSHOT_BAND_PIXELS, one after another into a band-sized offscreen
+// framebuffer, by a progressive pass (band) culled to the band's rows that
+// draws only the labels reaching them. Each finished band is read back into a
+// pixel buffer object behind a fence and copied into the image once the fence
+// has signaled, while the next band is drawn; an encoder thread then writes
+// the PNG. A scene change restarts the drawing, a transition is waited out.
+enum ShotStage { SHOT_IDLE, SHOT_PLACING, SHOT_DRAWING, SHOT_ENCODING };
+
+struct Screenshot {
+    ShotStage stage = SHOT_IDLE;
+    ViewFrame frame;              // the window's view at the key press, at the screenshot size
+    ViewFrame band;               // rows [band.vp.y0, band.vp.y1) of it
+    bool started = false;         // frame culled and its labels being placed
+    bool bandStarted = false;
+    size_t cursor = 0;            // next label to place
+    int bandRows = 0;
+    int row = 0;                  // first row of the next band
+    int copyRow = 0, copyRows = 0; // band behind the fence
+    uint64_t geometry = 0;        // g_geometryVersion the drawing started at
+    int steps = 0;
+    double longestStepMs = 0.0;
+    GLuint fbo = 0, rbo = 0, pbo = 0;
+    GLsync drawn = nullptr;       // after the band's last drawing command
+    GLsync fence = nullptr;       // after its readback into pbo
+    int w = 0, h = 0;
+    std::unique_ptr<uint8_t[]> pixels; // RGBA, bottom row first
+    std::string path;
+    std::thread encoder;
+    std::atomic<bool> encoded{false};
+    bool ok = false;
+    std::chrono::steady_clock::time_point t0;
+};
+
+static Screenshot g_shot;
+static int g_shotCount = 0;
+
+static void joinScreenshotEncoder() {
+    if (g_shot.encoder.joinable()) g_shot.encoder.join();
+}
+
+static void releaseScreenshot() {
+    if (g_shot.drawn) glDeleteSync(g_shot.drawn);
+    if (g_shot.fence) glDeleteSync(g_shot.fence);
+    if (g_shot.pbo) glDeleteBuffers(1, &g_shot.pbo);
+    if (g_shot.fbo) glDeleteFramebuffers(1, &g_shot.fbo);
+    if (g_shot.rbo) glDeleteRenderbuffers(1, &g_shot.rbo);
+    g_shot.drawn = g_shot.fence = nullptr;
+    g_shot.pbo = g_shot.fbo = g_shot.rbo = 0;
+    g_shot.frame = ViewFrame();
+    g_shot.band = ViewFrame();
+    g_shot.pixels.reset();
+    g_shot.stage = SHOT_IDLE;
+}
+
+static void captureScreenshot() {
+    if (g_shot.stage != SHOT_IDLE) { std::printf("Screenshot still in progress\n"); return; }
+
+    GLint maxRb = 0, maxVp[2] = { 0, 0 };
+    glGetIntegerv(GL_MAX_RENDERBUFFER_SIZE, &maxRb);
+    glGetIntegerv(GL_MAX_VIEWPORT_DIMS, maxVp);
+    int longSide = SCREENSHOT_LONG_SIDE > 0 ? SCREENSHOT_LONG_SIDE : std::max(g_winW, g_winH);
+    longSide = std::min({ longSide, int(maxRb), int(maxVp[0]), int(maxVp[1]) });
+    float k = float(longSide) / float(std::max(1, std::max(g_winW, g_winH)));
+    int w = std::max(1, int(float(g_winW) * k + 0.5f));
+    int h = std::max(1, int(float(g_winH) * k + 0.5f));
+    int rows = std::min(h, std::max(1, SCREENSHOT_BAND_PIXELS / w));
+
+    glGenRenderbuffers(1, &g_shot.rbo);
+    glBindRenderbuffer(GL_RENDERBUFFER, g_shot.rbo);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, w, rows);
+    glGenFramebuffers(1, &g_shot.fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, g_shot.fbo);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, g_shot.rbo);
+    bool complete = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    if (!complete) {
+        std::fprintf(stderr, "Screenshot: cannot create a %dx%d framebuffer\n", w, rows);
+        releaseScreenshot();
+        return;
+    }
+    glGenBuffers(1, &g_shot.pbo);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, g_shot.pbo);
+    glBufferData(GL_PIXEL_PACK_BUFFER, GLsizeiptr(w) * rows * 4, nullptr, GL_STREAM_READ);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    static bool registered = false;
+    if (!registered) { std::atexit(joinScreenshotEncoder); registered = true; }
+    Viewport vp = windowViewport();
+    vp.w = w;
+    vp.h = h;
+    vp.y0 = 0;
+    vp.y1 = h;
+    g_shot.frame.vp = vp;
+    g_shot.started = false;
+    g_shot.bandRows = rows;
+    g_shot.steps = 0;
+    g_shot.longestStepMs = 0.0;
+    g_shot.w = w;
+    g_shot.h = h;
+    g_shot.pixels.reset(new uint8_t[size_t(w) * size_t(h) * 4]);
+    g_shot.path = mapOutputPath("-" + std::to_string(++g_shotCount) + ".png");
+    g_shot.t0 = std::chrono::steady_clock::now();
+    g_shot.stage = SHOT_PLACING;
+}
+
+// Copy the band behind the fence into the image once the fence has signaled.
+// True if the pixel buffer is free (false too after a failed readback, which
+// ends the screenshot).
+static bool copyScreenshotBand() {
+    if (!g_shot.fence) return true;
+    GLenum r = glClientWaitSync(g_shot.fence, 0, 0);
+    if (r == GL_TIMEOUT_EXPIRED) return false;
+    glDeleteSync(g_shot.fence);
+    g_shot.fence = nullptr;
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, g_shot.pbo);
+    const void* band = (r == GL_WAIT_FAILED) ? nullptr : glMapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY);
+    if (band) {
+        size_t rowBytes = size_t(g_shot.w) * 4;
+        std::memcpy(g_shot.pixels.get() + size_t(g_shot.copyRow) * rowBytes, band, size_t(g_shot.copyRows) * rowBytes);
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    if (!band) {
+        std::fprintf(stderr, "Screenshot: readback failed\n");
+        releaseScreenshot();
+        return false;
+    }
+    return true;
+}
+
+// Start the next band: cull it, clear it and pick the labels reaching its rows.
+static void beginScreenshotBand() {
+    ViewFrame& b = g_shot.band;
+    if (g_shot.drawn) glDeleteSync(g_shot.drawn); // from a band cut short by a restart
+    g_shot.drawn = nullptr;
+    b.vp = g_shot.frame.vp;
+    b.vp.y0 = g_shot.row;
+    b.vp.y1 = std::min(g_shot.h, g_shot.row + g_shot.bandRows);
+    glClearColor(1, 1, 1, 1);
+    glClear(GL_COLOR_BUFFER_BIT);
+    beginProgressivePass(b);
+
+    const float pad = 2.0f; // antialiased strokes reach a little past the text box
+    b.prePlaced = true;
+    b.placed.clear();
+    for (const PlacedLabel& pl : g_shot.frame.placed) {
+        float ex, ey;
+        labelBoxBounds(pl.box, ex, ey);
+        if (pl.box.cy + ey + pad >= float(b.vp.y0) && pl.box.cy - ey - pad <= float(b.vp.y1)) b.placed.push_back(pl);
+    }
+    g_shot.bandStarted = true;
+}
+
+// Called from idle(): one step of placing the labels or of drawing a band,
+// or the readback of a finished band.
+static void stepScreenshot() {
+    if (mapBusy() || g_transitionActive) return;
+    auto t0 = std::chrono::steady_clock::now();
+    bool pboFree = copyScreenshotBand();
+    if (g_shot.stage == SHOT_IDLE) return;
+
+    ViewFrame& f = g_shot.frame;
+    if (g_shot.started && (g_buffersDirty || g_geometryVersion != g_shot.geometry)) {
+        g_shot.started = false;
+        g_shot.stage = SHOT_PLACING;
+    }
+
+    if (g_shot.stage == SHOT_PLACING) {
+        if (!g_shot.started) {
+            if (g_buffersDirty) fillRenderBuffers();
+            if (f.vp.hyperbolic) projectHyperbolic(f);
+            else                 computeLodRanges(f);
+            syncLabelFlips();
+            resetDeclutterGrid(f);
+            g_shot.cursor = 0;
+            g_shot.started = true;
+            g_shot.geometry = g_geometryVersion;
+        } else {
+            size_t total = g_labelOrder.size() + 1, chunk = size_t(std::max(16, PROGRESSIVE_CHUNK));
+            do {
+                size_t e = std::min(total, g_shot.cursor + chunk);
+                declutterLabelRange(f, g_shot.cursor, e);
+                g_shot.cursor = e;
+            } while (g_shot.cursor < total && std::chrono::duration<float, std::milli>(
+                         std::chrono::steady_clock::now() - t0).count() < PROGRESSIVE_BUDGET_MS);
+            if (g_shot.cursor == total) {
+                g_shot.stage = SHOT_DRAWING;
+                g_shot.row = 0;
+                g_shot.bandStarted = false;
+            }
+        }
+    } else if (!g_shot.bandStarted && g_shot.row >= g_shot.h) {
+        if (!pboFree) return;
+        g_shot.encoded = false;
+        g_shot.encoder = std::thread([]() {
+            g_shot.ok = writePng(g_shot.path.c_str(), g_shot.pixels.get(), g_shot.w, g_shot.h, true, SCREENSHOT_THREADS);
+            g_shot.encoded.store(true, std::memory_order_release);
+        });
+        g_shot.stage = SHOT_ENCODING;
+    } else {
+        ViewFrame& b = g_shot.band;
+        int rows = std::min(g_shot.h - g_shot.row, g_shot.bandRows);
+        // The band's progressive pass, then its readback once it is drawn
+        // and the pixel buffer is free.
+        if (g_shot.bandStarted && b.stage == PROG_DONE) {
+            if (!pboFree || glClientWaitSync(g_shot.drawn, 0, 0) == GL_TIMEOUT_EXPIRED) return;
+            glDeleteSync(g_shot.drawn);
+            g_shot.drawn = nullptr;
+        }
+        // The whole image's viewport, shifted down so that the band's rows land in the framebuffer
+        glBindFramebuffer(GL_FRAMEBUFFER, g_shot.fbo);
+        glViewport(0, -g_shot.row, g_shot.w, g_shot.h);
+        if (!g_shot.bandStarted) {
+            beginScreenshotBand();
+        } else if (b.stage != PROG_DONE) {
+            setupOrtho(b.vp);
+            stepProgressivePass(b, PROGRESSIVE_BUDGET_MS);
+            if (b.stage == PROG_DONE && !b.vp.hyperbolic) {
+                drawSearchHits();
+                drawHighlights();
+            }
+            if (b.stage == PROG_DONE) g_shot.drawn = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+            glFlush();
+        } else {
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, g_shot.pbo);
+            glPixelStorei(GL_PACK_ALIGNMENT, 1);
+            glReadPixels(0, 0, g_shot.w, rows, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+            glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+            g_shot.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+            glFlush();
+            g_shot.copyRow = g_shot.row;
+            g_shot.copyRows = rows;
+            g_shot.row += rows;
+            g_shot.bandStarted = false;
+        }
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        glViewport(0, 0, g_winW, g_winH);
+    }
+
+    ++g_shot.steps;
+    g_shot.longestStepMs = std::max(g_shot.longestStepMs,
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count());
+}
+
+// Called from idle(): finishes a screenshot once the encoder is done.
+static void pollScreenshot() {
+    if (!g_shot.encoded.load(std::memory_order_acquire)) return;
+    g_shot.encoder.join();
+    releaseScreenshot();
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - g_shot.t0).count();
+    if (g_shot.ok) std::printf("Saved %dx%d screenshot to %s (%.0f ms, drawn in %d steps of up to %.1f ms)\n",
+                               g_shot.w, g_shot.h, g_shot.path.c_str(), ms, g_shot.steps, g_shot.longestStepMs);
+}
+
+// ---------------------------- Animation ----------------------------
+
+// Startup work, one slice per idle call. Between layout passes the queued
+// nodes are attached; a provisional pass starts at most every LOAD_RELAYOUT_MS,
+// the final one once the loader has finished and its queue is drained.
+static int g_lastLayoutPassMs = 0;
+
+static void stepStartup() {
+    if (g_loading && !layoutPending()) {
+        bool finished = g_loadFinished.load(std::memory_order_acquire);
+        size_t added = drainLoadQueue(LAYOUT_SLICE_US);
+        int now = glutGet(GLUT_ELAPSED_TIME);
+
+        if (finished && g_loadQueue.empty()) {
+            g_loading = false;
+            g_loadThread.join();
+            if (g_loadFailed.load() || !g_root) std::exit(1);
+            beginLayout();
+        } else if (g_root && (added > 0 || g_nodes.size() < g_loadedNodes) &&
+                   now - g_lastLayoutPassMs >= LOAD_RELAYOUT_MS) {
+            g_lastLayoutPassMs = now;
+            beginLayout(false);
+        }
+        return;
+    }
+    if (layoutPending() && stepLayout(LAYOUT_SLICE_US) && !g_loading) buildSearchIndex();
+}
+
+static void idle() {
+    if (g_shot.stage == SHOT_ENCODING)  pollScreenshot();
+    else if (g_shot.stage != SHOT_IDLE) stepScreenshot();
+    if (mapBusy()) {
+        stepStartup();
+        glutPostRedisplay();
+    }
+    if (g_transitionActive) {
+        stepTransition();
+        glutPostRedisplay();
+    }
+    if (g_tilesArrived.load(std::memory_order_acquire)) glutPostRedisplay();
+    if (!g_rotateAnim) return;
+
+    int now = glutGet(GLUT_ELAPSED_TIME);
+    if (g_lastTimeMs == 0) g_lastTimeMs = now;
+
+    int dtMs = now - g_lastTimeMs;
+    g_lastTimeMs = now;
+
+    float dt = float(dtMs) / 1000.0f;
+    g_rotDeg += g_rotDegPerSec * dt;
+
+    if (g_rotDeg >= 360.0f) g_rotDeg -= 360.0f;
+    if (g_rotDeg < 0.0f)    g_rotDeg += 360.0f;
+
+    glutPostRedisplay();
+}
+
+// ---------------------------- Interaction ----------------------------
+
+static void reshape(int w, int h) {
+    g_winW = std::max(1, w);
+    g_winH = std::max(1, h);
+    glViewport(0, 0, g_winW, g_winH);
+    glutPostRedisplay();
+}
+
+static void special(int key, int, int) {
+    if (key == GLUT_KEY_F5 && !mapBusy()) {
+        reloadMap();
+        invalidateProgressive();
+        glutPostRedisplay();
+    }
+}
+
+static void keyboard(unsigned char key, int, int) {
+    if (g_searchMode) {
+        searchKey(key);
+        glutPostRedisplay();
+        return;
+    }
+
+    if (key == 27) std::exit(0); // ESC (stops the loader via atexit)
+
+    // Until the map is loaded and laid out only the view can change.
+    if (mapBusy() && key != '+' && key != '=' && key != '-' && key != '_') return;
+
+    if (key == '/') {
+        g_searchMode = true;
+        g_searchQuery.clear();
+        g_searchMatchedQuery.clear();
+        g_searchHits.clear();
+    }
+
+    if (key == '+' || key == '=') g_zoom = std::min(20.0f, g_zoom * 1.1f);
+    if (key == '-' || key == '_') g_zoom = std::max(0.1f,  g_zoom * 0.9f);
+
+    if (key == 'l' || key == 'L') LABEL_LEAVES_ONLY = !LABEL_LEAVES_ONLY;
+
+    // Toggle curved/straight links
+    if (key == 'c' || key == 'C') animateLinkStyle();
+
+    // Ring spacing
+    if (key == ',' || key == '<') animateRadiusStep(RADIUS_STEP * 0.9f);
+    if (key == '.' || key == '>') animateRadiusStep(RADIUS_STEP * 1.1f);
+
+    // Fullscreen toggle
+    if (key == 'f' || key == 'F') {
+        if (!g_fullscreen) {
+            g_fullscreen = true;
+            g_winW_prev = g_winW;
+            g_winH_prev = g_winH;
+            g_winX = glutGet(GLUT_WINDOW_X);
             g_winY = glutGet(GLUT_WINDOW_Y);
             glutFullScreen();
         } else {
@@ -439,17 +3713,77 @@ static void keyboard(unsigned char key, int, int) {
     // Toggle constant screen-size labels
     if (key == 't' || key == 'T') LABEL_CONST_SCREEN_SIZE = !LABEL_CONST_SCREEN_SIZE;
 
+    // Re-center on the root
+    if (key == 'h' || key == 'H') refocus(g_root.get());
+
+    // Level of detail
+    if (key == 'v' || key == 'V') LOD_ENABLED = !LOD_ENABLED;
+    if (key == 'z' || key == 'Z') SEMANTIC_ZOOM = !SEMANTIC_ZOOM;
+    if (key == 'g' || key == 'G') PROGRESSIVE_RENDER = !PROGRESSIVE_RENDER;
+
+    // Hyperbolic view
+    if (key == 'p' || key == 'P') {
+        HYPERBOLIC_VIEW = !HYPERBOLIC_VIEW;
+        g_hypCx = g_hypCy = 0.0f;
+    }
+
+    // Toggle label decluttering
+    if (key == 'd' || key == 'D') LABEL_DECLUTTER = !LABEL_DECLUTTER;
+
+    if (key == 'e' || key == 'E') exportViewSvg();
+    if (key == 's' || key == 'S') captureScreenshot();
+    if (key == 'm' || key == 'M') TILE_MODE = !TILE_MODE;
+    if (key == 'b' || key == 'B') {
+        LIVE_FEED = !LIVE_FEED;
+        if (!LIVE_FEED) g_feed.close();
+        g_feedGeometry = ~uint64_t(0);
+    }
+
+    invalidateProgressive();
     glutPostRedisplay();
 }
 
 static void mouse(int button, int state, int x, int y) {
+    // Until the map is loaded and laid out only pan and zoom work.
+    if (mapBusy() && button != GLUT_LEFT_BUTTON && button != 3 && button != 4) return;
+
     if (button == GLUT_LEFT_BUTTON) {
         if (state == GLUT_DOWN) {
             g_dragging = true;
             g_lastMouseX = x;
             g_lastMouseY = y;
+            g_pressX = x;
+            g_pressY = y;
         } else {
             g_dragging = false;
+
+            // Release without dragging: select (or clear selection on empty space)
+            if (std::abs(x - g_pressX) <= CLICK_SLOP_PX && std::abs(y - g_pressY) <= CLICK_SLOP_PX &&
+                !mapBusy()) {
+                g_selectedNode = pickNodeAtPixel(x, y);
+                if (g_selectedNode) printNodeInfo(g_selectedNode);
+                glutPostRedisplay();
+            }
+        }
+    }
+
+    // Right click: fold/unfold the subtree under the cursor
+    if (button == GLUT_RIGHT_BUTTON && state == GLUT_DOWN) {
+        const Node* hit = pickNodeAtPixel(x, y);
+        if (hit && hit->depth >= g_focus->depth) {
+            Node* n = g_nodes[hit->index];
+            animateFold(n);
+            if (g_selectedNode && nodeHidden(g_selectedNode)) g_selectedNode = n;
+            g_hoverNode = n;
+            glutPostRedisplay();
+        }
+    }
+
+    // Middle click: make the node under the cursor the new center
+    if (button == GLUT_MIDDLE_BUTTON && state == GLUT_DOWN) {
+        if (const Node* hit = pickNodeAtPixel(x, y)) {
+            refocus(g_nodes[hit->index]);
+            glutPostRedisplay();
         }
     }
 
@@ -473,6 +3807,15 @@ static void motion(int x, int y) {
     g_lastMouseX = x;
     g_lastMouseY = y;
 
+    if (HYPERBOLIC_VIEW) {
+        float w1x, w1y, w2x, w2y;
+        screenToWorld(x - dx, y - dy, w1x, w1y);
+        screenToWorld(x, y, w2x, w2y);
+        hyperbolicDrag(w1x, w1y, w2x, w2y);
+        glutPostRedisplay();
+        return;
+    }
+
     float viewHalfH = BASE_HALF_H / g_zoom;
     float worldPerPixel = (2.0f * viewHalfH) / float(std::max(1, g_winH));
 
@@ -482,16 +3825,215 @@ static void motion(int x, int y) {
     glutPostRedisplay();
 }
 
-// ---------------------------- Main ----------------------------
+static void passiveMotion(int x, int y) {
+    if (mapBusy()) return;
+    const Node* hit = pickNodeAtPixel(x, y);
+    if (hit != g_hoverNode) {
+        g_hoverNode = hit;
+        glutPostRedisplay();
+    }
+}
 
-int main(int argc, char** argv) {
-    const char* path = (argc >= 2) ? argv[1] : "example.mm";
+// ---------------------------- Kernel Benchmark ----------------------------
+
+// radialgl --bench map.mm: times the specialized geometry and label kernels
+// against the same templates dispatched per node (writeNodeGeometry(),
+// LabelFilter::ByFlag) on one thread, without opening a window.
+static volatile double g_benchSink = 0.0; // label checksums, so the loops are not dropped
 
-    g_root = loadFreeMind(path);
+template <typename Fn>
+static double bestOfMs(int runs, Fn fn) {
+    double best = 1e30;
+    for (int r = 0; r < runs; ++r) {
+        auto t0 = std::chrono::steady_clock::now();
+        fn();
+        best = std::min(best, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count());
+    }
+    return best;
+}
+
+static void printBenchRow(const char* what, double branching, double specialized) {
+    std::printf("  %-22s branching %8.2f ms   specialized %8.2f ms   x%.2f\n",
+                what, branching, specialized, branching / std::max(1e-9, specialized));
+}
+
+static int runBenchmark(const char* path) {
+    g_root = loadFreeMind(path, g_autoId);
     if (!g_root) return 1;
+    computeLayout();
+    GEOMETRY_THREADS = 1;
+
+    const int runs = 5;
+    std::printf("Kernel benchmark: %zu nodes, best of %d\n", g_nodes.size(), runs);
+
+    for (int curved = 1; curved >= 0; --curved) {
+        g_curveBlend = float(curved);
+        fillRenderBuffers(); // sizes the slots and sets up g_fillRanges
+        double branching = bestOfMs(runs, [] {
+            for (const auto& r : g_visibleRanges)
+                for (int i = r.first; i < r.second; ++i) writeNodeGeometry(i);
+        });
+        double specialized = bestOfMs(runs, [] {
+            if (g_curveBlend > 0.0f) fillSlots<LinkKind::Curved>(g_fillRanges);
+            else                     fillSlots<LinkKind::Line>(g_fillRanges);
+        });
+        printBenchRow(curved ? "links, curved" : "links, straight", branching, specialized);
+    }
+
+    ViewFrame& f = g_windowFrame;
+    f.vp = windowViewport();
+    beginDrawnFrame(f);
+    std::fill(f.drawn.begin(), f.drawn.end(), f.frameNo);
+    for (int leaves = 0; leaves <= 1; ++leaves) {
+        LABEL_LEAVES_ONLY = (leaves != 0);
+        double branching = bestOfMs(runs, [&] {
+            LabelPlacement p;
+            double sum = 0.0;
+            forEachLabel<LabelFilter::ByFlag>(f, g_labelOrder.data(), 0, g_labelOrder.size(), [&](const LabelEntry& e) {
+                placeLabel(f.vp, e, p);
+                sum += p.x + p.angleDeg;
+            });
+            g_benchSink = sum;
+        });
+        double specialized = bestOfMs(runs, [&] {
+            LabelPlacement p;
+            double sum = 0.0;
+            forEachWantedLabel(f, g_labelOrder.data(), 0, g_labelOrder.size(), [&](const LabelEntry& e) {
+                placeLabel(f.vp, e, p);
+                sum += p.x + p.angleDeg;
+            });
+            g_benchSink = sum;
+        });
+        printBenchRow(leaves ? "labels, leaves only" : "labels, all", branching, specialized);
+    }
+    return 0;
+}
 
+// ---------------------------- Rasterizer Comparison ----------------------------
+
+// radialgl --compare map.mm [size]: draws the whole map into a size x size
+// offscreen framebuffer as the window draws it without LOD, semantic zoom or
+// decluttering (which rasterMap() does not do), renders the same view with
+// rasterMap() and prints the per-channel error between the two. The view is
+// fitRasterView()'s, at rotation 0. Both images are written next to the map
+// (<map name>-gl.png, <map name>-raster.png).
+static int runComparison(const char* path, int size, int* argc, char** argv) {
+    g_mapPath = path;
+    g_root = loadFreeMind(path, g_autoId);
+    if (!g_root) return 1;
+    LOD_ENABLED = false;
+    SEMANTIC_ZOOM = false;
+    LABEL_DECLUTTER = false;
+    LABEL_CONST_SCREEN_SIZE = false;
     computeLayout();
 
+    RasterOptions ro;
+    ro.radiusStep = RADIUS_STEP;
+    ro.curved = LINKS_CURVED;
+    ro.endpointRadius = ENDPOINT_RADIUS;
+    ro.leavesOnly = LABEL_LEAVES_ONLY;
+    ro.labelScale = LABEL_STROKE_SCALE;
+    ro.labelPad = LABEL_RADIAL_PAD;
+    ro.bezierSamples = BEZIER_SAMPLES;
+    ro.labelMinPx = 0.0f; // the window draws labels of any size
+
+    glutInit(argc, argv);
+    glutInitDisplayMode(GLUT_RGBA);
+    glutInitWindowSize(64, 64);
+    glutCreateWindow("radialgl --compare");
+    GLint maxRb = 0;
+    glGetIntegerv(GL_MAX_RENDERBUFFER_SIZE, &maxRb);
+    size = std::clamp(size, 16, int(maxRb));
+    RasterView view = fitRasterView(g_nodes, g_visibleRanges, g_focus, ro, size, size);
+
+    // The window's transform for that view (screenXform(): ppw = ppu).
+    Viewport vp = { size, size, view.pixelsPerUnit * 2.0f * BASE_HALF_H / float(size),
+                    view.centerX, view.centerY, 0.0f, false, 0.0f, 0.0f, 0, size };
+
+    GLuint fbo = 0, rbo = 0;
+    glGenRenderbuffers(1, &rbo);
+    glBindRenderbuffer(GL_RENDERBUFFER, rbo);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, size, size);
+    glGenFramebuffers(1, &fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, rbo);
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        std::fprintf(stderr, "Compare: cannot create a %dx%d framebuffer\n", size, size);
+        return 1;
+    }
+
+    auto t0 = std::chrono::steady_clock::now();
+    glViewport(0, 0, size, size);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glEnable(GL_LINE_SMOOTH);
+    glHint(GL_LINE_SMOOTH_HINT, GL_NICEST);
+    glClearColor(1, 1, 1, 1);
+    glClear(GL_COLOR_BUFFER_BIT);
+    setupOrtho(vp);
+    ViewFrame f;
+    f.vp = vp;
+    drawFlatGeometry(f);
+    drawLabels(f);
+    std::vector<uint8_t> gl(size_t(size) * size_t(size) * 4);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, size, size, GL_RGBA, GL_UNSIGNED_BYTE, gl.data());
+    double glMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glDeleteFramebuffers(1, &fbo);
+    glDeleteRenderbuffers(1, &rbo);
+
+    t0 = std::chrono::steady_clock::now();
+    SoftRaster raster(size, size);
+    rasterMap(raster, g_nodes, g_visibleRanges, g_focus, ro, view);
+    RasterImage image;
+    raster.render(image, rasterColor(1.0f, 1.0f, 1.0f, 1.0f), ro.threads);
+    double rasterMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+
+    // GL rows are bottom up, the rasterizer's top down.
+    int maxErr = 0;
+    double sumErr = 0.0;
+    size_t over = 0;
+    for (int y = 0; y < size; ++y) {
+        const uint8_t* a = &gl[size_t(size - 1 - y) * size_t(size) * 4];
+        const uint8_t* b = &image.rgba[size_t(y) * size_t(size) * 4];
+        for (int x = 0; x < size; ++x, a += 4, b += 4) {
+            int e = 0;
+            for (int c = 0; c < 3; ++c) {
+                int d = std::abs(int(a[c]) - int(b[c]));
+                sumErr += d;
+                e = std::max(e, d);
+            }
+            maxErr = std::max(maxErr, e);
+            if (e > 32) ++over;
+        }
+    }
+    double pixels = double(size) * double(size);
+    std::printf("Compared %zu nodes at %dx%d: GL %.0f ms, rasterizer %.0f ms\n",
+                rangeSlotCount(g_visibleRanges), size, size, glMs, rasterMs);
+    std::printf("  per-channel error: max %d, mean %.3f; pixels off by more than 32: %.3f%%\n",
+                maxErr, sumErr / (3.0 * pixels), 100.0 * double(over) / pixels);
+
+    writePng(mapOutputPath("-gl.png").c_str(), gl.data(), size, size, true, 0);
+    writePng(mapOutputPath("-raster.png").c_str(), image.rgba.data(), size, size, false, 0);
+    return 0;
+}
+
+// ---------------------------- Main ----------------------------
+
+int main(int argc, char** argv) {
+    if (argc >= 3 && std::strcmp(argv[1], "--bench") == 0) return runBenchmark(argv[2]);
+    if (argc >= 3 && std::strcmp(argv[1], "--compare") == 0)
+        return runComparison(argv[2], argc >= 4 ? std::atoi(argv[3]) : 2048, &argc, argv);
+
+    const char* path = (argc >= 2) ? argv[1] : "example.mm";
+    g_mapPath = path;
+
+    // Streamed in by the loader thread and laid out in slices from idle(),
+    // so the window appears right away.
+    if (!startLoader(path)) return 1;
+    openTilePyramid();
+
     glutInit(&argc, argv);
     glutInitDisplayMode(GLUT_DOUBLE | GLUT_RGBA);
     glutInitWindowSize(g_winW, g_winH);
@@ -507,8 +4049,10 @@ int main(int argc, char** argv) {
     glutDisplayFunc(display);
     glutReshapeFunc(reshape);
     glutKeyboardFunc(keyboard);
+    glutSpecialFunc(special);
     glutMouseFunc(mouse);
     glutMotionFunc(motion);
+    glutPassiveMotionFunc(passiveMotion);
     glutIdleFunc(idle);
 
     glutMainLoop();
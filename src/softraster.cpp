@@ -0,0 +1,657 @@
+// softraster.cpp - multi-threaded software rasterizer for map geometry.
+
+#include "softraster.h"
+
+#include <cstdio>
+#include <cmath>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <unordered_map>
+
+#include "strokefont.h"
+#include "pngwriter.h"
+#include "tiffwriter.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+static const int    RASTER_TILE      = 64;    // tile edge, pixels
+static const size_t RASTER_BIN_GRAIN = 16384; // fewer primitives than this per binning worker are not worth a thread
+
+// The viewer's colors (glColor4f values in drawBufferRanges() and drawLabels()).
+static const uint32_t LINK_COLOR   = rasterColor(0.45f, 0.45f, 0.45f, 0.55f);
+static const uint32_t CIRCLE_COLOR = rasterColor(0.30f, 0.30f, 0.30f, 0.95f);
+static const uint32_t LABEL_COLOR  = rasterColor(0.10f, 0.10f, 0.10f, 1.00f);
+
+// ---------------------------- Workers ----------------------------
+
+static size_t workerCount(int threads) {
+    if (threads > 0) return size_t(threads);
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+// fn(w) for w in [0, workers), worker 0 on the calling thread.
+template <typename Fn>
+static void runWorkers(size_t workers, Fn fn) {
+    std::vector<std::thread> pool;
+    for (size_t w = 1; w < workers; ++w) pool.emplace_back(fn, w);
+    fn(size_t(0));
+    for (auto& t : pool) t.join();
+}
+
+static double msSince(std::chrono::steady_clock::time_point t0) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+}
+
+// ---------------------------- Binning ----------------------------
+
+// Pixel rectangle [x0, x1) x [y0, y1) a primitive can touch, clipped to the
+// image. False if it misses the image.
+static bool primBounds(const RasterPrim& p, int w, int h, int& x0, int& y0, int& x1, int& y1) {
+    float pad = p.r + 1.0f;
+    auto clampX = [w](float v) { return int(std::clamp(v, -1.0f, float(w) + 1.0f)); };
+    auto clampY = [h](float v) { return int(std::clamp(v, -1.0f, float(h) + 1.0f)); };
+    x0 = std::max(0, clampX(std::floor(std::min(p.x0, p.x1) - pad)));
+    y0 = std::max(0, clampY(std::floor(std::min(p.y0, p.y1) - pad)));
+    x1 = std::min(w, clampX(std::ceil(std::max(p.x0, p.x1) + pad)));
+    y1 = std::min(h, clampY(std::ceil(std::max(p.y0, p.y1) + pad)));
+    return x0 < x1 && y0 < y1;
+}
+
+static float segmentDistance(float px, float py, float x0, float y0, float x1, float y1) {
+    float dx = x1 - x0, dy = y1 - y0;
+    float len2 = dx * dx + dy * dy;
+    float t = len2 > 0.0f ? std::clamp(((px - x0) * dx + (py - y0) * dy) / len2, 0.0f, 1.0f) : 0.0f;
+    float ex = x0 + t * dx - px, ey = y0 + t * dy - py;
+    return std::sqrt(ex * ex + ey * ey);
+}
+
+// Append prim index i to the bins of the tiles it touches. A long diagonal
+// line only goes to the tiles near it, not to its whole bounding box.
+static void binPrim(const RasterPrim& p, uint32_t i, int w, int h, int tilesX,
+                    std::vector<std::vector<uint32_t>>& bins) {
+    int x0, y0, x1, y1;
+    if (!primBounds(p, w, h, x0, y0, x1, y1)) return;
+    int tx0 = x0 / RASTER_TILE, tx1 = (x1 - 1) / RASTER_TILE;
+    int ty0 = y0 / RASTER_TILE, ty1 = (y1 - 1) / RASTER_TILE;
+    bool thin = p.kind == RasterPrim::Line && (tx1 > tx0 + 1 || ty1 > ty0 + 1);
+    const float half = 0.5f * float(RASTER_TILE);
+    const float reach = half * 1.4143f + p.r + 1.0f;
+
+    for (int ty = ty0; ty <= ty1; ++ty) {
+        for (int tx = tx0; tx <= tx1; ++tx) {
+            if (thin) {
+                float cx = float(tx * RASTER_TILE) + half, cy = float(ty * RASTER_TILE) + half;
+                if (segmentDistance(cx, cy, p.x0, p.y0, p.x1, p.y1) > reach) continue;
+            }
+            bins[size_t(ty) * size_t(tilesX) + size_t(tx)].push_back(i);
+        }
+    }
+}
+
+// ---------------------------- Tile Rasterization ----------------------------
+
+struct TileBuffer {
+    int x0, y0, x1, y1;       // pixel rectangle of the tile
+    std::vector<float> rgb;   // RASTER_TILE^2 pixels, linear 0..1 per channel
+
+    float* at(int x, int y) { return &rgb[size_t((y - y0) * RASTER_TILE + (x - x0)) * 3]; }
+};
+
+struct BlendColor {
+    float r, g, b, a;
+    explicit BlendColor(uint32_t c)
+        : r(float(c >> 24) / 255.0f), g(float((c >> 16) & 0xFF) / 255.0f),
+          b(float((c >> 8) & 0xFF) / 255.0f), a(float(c & 0xFF) / 255.0f) {}
+
+    // Source over, as glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA) on an opaque target.
+    void blend(float* d, float coverage) const {
+        float k = a * coverage;
+        d[0] += (r - d[0]) * k;
+        d[1] += (g - d[1]) * k;
+        d[2] += (b - d[2]) * k;
+    }
+};
+
+// Coverage falls off linearly over one pixel across the edge of the line and
+// is cut off square at its ends (one pixel wide box along it), like
+// GL_LINE_SMOOTH: the segments of a strip meet without overlapping, and a
+// segment shorter than a pixel covers no more than its length.
+static void rasterLine(const RasterPrim& p, TileBuffer& t) {
+    int x0, y0, x1, y1;
+    if (!primBounds(p, t.x1, t.y1, x0, y0, x1, y1)) return;
+    x0 = std::max(x0, t.x0);
+    y0 = std::max(y0, t.y0);
+    if (x0 >= x1 || y0 >= y1) return;
+
+    BlendColor c(p.color);
+    float dx = p.x1 - p.x0, dy = p.y1 - p.y0;
+    float len = std::sqrt(dx * dx + dy * dy);
+    if (len <= 0.0f) return;
+    float ux = dx / len, uy = dy / len;
+    float reach = p.r + 0.5f;
+    float spanK = std::fabs(dy) > 1e-6f ? reach * len / std::fabs(dy) : 0.0f;
+
+    for (int y = y0; y < y1; ++y) {
+        float fy = float(y) + 0.5f;
+        int xs = x0, xe = x1;
+        if (spanK > 0.0f) {
+            // Pixel centers within reach of the infinite line on this row.
+            float xc = p.x0 + (fy - p.y0) * dx / dy;
+            xs = std::max(xs, int(std::floor(xc - spanK - 0.5f)));
+            xe = std::min(xe, int(std::ceil(xc + spanK + 0.5f)));
+        }
+        for (int x = xs; x < xe; ++x) {
+            float fx = float(x) + 0.5f;
+            float along = (fx - p.x0) * ux + (fy - p.y0) * uy;
+            float across = std::fabs((fx - p.x0) * uy - (fy - p.y0) * ux);
+            float covAcross = std::min(reach - across, 1.0f);
+            float covAlong = std::min({ along + 0.5f, len - along + 0.5f, len, 1.0f });
+            if (covAcross > 0.0f && covAlong > 0.0f) c.blend(t.at(x, y), covAcross * covAlong);
+        }
+    }
+}
+
+// Point sampled at pixel centers, like the viewer's triangle fans (polygons
+// are not antialiased).
+static void rasterDisc(const RasterPrim& p, TileBuffer& t) {
+    int x0, y0, x1, y1;
+    if (!primBounds(p, t.x1, t.y1, x0, y0, x1, y1)) return;
+    x0 = std::max(x0, t.x0);
+    y0 = std::max(y0, t.y0);
+    if (x0 >= x1 || y0 >= y1) return;
+
+    BlendColor c(p.color);
+    float reach = p.r + 0.5f;
+    for (int y = y0; y < y1; ++y) {
+        float fy = float(y) + 0.5f - p.y0;
+        float h2 = reach * reach - fy * fy;
+        if (h2 <= 0.0f) continue;
+        float half = std::sqrt(h2);
+        int xs = std::max(x0, int(std::floor(p.x0 - half - 0.5f)));
+        int xe = std::min(x1, int(std::ceil(p.x0 + half + 0.5f)));
+        for (int x = xs; x < xe; ++x) {
+            float fx = float(x) + 0.5f - p.x0;
+            if (fx * fx + fy * fy <= p.r * p.r) c.blend(t.at(x, y), 1.0f);
+        }
+    }
+}
+
+RasterStats SoftRaster::render(RasterImage& out, uint32_t background, int threads) const {
+    RasterStats st;
+    st.primitives = prims.size();
+    out.width = width;
+    out.height = height;
+    out.rgba.assign(size_t(width) * size_t(height) * 4, 0);
+    if (width <= 0 || height <= 0) return st;
+
+    int tilesX = (width + RASTER_TILE - 1) / RASTER_TILE;
+    int tilesY = (height + RASTER_TILE - 1) / RASTER_TILE;
+    size_t tiles = size_t(tilesX) * size_t(tilesY);
+    size_t workers = workerCount(threads);
+
+    // Each binning worker takes a contiguous run of primitives and fills its
+    // own bins; a tile walks the workers' bins in order, which is submission order.
+    auto t0 = std::chrono::steady_clock::now();
+    size_t chunks = std::clamp(prims.size() / RASTER_BIN_GRAIN, size_t(1), workers);
+    std::vector<std::vector<std::vector<uint32_t>>> bins(chunks, std::vector<std::vector<uint32_t>>(tiles));
+    runWorkers(chunks, [&](size_t c) {
+        size_t b = prims.size() * c / chunks, e = prims.size() * (c + 1) / chunks;
+        for (size_t i = b; i < e; ++i) binPrim(prims[i], uint32_t(i), width, height, tilesX, bins[c]);
+    });
+    st.binMs = msSince(t0);
+    for (const auto& chunk : bins)
+        for (const auto& bin : chunk) st.binned += bin.size();
+
+    t0 = std::chrono::steady_clock::now();
+    BlendColor bg(background);
+    std::atomic<size_t> next{ 0 };
+    runWorkers(std::min(workers, tiles), [&](size_t) {
+        TileBuffer t;
+        t.rgb.resize(size_t(RASTER_TILE) * RASTER_TILE * 3);
+        for (size_t ti; (ti = next.fetch_add(1)) < tiles; ) {
+            t.x0 = int(ti % size_t(tilesX)) * RASTER_TILE;
+            t.y0 = int(ti / size_t(tilesX)) * RASTER_TILE;
+            t.x1 = std::min(width, t.x0 + RASTER_TILE);
+            t.y1 = std::min(height, t.y0 + RASTER_TILE);
+            for (size_t k = 0; k < t.rgb.size(); k += 3) {
+                t.rgb[k] = bg.r; t.rgb[k + 1] = bg.g; t.rgb[k + 2] = bg.b;
+            }
+
+            for (const auto& chunk : bins) {
+                for (uint32_t i : chunk[ti]) {
+                    const RasterPrim& p = prims[i];
+                    if (p.kind == RasterPrim::Line) rasterLine(p, t);
+                    else                            rasterDisc(p, t);
+                }
+            }
+
+            for (int y = t.y0; y < t.y1; ++y) {
+                uint8_t* row = &out.rgba[(size_t(y) * size_t(width) + size_t(t.x0)) * 4];
+                for (int x = t.x0; x < t.x1; ++x, row += 4) {
+                    const float* s = t.at(x, y);
+                    row[0] = uint8_t(s[0] * 255.0f + 0.5f);
+                    row[1] = uint8_t(s[1] * 255.0f + 0.5f);
+                    row[2] = uint8_t(s[2] * 255.0f + 0.5f);
+                    row[3] = 255;
+                }
+            }
+        }
+    });
+    st.rasterMs = msSince(t0);
+    return st;
+}
+
+// ---------------------------- Map Geometry ----------------------------
+
+// World to pixels: rotate by the view rotation, then center, scale and flip y.
+struct RasterXform {
+    float c, s, cx, cy, ppu, halfW, halfH;
+
+    RasterXform(const RasterView& v, float rotDeg)
+        : c(std::cos(rotDeg * float(M_PI) / 180.0f)), s(std::sin(rotDeg * float(M_PI) / 180.0f)),
+          cx(v.centerX), cy(v.centerY), ppu(v.pixelsPerUnit),
+          halfW(0.5f * float(v.width)), halfH(0.5f * float(v.height)) {}
+
+    void point(float wx, float wy, float& px, float& py) const {
+        px = halfW + (c * wx - s * wy - cx) * ppu;
+        py = halfH - (s * wx + c * wy - cy) * ppu;
+    }
+
+    // Directions (no translation).
+    void direction(float wx, float wy, float& px, float& py) const {
+        px =  (c * wx - s * wy) * ppu;
+        py = -(s * wx + c * wy) * ppu;
+    }
+};
+
+RasterView fitRasterView(const std::vector<Node*>& nodes, const std::vector<std::pair<int, int>>& ranges,
+                         const Node* focus, const MapStyle& style, int width, int height) {
+    RasterView v;
+    v.width = width;
+    v.height = height;
+    float extent = mapExtent(nodes, ranges, focus, style) + 2.0f * style.labelPad;
+    v.pixelsPerUnit = float(std::min(width, height)) / (2.0f * extent);
+    return v;
+}
+
+static bool outsideView(const RasterView& v, float x0, float y0, float x1, float y1, float pad) {
+    return std::max(x0, x1) < -pad || std::min(x0, x1) > float(v.width) + pad ||
+           std::max(y0, y1) < -pad || std::min(y0, y1) > float(v.height) + pad;
+}
+
+// Curved links are flattened in pixel space with about one segment per 8
+// pixels of control polygon, up to bezierSamples (the viewer's tessellation).
+static void rasterLinks(SoftRaster& R, const std::vector<Node*>& nodes,
+                        const std::vector<std::pair<int, int>>& ranges, const Node* focus,
+                        const RasterOptions& opt, const RasterView& view, const RasterXform& X) {
+    forEachSlot(nodes, ranges, [&](const Node* n) {
+        const Node* p = n->parent;
+        if (!p) return;
+        float ax, ay, dx, dy;
+        X.point(p->x, p->y, ax, ay);
+        X.point(n->x, n->y, dx, dy);
+
+        if (!opt.curved || n->depth <= focus->depth) {
+            if (!outsideView(view, ax, ay, dx, dy, 2.0f)) R.line(ax, ay, dx, dy, 1.0f, LINK_COLOR);
+            return;
+        }
+
+        float w1x, w1y, w2x, w2y, bx, by, cx, cy;
+        linkControlPoints(p, n, opt.radiusStep, w1x, w1y, w2x, w2y);
+        X.point(w1x, w1y, bx, by);
+        X.point(w2x, w2y, cx, cy);
+        if (outsideView(view, std::min({ ax, bx, cx, dx }), std::min({ ay, by, cy, dy }),
+                              std::max({ ax, bx, cx, dx }), std::max({ ay, by, cy, dy }), 2.0f))
+            return;
+
+        float poly = std::hypot(bx - ax, by - ay) + std::hypot(cx - bx, cy - by) + std::hypot(dx - cx, dy - cy);
+        int segs = std::clamp(int(std::ceil(poly / 8.0f)), 1, std::max(1, opt.bezierSamples));
+        float px = ax, py = ay;
+        for (int i = 1; i <= segs; ++i) {
+            float t = float(i) / float(segs), u = 1.0f - t;
+            float b0 = u * u * u, b1 = 3 * u * u * t, b2 = 3 * u * t * t, b3 = t * t * t;
+            float qx = b0 * ax + b1 * bx + b2 * cx + b3 * dx;
+            float qy = b0 * ay + b1 * by + b2 * cy + b3 * dy;
+            R.line(px, py, qx, qy, 1.0f, LINK_COLOR);
+            px = qx;
+            py = qy;
+        }
+    });
+}
+
+static void rasterLabels(SoftRaster& R, const std::vector<Node*>& nodes,
+                         const std::vector<std::pair<int, int>>& ranges, const Node* focus,
+                         const RasterOptions& opt, const RasterView& view, const RasterXform& X) {
+    float fontPx = STROKE_ROMAN_HEIGHT * opt.labelScale * view.pixelsPerUnit;
+    if (fontPx < opt.labelMinPx) return;
+
+    forEachSlot(nodes, ranges, [&](const Node* n) {
+        if (!mapLabelWanted(n, focus, opt)) return;
+        if (opt.labelKeep && !(*opt.labelKeep)[size_t(n->index)]) return;
+        float wx, wy, deg;
+        bool end;
+        placeMapLabel(n, focus, opt, wx, wy, deg, end);
+
+        float width = strokeTextWidth(n->text);
+        float ox, oy;
+        X.point(wx, wy, ox, oy);
+        float reach = (width + STROKE_ROMAN_HEIGHT) * opt.labelScale * view.pixelsPerUnit;
+        if (outsideView(view, ox, oy, ox, oy, reach)) return;
+
+        // Stroke units to pixels: baseline direction u, up direction v.
+        float a = deg * float(M_PI) / 180.0f;
+        float ux, uy, vx, vy;
+        X.direction(std::cos(a) * opt.labelScale, std::sin(a) * opt.labelScale, ux, uy);
+        X.direction(-std::sin(a) * opt.labelScale, std::cos(a) * opt.labelScale, vx, vy);
+
+        float pen = end ? -width : 0.0f;
+        for (unsigned char ch : n->text) {
+            forEachStrokeStrip(ch, [&](const float* v, int count) {
+                float lx = 0.0f, ly = 0.0f;
+                for (int k = 0; k < count; ++k) {
+                    float gx = pen + v[2*k], gy = v[2*k + 1];
+                    float qx = ox + gx * ux + gy * vx, qy = oy + gx * uy + gy * vy;
+                    if (k > 0) R.line(lx, ly, qx, qy, 1.0f, LABEL_COLOR);
+                    lx = qx;
+                    ly = qy;
+                }
+            });
+            pen += strokeAdvance(ch);
+        }
+    });
+}
+
+void rasterMap(SoftRaster& raster, const std::vector<Node*>& nodes,
+               const std::vector<std::pair<int, int>>& ranges, const Node* focus,
+               const RasterOptions& opt, const RasterView& view) {
+    RasterXform X(view, opt.rotDeg);
+    rasterLinks(raster, nodes, ranges, focus, opt, view, X);
+
+    float r = opt.endpointRadius * view.pixelsPerUnit;
+    forEachSlot(nodes, ranges, [&](const Node* n) {
+        float x, y;
+        X.point(n->x, n->y, x, y);
+        if (!outsideView(view, x, y, x, y, r + 1.0f)) raster.disc(x, y, r, CIRCLE_COLOR);
+    });
+
+    if (opt.labels) rasterLabels(raster, nodes, ranges, focus, opt, view, X);
+}
+
+// ---------------------------- Tiled Rendering ----------------------------
+
+// Pixel bounds (x0, y0, x1, y1) of everything drawn for the subtree of each
+// placed node, by preorder slot: its link from the parent, its endpoint
+// circle and its label, merged up from the leaves. Slots outside ranges are
+// left empty.
+static std::vector<float> subtreeBounds(const std::vector<Node*>& nodes,
+                                        const std::vector<std::pair<int, int>>& ranges, const Node* focus,
+                                        const RasterOptions& opt, const RasterView& view, const RasterXform& X) {
+    std::vector<float> b(nodes.size() * 4);
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        b[4*i] = b[4*i + 1] = 1e30f;
+        b[4*i + 2] = b[4*i + 3] = -1e30f;
+    }
+    auto grow = [&](size_t i, float x0, float y0, float x1, float y1) {
+        b[4*i]     = std::min(b[4*i], x0);
+        b[4*i + 1] = std::min(b[4*i + 1], y0);
+        b[4*i + 2] = std::max(b[4*i + 2], x1);
+        b[4*i + 3] = std::max(b[4*i + 3], y1);
+    };
+
+    float disc = opt.endpointRadius * view.pixelsPerUnit + 1.0f;
+    float fontPx = STROKE_ROMAN_HEIGHT * opt.labelScale * view.pixelsPerUnit;
+    bool labels = opt.labels && fontPx >= opt.labelMinPx;
+
+    // Reverse preorder: children are merged into their parent before it is
+    // merged into its own parent.
+    for (auto r = ranges.rbegin(); r != ranges.rend(); ++r) {
+        for (int slot = r->second - 1; slot >= r->first; --slot) {
+            const Node* n = nodes[size_t(slot)];
+            size_t i = size_t(slot);
+            float x, y;
+            X.point(n->x, n->y, x, y);
+            grow(i, x - disc, y - disc, x + disc, y + disc);
+
+            if (const Node* p = n->parent) {
+                float ax, ay;
+                X.point(p->x, p->y, ax, ay);
+                grow(i, std::min(ax, x) - 2.0f, std::min(ay, y) - 2.0f, std::max(ax, x) + 2.0f, std::max(ay, y) + 2.0f);
+                if (opt.curved && n->depth > focus->depth) {
+                    float w1x, w1y, w2x, w2y, bx, by, cx, cy;
+                    linkControlPoints(p, n, opt.radiusStep, w1x, w1y, w2x, w2y);
+                    X.point(w1x, w1y, bx, by);
+                    X.point(w2x, w2y, cx, cy);
+                    grow(i, std::min(bx, cx) - 2.0f, std::min(by, cy) - 2.0f, std::max(bx, cx) + 2.0f, std::max(by, cy) + 2.0f);
+                }
+            }
+
+            if (labels && mapLabelWanted(n, focus, opt) && (!opt.labelKeep || (*opt.labelKeep)[i])) {
+                float wx, wy, deg, ox, oy;
+                bool end;
+                placeMapLabel(n, focus, opt, wx, wy, deg, end);
+                X.point(wx, wy, ox, oy);
+                float reach = (strokeTextWidth(n->text) + STROKE_ROMAN_HEIGHT) * opt.labelScale * view.pixelsPerUnit;
+                grow(i, ox - reach, oy - reach, ox + reach, oy + reach);
+            }
+
+            if (n->parent) {
+                size_t p = size_t(n->parent->index);
+                grow(p, b[4*i], b[4*i + 1], b[4*i + 2], b[4*i + 3]);
+            }
+        }
+    }
+    return b;
+}
+
+RasterTiler::RasterTiler(const std::vector<Node*>& nodes_, const std::vector<std::pair<int, int>>& ranges_,
+                         const Node* focus_, const RasterOptions& opt_, const RasterView& view_)
+    : nodes(nodes_), ranges(ranges_), focus(focus_), opt(opt_), view(view_),
+      bounds(subtreeBounds(nodes_, ranges_, focus_, opt_, view_, RasterXform(view_, opt_.rotDeg))) {}
+
+RasterView RasterTiler::tileView(int x0, int y0, int w, int h) const {
+    RasterView tv = view;
+    tv.width = w;
+    tv.height = h;
+    tv.centerX = view.centerX + (float(x0) + 0.5f * float(w - view.width)) / view.pixelsPerUnit;
+    tv.centerY = view.centerY - (float(y0) + 0.5f * float(h - view.height)) / view.pixelsPerUnit;
+    return tv;
+}
+
+// A subtree that misses the rectangle is skipped whole.
+bool RasterTiler::cull(float x0, float y0, float x1, float y1, std::vector<std::pair<int, int>>& out) const {
+    out.clear();
+    int skip = 0;
+    for (const auto& r : ranges) {
+        for (int i = std::max(r.first, skip); i < r.second; ) {
+            const float* b = &bounds[size_t(i) * 4];
+            if (b[2] < x0 || b[0] > x1 || b[3] < y0 || b[1] > y1) {
+                i = skip = std::max(i + 1, nodes[size_t(i)]->subtreeEnd);
+                continue;
+            }
+            if (!out.empty() && out.back().second == i) ++out.back().second;
+            else                                         out.push_back({ i, i + 1 });
+            ++i;
+        }
+    }
+    return !out.empty();
+}
+
+bool RasterTiler::render(int x0, int y0, int w, int h, SoftRaster& raster, RasterImage& image,
+                         std::vector<std::pair<int, int>>& visible) const {
+    if (!cull(float(x0), float(y0), float(x0 + w), float(y0 + h), visible)) return false;
+    raster.width = w;
+    raster.height = h;
+    raster.prims.clear();
+    rasterMap(raster, nodes, visible, focus, opt, tileView(x0, y0, w, h));
+    raster.render(image, rasterColor(1.0f, 1.0f, 1.0f, 1.0f), 1);
+    return true;
+}
+
+bool writePosterTiff(const char* path, const std::vector<Node*>& nodes,
+                     const std::vector<std::pair<int, int>>& ranges, const Node* focus,
+                     const RasterOptions& opt, const RasterView& view, int tileSize) {
+    TiledTiffWriter tiff;
+    if (!tiff.open(path, view.width, view.height, tileSize)) return false;
+
+    RasterTiler tiler(nodes, ranges, focus, opt, view);
+    std::vector<uint8_t> blank(size_t(tileSize) * size_t(tileSize) * 4, 255);
+    size_t tiles = size_t(tiff.tilesX) * size_t(tiff.tilesY);
+    std::atomic<size_t> next{ 0 };
+    std::atomic<bool> ok{ true };
+    runWorkers(std::min(workerCount(opt.threads), tiles), [&](size_t) {
+        SoftRaster raster(tileSize, tileSize);
+        RasterImage image;
+        std::vector<std::pair<int, int>> visible;
+        for (size_t ti; ok && (ti = next.fetch_add(1)) < tiles; ) {
+            int tx = int(ti % size_t(tiff.tilesX)), ty = int(ti / size_t(tiff.tilesX));
+            bool drawn = tiler.render(tx * tileSize, ty * tileSize, tileSize, tileSize, raster, image, visible);
+            if (!tiff.writeTile(tx, ty, drawn ? image.rgba.data() : blank.data())) ok = false;
+        }
+    });
+    return tiff.close() && ok;
+}
+
+// ---------------------------- Rotation Frames ----------------------------
+
+bool writeRotationFrames(const std::string& prefix, const std::vector<Node*>& nodes,
+                         const std::vector<std::pair<int, int>>& ranges, const Node* focus,
+                         const RasterOptions& opt, const RasterView& view, int frames) {
+    if (frames <= 0) return true;
+
+    // Links and circles at the start rotation, around the world origin's
+    // pixel (which rotation keeps in place), in a square view that holds
+    // whatever any rotation can bring into the frame.
+    float ox = 0.5f * float(view.width) - view.centerX * view.pixelsPerUnit;
+    float oy = 0.5f * float(view.height) + view.centerY * view.pixelsPerUnit;
+    float reach = 0.0f;
+    for (float cx : { 0.0f, float(view.width) })
+        for (float cy : { 0.0f, float(view.height) }) reach = std::max(reach, std::hypot(cx - ox, cy - oy));
+    RasterView around = view;
+    around.width = around.height = 2 * int(std::ceil(reach)) + 4;
+    around.centerX = around.centerY = 0.0f;
+    SoftRaster shared(around.width, around.height);
+    RasterOptions geometry = opt;
+    geometry.labels = false;
+    rasterMap(shared, nodes, ranges, focus, geometry, around);
+    float half = 0.5f * float(around.width);
+
+    int digits = std::max(5, int(std::to_string(frames - 1).size()));
+    std::atomic<int> next{ 0 };
+    std::atomic<bool> ok{ true };
+    runWorkers(std::min(workerCount(opt.threads), size_t(frames)), [&](size_t) {
+        SoftRaster raster(view.width, view.height);
+        RasterImage image;
+        for (int k; ok && (k = next.fetch_add(1)) < frames; ) {
+            RasterOptions frame = opt;
+            frame.rotDeg = opt.rotDeg + 360.0f * float(k) / float(frames);
+            float a = (frame.rotDeg - opt.rotDeg) * float(M_PI) / 180.0f;
+            float c = std::cos(a), s = std::sin(a);
+
+            // Pixel y points down, so a counterclockwise turn of the map is
+            // (u, v) -> (c u + s v, -s u + c v) here.
+            raster.prims.clear();
+            for (const RasterPrim& p : shared.prims) {
+                RasterPrim q = p;
+                float u0 = p.x0 - half, v0 = p.y0 - half, u1 = p.x1 - half, v1 = p.y1 - half;
+                q.x0 = ox + c * u0 + s * v0;
+                q.y0 = oy - s * u0 + c * v0;
+                q.x1 = ox + c * u1 + s * v1;
+                q.y1 = oy - s * u1 + c * v1;
+                if (!outsideView(view, q.x0, q.y0, q.x1, q.y1, q.r + 1.0f)) raster.prims.push_back(q);
+            }
+            if (opt.labels) rasterLabels(raster, nodes, ranges, focus, frame, view, RasterXform(view, frame.rotDeg));
+            raster.render(image, rasterColor(1.0f, 1.0f, 1.0f, 1.0f), 1);
+
+            std::string number = std::to_string(k);
+            std::string path = prefix + "-" + std::string(size_t(digits) - number.size(), '0') + number + ".png";
+            if (!writePng(path.c_str(), image.rgba.data(), image.width, image.height, false, 1)) ok = false;
+        }
+    });
+    return ok;
+}
+
+// ---------------------------- Label Decluttering ----------------------------
+
+std::vector<uint8_t> declutterMapLabels(const std::vector<Node*>& nodes,
+                                        const std::vector<std::pair<int, int>>& ranges, const Node* focus,
+                                        const RasterOptions& opt, const RasterView& view) {
+    std::vector<uint8_t> keep(nodes.size(), 0);
+    float pxPerStroke = opt.labelScale * view.pixelsPerUnit;
+    if (!opt.labels || STROKE_ROMAN_HEIGHT * pxPerStroke < opt.labelMinPx) return keep;
+
+    // Priority: the focus, then shallow before deep, large subtrees first, preorder.
+    std::vector<const Node*> order;
+    forEachSlot(nodes, ranges, [&](const Node* n) { if (mapLabelWanted(n, focus, opt)) order.push_back(n); });
+    std::stable_sort(order.begin(), order.end(), [focus](const Node* a, const Node* b) {
+        if ((a == focus) != (b == focus)) return a == focus;
+        if (a->depth != b->depth) return a->depth < b->depth;
+        return a->leafCount > b->leafCount;
+    });
+
+    RasterXform X(view, opt.rotDeg);
+    std::vector<LabelBox> boxes;
+    std::unordered_map<uint64_t, std::vector<uint32_t>> grid;
+    auto cells = [](const LabelBox& b, int& c0, int& r0, int& c1, int& r1) {
+        float ex, ey;
+        labelBoxBounds(b, ex, ey);
+        c0 = int(std::floor((b.cx - ex) / LABEL_GRID_CELL_PX));
+        r0 = int(std::floor((b.cy - ey) / LABEL_GRID_CELL_PX));
+        c1 = int(std::floor((b.cx + ex) / LABEL_GRID_CELL_PX));
+        r1 = int(std::floor((b.cy + ey) / LABEL_GRID_CELL_PX));
+    };
+    auto cellKey = [](int c, int r) { return uint64_t(uint32_t(r)) << 32 | uint32_t(c); };
+
+    for (const Node* n : order) {
+        float wx, wy, deg, ox, oy;
+        bool end;
+        placeMapLabel(n, focus, opt, wx, wy, deg, end);
+        X.point(wx, wy, ox, oy);
+
+        // Baseline and up directions in pixels (y points down).
+        float a = deg * float(M_PI) / 180.0f;
+        float ux, uy, vx, vy;
+        X.direction(std::cos(a), std::sin(a), ux, uy);
+        X.direction(-std::sin(a), std::cos(a), vx, vy);
+        float ul = std::hypot(ux, uy), vl = std::hypot(vx, vy);
+        ux /= ul; uy /= ul; vx /= vl; vy /= vl;
+
+        float len = strokeTextWidth(n->text) * pxPerStroke;
+        LabelBox box = labelTextBox(ox, oy, ux, uy, vx, vy, end ? -len : 0.0f, end ? 0.0f : len, pxPerStroke);
+
+        int c0, r0, c1, r1;
+        cells(box, c0, r0, c1, r1);
+        bool hit = false;
+        for (int r = r0; r <= r1 && !hit; ++r)
+            for (int c = c0; c <= c1 && !hit; ++c) {
+                auto it = grid.find(cellKey(c, r));
+                if (it == grid.end()) continue;
+                for (uint32_t k : it->second)
+                    if (labelBoxesOverlap(box, boxes[k])) { hit = true; break; }
+            }
+        if (hit) continue;
+
+        keep[size_t(n->index)] = 1;
+        for (int r = r0; r <= r1; ++r)
+            for (int c = c0; c <= c1; ++c) grid[cellKey(c, r)].push_back(uint32_t(boxes.size()));
+        boxes.push_back(box);
+    }
+    return keep;
+}
+
+// ---------------------------- Output ----------------------------
+
+bool writePam(const char* path, const RasterImage& image) {
+    FILE* f = std::fopen(path, "wb");
+    if (!f) { std::fprintf(stderr, "Cannot write %s\n", path); return false; }
+    std::fprintf(f, "P7\nWIDTH %d\nHEIGHT %d\nDEPTH 4\nMAXVAL 255\nTUPLTYPE RGB_ALPHA\nENDHDR\n",
+                 image.width, image.height);
+    bool ok = std::fwrite(image.rgba.data(), 1, image.rgba.size(), f) == image.rgba.size();
+    ok = (std::fclose(f) == 0) && ok;
+    if (!ok) std::fprintf(stderr, "Error writing %s\n", path);
+    return ok;
+}
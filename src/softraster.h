@@ -0,0 +1,151 @@
+// softraster.h - multi-threaded software rasterizer for map geometry.
+//
+// Draws what the viewer draws with GL (antialiased lines of a given width,
+// filled circles and stroke-font labels) into an RGBA8 image, without a GPU
+// or a display. Primitives are recorded in pixel coordinates, binned into
+// square tiles by worker threads and the tiles are then rasterized in
+// parallel. Every tile blends its primitives in submission order, so the
+// image does not depend on the number of threads.
+
+#ifndef SOFTRASTER_H
+#define SOFTRASTER_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <utility>
+
+#include "mindmap.h"
+
+// 0xRRGGBBAA
+constexpr uint32_t rasterColor(float r, float g, float b, float a) {
+    return (uint32_t(r * 255.0f + 0.5f) << 24) | (uint32_t(g * 255.0f + 0.5f) << 16) |
+           (uint32_t(b * 255.0f + 0.5f) << 8)  |  uint32_t(a * 255.0f + 0.5f);
+}
+
+struct RasterImage {
+    int width = 0, height = 0;
+    std::vector<uint8_t> rgba; // row-major, top row first, 4 bytes per pixel
+};
+
+struct RasterPrim {
+    enum Kind : uint8_t { Line, Disc };
+    Kind kind;
+    float x0, y0, x1, y1;  // line: endpoints; disc: center in (x0, y0)
+    float r;               // line: half width; disc: radius (pixels)
+    uint32_t color;
+};
+
+struct RasterStats {
+    size_t primitives = 0;
+    size_t binned = 0;      // primitive/tile pairs
+    double binMs = 0.0, rasterMs = 0.0;
+};
+
+struct SoftRaster {
+    int width, height;
+    std::vector<RasterPrim> prims;
+
+    SoftRaster(int w, int h) : width(w), height(h) {}
+
+    // Pixel coordinates, y down; (0, 0) is the top left corner of the image.
+    void line(float x0, float y0, float x1, float y1, float widthPx, uint32_t color) {
+        prims.push_back({ RasterPrim::Line, x0, y0, x1, y1, 0.5f * widthPx, color });
+    }
+    void disc(float cx, float cy, float r, uint32_t color) {
+        prims.push_back({ RasterPrim::Disc, cx, cy, cx, cy, r, color });
+    }
+
+    // Rasterize everything recorded so far over an opaque background
+    // (threads <= 0: one per core).
+    RasterStats render(RasterImage& out, uint32_t background, int threads) const;
+};
+
+// World to pixels: the view rotation is MapStyle::rotDeg, then (centerX,
+// centerY) of the rotated map lands in the middle of the image.
+struct RasterView {
+    int width = 1024, height = 1024;
+    float centerX = 0.0f, centerY = 0.0f;
+    float pixelsPerUnit = 1.0f;
+};
+
+struct RasterOptions : MapStyle {
+    int   bezierSamples = 28;   // most segments per curved link (short links get fewer)
+    float labelMinPx    = 5.0f; // labels smaller than this (font height, pixels) are skipped
+    int   threads       = 0;    // render workers (0: one per core)
+    const std::vector<uint8_t>* labelKeep = nullptr; // by preorder slot: draw this label (nullptr: all)
+};
+
+// A view of width x height pixels that fits everything mapExtent() covers.
+RasterView fitRasterView(const std::vector<Node*>& nodes, const std::vector<std::pair<int, int>>& ranges,
+                         const Node* focus, const MapStyle& style, int width, int height);
+
+// Record the links, endpoint circles and labels of the nodes in ranges with
+// the viewer's colors and line widths. Geometry outside the view is dropped.
+void rasterMap(SoftRaster& raster, const std::vector<Node*>& nodes,
+               const std::vector<std::pair<int, int>>& ranges, const Node* focus,
+               const RasterOptions& opt, const RasterView& view);
+
+// A view rendered in pieces (posters, tile pyramids). The pixel bounds of
+// everything drawn for each placed subtree are computed once, so that a tile
+// records only the subtrees that reach it. Const methods are thread-safe.
+struct RasterTiler {
+    const std::vector<Node*>& nodes;
+    const std::vector<std::pair<int, int>>& ranges;
+    const Node* focus;
+    const RasterOptions& opt;
+    RasterView view;
+    std::vector<float> bounds; // x0, y0, x1, y1 per preorder slot (view pixels)
+
+    RasterTiler(const std::vector<Node*>& nodes, const std::vector<std::pair<int, int>>& ranges,
+                const Node* focus, const RasterOptions& opt, const RasterView& view);
+
+    // The view shifted so that view pixel (x0, y0) is the corner of a w x h image.
+    RasterView tileView(int x0, int y0, int w, int h) const;
+
+    // The slots of ranges whose subtrees reach the view pixel rectangle
+    // [x0, x1) x [y0, y1), as ranges. False if there are none.
+    bool cull(float x0, float y0, float x1, float y1, std::vector<std::pair<int, int>>& out) const;
+
+    // The w x h pixels at (x0, y0) on a white background, on the calling
+    // thread (raster and visible are scratch space). Returns false, leaving
+    // image untouched, if nothing is drawn there.
+    bool render(int x0, int y0, int w, int h, SoftRaster& raster, RasterImage& image,
+                std::vector<std::pair<int, int>>& visible) const;
+};
+
+// The labels rasterMap() draws in a view, minus those that would overlap a
+// label of higher priority (the focus, then shallower nodes, then larger
+// subtrees), as the viewer declutters them (without truncation). By preorder
+// slot, for RasterOptions::labelKeep.
+std::vector<uint8_t> declutterMapLabels(const std::vector<Node*>& nodes,
+                                        const std::vector<std::pair<int, int>>& ranges, const Node* focus,
+                                        const RasterOptions& opt, const RasterView& view);
+
+// Render a view of any size (a wall poster) tile by tile into a tiled TIFF
+// (tiffwriter.h) on a white background. Every tile records only the subtrees
+// whose drawn bounds reach it and is written out as soon as it is done, so
+// memory holds one tile per worker (opt.threads) whatever the view size.
+// tileSize must be a multiple of 16. Returns false (after a message on
+// stderr) if the file cannot be written.
+bool writePosterTiff(const char* path, const std::vector<Node*>& nodes,
+                     const std::vector<std::pair<int, int>>& ranges, const Node* focus,
+                     const RasterOptions& opt, const RasterView& view, int tileSize);
+
+// A full turn of the view as an image sequence (the viewer's rotation
+// animation): frame k is the view rotated by a further 360 * k / frames
+// degrees, written to <prefix>-<k>.png with k zero-padded to five digits.
+// Links and endpoint circles are recorded once and rotated in pixel space for
+// every frame; labels, whose flips follow the rotation, are recorded per
+// frame. Each of opt.threads workers renders and encodes whole frames, one at
+// a time. Returns false (after a message on stderr) if a frame cannot be
+// written.
+bool writeRotationFrames(const std::string& prefix, const std::vector<Node*>& nodes,
+                         const std::vector<std::pair<int, int>>& ranges, const Node* focus,
+                         const RasterOptions& opt, const RasterView& view, int frames);
+
+// Binary PAM (netpbm, RGB_ALPHA). Returns false (after a message on stderr)
+// if the file cannot be written.
+bool writePam(const char* path, const RasterImage& image);
+
+#endif // SOFTRASTER_H
@@ -0,0 +1,505 @@
+// Roman stroke font (the glyphs of GLUT_STROKE_ROMAN) as compile-time tables,
+// so label text can be measured and drawn without GLUT or a GL context.
+//
+// Glyph data from freeglut's fg_stroke_roman.c:
+//   Copyright (c) 1999-2000 Pawel W. Olszta. All Rights Reserved.
+//   Permission is hereby granted, free of charge, to any person obtaining a copy
+//   of this software and associated documentation files (the "Software"), to
+//   deal in the Software without restriction, including without limitation the
+//   rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+//   sell copies of the Software, and to permit persons to whom the Software is
+//   furnished to do so, subject to the following conditions: The above copyright
+//   notice and this permission notice shall be included in all copies or
+//   substantial portions of the Software.
+//
+// Units are GLUT stroke units: the baseline is y = 0, capitals are about 119
+// high and the font height (ascent + descent) is STROKE_ROMAN_HEIGHT.
+
+#ifndef STROKEFONT_H
+#define STROKEFONT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+struct StrokeGlyph {
+    float advance;          // pen advance after the glyph
+    uint16_t firstStrip;    // into STROKE_ROMAN_STRIPS
+    uint16_t stripCount;
+};
+
+struct StrokeStrip {
+    uint16_t firstVertex;   // into STROKE_ROMAN_VERTS; one line strip
+    uint16_t vertexCount;
+};
+
+constexpr float STROKE_ROMAN_HEIGHT  = 152.381f;
+constexpr float STROKE_ROMAN_ASCENT  = 119.05f;  // above the baseline
+constexpr float STROKE_ROMAN_DESCENT = 33.33f;   // below it
+
+constexpr StrokeGlyph STROKE_ROMAN_GLYPHS[128] = {
+    { 0.0f, 0, 0 },  // 0x00
+    { 0.0f, 0, 0 },  // 0x01
+    { 0.0f, 0, 0 },  // 0x02
+    { 0.0f, 0, 0 },  // 0x03
+    { 0.0f, 0, 0 },  // 0x04
+    { 0.0f, 0, 0 },  // 0x05
+    { 0.0f, 0, 0 },  // 0x06
+    { 0.0f, 0, 0 },  // 0x07
+    { 0.0f, 0, 0 },  // 0x08
+    { 0.0f, 0, 0 },  // 0x09
+    { 0.0f, 0, 0 },  // 0x0a
+    { 0.0f, 0, 0 },  // 0x0b
+    { 0.0f, 0, 0 },  // 0x0c
+    { 0.0f, 0, 0 },  // 0x0d
+    { 0.0f, 0, 0 },  // 0x0e
+    { 0.0f, 0, 0 },  // 0x0f
+    { 0.0f, 0, 0 },  // 0x10
+    { 0.0f, 0, 0 },  // 0x11
+    { 0.0f, 0, 0 },  // 0x12
+    { 0.0f, 0, 0 },  // 0x13
+    { 0.0f, 0, 0 },  // 0x14
+    { 0.0f, 0, 0 },  // 0x15
+    { 0.0f, 0, 0 },  // 0x16
+    { 0.0f, 0, 0 },  // 0x17
+    { 0.0f, 0, 0 },  // 0x18
+    { 0.0f, 0, 0 },  // 0x19
+    { 0.0f, 0, 0 },  // 0x1a
+    { 0.0f, 0, 0 },  // 0x1b
+    { 0.0f, 0, 0 },  // 0x1c
+    { 0.0f, 0, 0 },  // 0x1d
+    { 0.0f, 0, 0 },  // 0x1e
+    { 0.0f, 0, 0 },  // 0x1f
+    { 104.762f, 0, 0 },  // ' '
+    { 26.6238f, 0, 2 },  // '!'
+    { 51.4352f, 2, 2 },  // '"'
+    { 79.4886f, 4, 4 },  // '#'
+    { 76.2067f, 8, 3 },  // '$'
+    { 96.5743f, 11, 3 },  // '%'
+    { 101.758f, 14, 1 },  // '&'
+    { 13.62f, 15, 1 },  // "'"
+    { 47.1733f, 16, 1 },  // '('
+    { 47.5333f, 17, 1 },  // ')'
+    { 59.439f, 18, 3 },  // '*'
+    { 97.2543f, 21, 2 },  // '+'
+    { 26.0638f, 23, 1 },  // ','
+    { 100.754f, 24, 1 },  // '-'
+    { 26.4838f, 25, 1 },  // '.'
+    { 82.1067f, 26, 1 },  // '/'
+    { 77.0667f, 27, 1 },  // '0'
+    { 66.5295f, 28, 1 },  // '1'
+    { 77.6467f, 29, 1 },  // '2'
+    { 77.0467f, 30, 1 },  // '3'
+    { 80.1686f, 31, 2 },  // '4'
+    { 77.6867f, 33, 1 },  // '5'
+    { 73.8048f, 34, 1 },  // '6'
+    { 77.2267f, 35, 2 },  // '7'
+    { 77.6667f, 37, 1 },  // '8'
+    { 74.0648f, 38, 1 },  // '9'
+    { 26.2238f, 39, 2 },  // ':'
+    { 26.3038f, 41, 2 },  // ';'
+    { 81.6105f, 43, 1 },  // '<'
+    { 97.2543f, 44, 2 },  // '='
+    { 81.6105f, 46, 1 },  // '>'
+    { 73.9029f, 47, 2 },  // '?'
+    { 74.3648f, 49, 2 },  // '@'
+    { 80.4905f, 51, 3 },  // 'A'
+    { 83.6267f, 54, 3 },  // 'B'
+    { 84.4886f, 57, 1 },  // 'C'
+    { 85.2867f, 58, 2 },  // 'D'
+    { 78.1848f, 60, 4 },  // 'E'
+    { 78.7448f, 64, 3 },  // 'F'
+    { 89.7686f, 67, 2 },  // 'G'
+    { 89.0867f, 69, 3 },  // 'H'
+    { 21.3f, 72, 1 },  // 'I'
+    { 59.999f, 73, 1 },  // 'J'
+    { 79.3267f, 74, 3 },  // 'K'
+    { 71.3229f, 77, 2 },  // 'L'
+    { 97.2105f, 79, 4 },  // 'M'
+    { 88.8067f, 83, 3 },  // 'N'
+    { 88.8305f, 86, 1 },  // 'O'
+    { 85.6667f, 87, 2 },  // 'P'
+    { 88.0905f, 89, 2 },  // 'Q'
+    { 82.3667f, 91, 3 },  // 'R'
+    { 80.8267f, 94, 1 },  // 'S'
+    { 71.9467f, 95, 2 },  // 'T'
+    { 89.4867f, 97, 1 },  // 'U'
+    { 81.6105f, 98, 2 },  // 'V'
+    { 100.518f, 100, 4 },  // 'W'
+    { 72.3667f, 104, 2 },  // 'X'
+    { 79.6505f, 106, 2 },  // 'Y'
+    { 73.7467f, 108, 3 },  // 'Z'
+    { 46.1133f, 111, 4 },  // '['
+    { 78.2067f, 115, 1 },  // backslash
+    { 46.3933f, 116, 4 },  // ']'
+    { 90.2305f, 120, 2 },  // '^'
+    { 104.062f, 122, 1 },  // '_'
+    { 83.5714f, 123, 2 },  // '`'
+    { 66.6029f, 125, 2 },  // 'a'
+    { 70.4629f, 127, 2 },  // 'b'
+    { 68.9229f, 129, 1 },  // 'c'
+    { 70.2629f, 130, 2 },  // 'd'
+    { 68.5229f, 132, 1 },  // 'e'
+    { 38.6552f, 133, 2 },  // 'f'
+    { 70.9829f, 135, 2 },  // 'g'
+    { 71.021f, 137, 2 },  // 'h'
+    { 28.8638f, 139, 2 },  // 'i'
+    { 36.2314f, 141, 2 },  // 'j'
+    { 62.521f, 143, 3 },  // 'k'
+    { 19.34f, 146, 1 },  // 'l'
+    { 123.962f, 147, 3 },  // 'm'
+    { 70.881f, 150, 2 },  // 'n'
+    { 71.7448f, 152, 1 },  // 'o'
+    { 70.8029f, 153, 2 },  // 'p'
+    { 70.7429f, 155, 2 },  // 'q'
+    { 49.4952f, 157, 2 },  // 'r'
+    { 62.321f, 159, 1 },  // 's'
+    { 39.3152f, 160, 2 },  // 't'
+    { 71.161f, 162, 2 },  // 'u'
+    { 60.6029f, 164, 2 },  // 'v'
+    { 80.4905f, 166, 4 },  // 'w'
+    { 56.401f, 170, 2 },  // 'x'
+    { 66.0648f, 172, 2 },  // 'y'
+    { 61.821f, 174, 3 },  // 'z'
+    { 41.6295f, 177, 3 },  // '{'
+    { 23.78f, 180, 1 },  // '|'
+    { 41.4695f, 181, 3 },  // '}'
+    { 91.2743f, 184, 2 },  // '~'
+    { 66.6667f, 186, 2 },  // 0x7f
+};
+
+constexpr StrokeStrip STROKE_ROMAN_STRIPS[188] = {
+    { 0, 2 }, { 2, 5 }, { 7, 2 }, { 9, 2 }, { 11, 2 }, { 13, 2 },
+    { 15, 2 }, { 17, 2 }, { 19, 2 }, { 21, 2 }, { 23, 20 }, { 43, 2 },
+    { 45, 16 }, { 61, 11 }, { 72, 34 }, { 106, 2 }, { 108, 10 }, { 118, 10 },
+    { 128, 2 }, { 130, 2 }, { 132, 2 }, { 134, 2 }, { 136, 2 }, { 138, 8 },
+    { 146, 2 }, { 148, 5 }, { 153, 2 }, { 155, 17 }, { 172, 4 }, { 176, 14 },
+    { 190, 15 }, { 205, 3 }, { 208, 2 }, { 210, 17 }, { 227, 23 }, { 250, 2 },
+    { 252, 2 }, { 254, 29 }, { 283, 23 }, { 306, 5 }, { 311, 5 }, { 316, 5 },
+    { 321, 8 }, { 329, 3 }, { 332, 2 }, { 334, 2 }, { 336, 3 }, { 339, 14 },
+    { 353, 5 }, { 358, 8 }, { 366, 19 }, { 385, 2 }, { 387, 2 }, { 389, 2 },
+    { 391, 2 }, { 393, 9 }, { 402, 10 }, { 412, 18 }, { 430, 2 }, { 432, 12 },
+    { 444, 2 }, { 446, 2 }, { 448, 2 }, { 450, 2 }, { 452, 2 }, { 454, 2 },
+    { 456, 2 }, { 458, 19 }, { 477, 2 }, { 479, 2 }, { 481, 2 }, { 483, 2 },
+    { 485, 2 }, { 487, 10 }, { 497, 2 }, { 499, 2 }, { 501, 2 }, { 503, 2 },
+    { 505, 2 }, { 507, 2 }, { 509, 2 }, { 511, 2 }, { 513, 2 }, { 515, 2 },
+    { 517, 2 }, { 519, 2 }, { 521, 21 }, { 542, 2 }, { 544, 10 }, { 554, 21 },
+    { 575, 2 }, { 577, 2 }, { 579, 10 }, { 589, 2 }, { 591, 20 }, { 611, 2 },
+    { 613, 2 }, { 615, 10 }, { 625, 2 }, { 627, 2 }, { 629, 2 }, { 631, 2 },
+    { 633, 2 }, { 635, 2 }, { 637, 2 }, { 639, 2 }, { 641, 3 }, { 644, 2 },
+    { 646, 2 }, { 648, 2 }, { 650, 2 }, { 652, 2 }, { 654, 2 }, { 656, 2 },
+    { 658, 2 }, { 660, 2 }, { 662, 2 }, { 664, 2 }, { 666, 2 }, { 668, 2 },
+    { 670, 2 }, { 672, 2 }, { 674, 5 }, { 679, 2 }, { 681, 3 }, { 684, 2 },
+    { 686, 14 }, { 700, 2 }, { 702, 14 }, { 716, 14 }, { 730, 2 }, { 732, 14 },
+    { 746, 17 }, { 763, 5 }, { 768, 2 }, { 770, 7 }, { 777, 14 }, { 791, 2 },
+    { 793, 7 }, { 800, 5 }, { 805, 2 }, { 807, 5 }, { 812, 5 }, { 817, 2 },
+    { 819, 2 }, { 821, 2 }, { 823, 2 }, { 825, 2 }, { 827, 7 }, { 834, 7 },
+    { 841, 2 }, { 843, 7 }, { 850, 17 }, { 867, 2 }, { 869, 14 }, { 883, 2 },
+    { 885, 14 }, { 899, 2 }, { 901, 5 }, { 906, 17 }, { 923, 5 }, { 928, 2 },
+    { 930, 7 }, { 937, 2 }, { 939, 2 }, { 941, 2 }, { 943, 2 }, { 945, 2 },
+    { 947, 2 }, { 949, 2 }, { 951, 2 }, { 953, 2 }, { 955, 2 }, { 957, 6 },
+    { 963, 2 }, { 965, 2 }, { 967, 2 }, { 969, 10 }, { 979, 17 }, { 996, 10 },
+    { 1006, 2 }, { 1008, 10 }, { 1018, 17 }, { 1035, 10 }, { 1045, 11 }, { 1056, 11 },
+    { 1067, 2 }, { 1069, 17 },
+};
+
+constexpr float STROKE_ROMAN_VERTS[1086][2] = {
+    { 13.3819f, 100.0f }, { 13.3819f, 33.3333f }, { 13.3819f, 9.5238f }, { 8.62f, 4.7619f },
+    { 13.3819f, 0.0f }, { 18.1438f, 4.7619f }, { 13.3819f, 9.5238f }, { 4.02f, 100.0f },
+    { 4.02f, 66.6667f }, { 42.1152f, 100.0f }, { 42.1152f, 66.6667f }, { 41.2952f, 119.048f },
+    { 7.9619f, -33.3333f }, { 69.8667f, 119.048f }, { 36.5333f, -33.3333f }, { 7.9619f, 57.1429f },
+    { 74.6286f, 57.1429f }, { 3.2f, 28.5714f }, { 69.8667f, 28.5714f }, { 28.6295f, 119.048f },
+    { 28.6295f, -19.0476f }, { 47.6771f, 119.048f }, { 47.6771f, -19.0476f }, { 71.4867f, 85.7143f },
+    { 61.9629f, 95.2381f }, { 47.6771f, 100.0f }, { 28.6295f, 100.0f }, { 14.3438f, 95.2381f },
+    { 4.82f, 85.7143f }, { 4.82f, 76.1905f }, { 9.5819f, 66.6667f }, { 14.3438f, 61.9048f },
+    { 23.8676f, 57.1429f }, { 52.439f, 47.619f }, { 61.9629f, 42.8571f }, { 66.7248f, 38.0952f },
+    { 71.4867f, 28.5714f }, { 71.4867f, 14.2857f }, { 61.9629f, 4.7619f }, { 47.6771f, 0.0f },
+    { 28.6295f, 0.0f }, { 14.3438f, 4.7619f }, { 4.82f, 14.2857f }, { 92.0743f, 100.0f },
+    { 6.36f, 0.0f }, { 30.1695f, 100.0f }, { 39.6933f, 90.4762f }, { 39.6933f, 80.9524f },
+    { 34.9314f, 71.4286f }, { 25.4076f, 66.6667f }, { 15.8838f, 66.6667f }, { 6.36f, 76.1905f },
+    { 6.36f, 85.7143f }, { 11.1219f, 95.2381f }, { 20.6457f, 100.0f }, { 30.1695f, 100.0f },
+    { 39.6933f, 95.2381f }, { 53.979f, 90.4762f }, { 68.2648f, 90.4762f }, { 82.5505f, 95.2381f },
+    { 92.0743f, 100.0f }, { 73.0267f, 33.3333f }, { 63.5029f, 28.5714f }, { 58.741f, 19.0476f },
+    { 58.741f, 9.5238f }, { 68.2648f, 0.0f }, { 77.7886f, 0.0f }, { 87.3124f, 4.7619f },
+    { 92.0743f, 14.2857f }, { 92.0743f, 23.8095f }, { 82.5505f, 33.3333f }, { 73.0267f, 33.3333f },
+    { 101.218f, 57.1429f }, { 101.218f, 61.9048f }, { 96.4562f, 66.6667f }, { 91.6943f, 66.6667f },
+    { 86.9324f, 61.9048f }, { 82.1705f, 52.381f }, { 72.6467f, 28.5714f }, { 63.1229f, 14.2857f },
+    { 53.599f, 4.7619f }, { 44.0752f, 0.0f }, { 25.0276f, 0.0f }, { 15.5038f, 4.7619f },
+    { 10.7419f, 9.5238f }, { 5.98f, 19.0476f }, { 5.98f, 28.5714f }, { 10.7419f, 38.0952f },
+    { 15.5038f, 42.8571f }, { 48.8371f, 61.9048f }, { 53.599f, 66.6667f }, { 58.361f, 76.1905f },
+    { 58.361f, 85.7143f }, { 53.599f, 95.2381f }, { 44.0752f, 100.0f }, { 34.5514f, 95.2381f },
+    { 29.7895f, 85.7143f }, { 29.7895f, 76.1905f }, { 34.5514f, 61.9048f }, { 44.0752f, 47.619f },
+    { 67.8848f, 14.2857f }, { 77.4086f, 4.7619f }, { 86.9324f, 0.0f }, { 96.4562f, 0.0f },
+    { 101.218f, 4.7619f }, { 101.218f, 9.5238f }, { 4.44f, 100.0f }, { 4.44f, 66.6667f },
+    { 40.9133f, 119.048f }, { 31.3895f, 109.524f }, { 21.8657f, 95.2381f }, { 12.3419f, 76.1905f },
+    { 7.58f, 52.381f }, { 7.58f, 33.3333f }, { 12.3419f, 9.5238f }, { 21.8657f, -9.5238f },
+    { 31.3895f, -23.8095f }, { 40.9133f, -33.3333f }, { 5.28f, 119.048f }, { 14.8038f, 109.524f },
+    { 24.3276f, 95.2381f }, { 33.8514f, 76.1905f }, { 38.6133f, 52.381f }, { 38.6133f, 33.3333f },
+    { 33.8514f, 9.5238f }, { 24.3276f, -9.5238f }, { 14.8038f, -23.8095f }, { 5.28f, -33.3333f },
+    { 30.7695f, 71.4286f }, { 30.7695f, 14.2857f }, { 6.96f, 57.1429f }, { 54.579f, 28.5714f },
+    { 54.579f, 57.1429f }, { 6.96f, 28.5714f }, { 48.8371f, 85.7143f }, { 48.8371f, 0.0f },
+    { 5.98f, 42.8571f }, { 91.6943f, 42.8571f }, { 18.2838f, 4.7619f }, { 13.5219f, 0.0f },
+    { 8.76f, 4.7619f }, { 13.5219f, 9.5238f }, { 18.2838f, 4.7619f }, { 18.2838f, -4.7619f },
+    { 13.5219f, -14.2857f }, { 8.76f, -19.0476f }, { 7.38f, 42.8571f }, { 93.0943f, 42.8571f },
+    { 13.1019f, 9.5238f }, { 8.34f, 4.7619f }, { 13.1019f, 0.0f }, { 17.8638f, 4.7619f },
+    { 13.1019f, 9.5238f }, { 7.24f, -14.2857f }, { 73.9067f, 100.0f }, { 33.5514f, 100.0f },
+    { 19.2657f, 95.2381f }, { 9.7419f, 80.9524f }, { 4.98f, 57.1429f }, { 4.98f, 42.8571f },
+    { 9.7419f, 19.0476f }, { 19.2657f, 4.7619f }, { 33.5514f, 0.0f }, { 43.0752f, 0.0f },
+    { 57.361f, 4.7619f }, { 66.8848f, 19.0476f }, { 71.6467f, 42.8571f }, { 71.6467f, 57.1429f },
+    { 66.8848f, 80.9524f }, { 57.361f, 95.2381f }, { 43.0752f, 100.0f }, { 33.5514f, 100.0f },
+    { 11.82f, 80.9524f }, { 21.3438f, 85.7143f }, { 35.6295f, 100.0f }, { 35.6295f, 0.0f },
+    { 10.1819f, 76.1905f }, { 10.1819f, 80.9524f }, { 14.9438f, 90.4762f }, { 19.7057f, 95.2381f },
+    { 29.2295f, 100.0f }, { 48.2771f, 100.0f }, { 57.801f, 95.2381f }, { 62.5629f, 90.4762f },
+    { 67.3248f, 80.9524f }, { 67.3248f, 71.4286f }, { 62.5629f, 61.9048f }, { 53.039f, 47.619f },
+    { 5.42f, 0.0f }, { 72.0867f, 0.0f }, { 14.5238f, 100.0f }, { 66.9048f, 100.0f },
+    { 38.3333f, 61.9048f }, { 52.619f, 61.9048f }, { 62.1429f, 57.1429f }, { 66.9048f, 52.381f },
+    { 71.6667f, 38.0952f }, { 71.6667f, 28.5714f }, { 66.9048f, 14.2857f }, { 57.381f, 4.7619f },
+    { 43.0952f, 0.0f }, { 28.8095f, 0.0f }, { 14.5238f, 4.7619f }, { 9.7619f, 9.5238f },
+    { 5.0f, 19.0476f }, { 51.499f, 100.0f }, { 3.88f, 33.3333f }, { 75.3086f, 33.3333f },
+    { 51.499f, 100.0f }, { 51.499f, 0.0f }, { 62.0029f, 100.0f }, { 14.3838f, 100.0f },
+    { 9.6219f, 57.1429f }, { 14.3838f, 61.9048f }, { 28.6695f, 66.6667f }, { 42.9552f, 66.6667f },
+    { 57.241f, 61.9048f }, { 66.7648f, 52.381f }, { 71.5267f, 38.0952f }, { 71.5267f, 28.5714f },
+    { 66.7648f, 14.2857f }, { 57.241f, 4.7619f }, { 42.9552f, 0.0f }, { 28.6695f, 0.0f },
+    { 14.3838f, 4.7619f }, { 9.6219f, 9.5238f }, { 4.86f, 19.0476f }, { 62.7229f, 85.7143f },
+    { 57.961f, 95.2381f }, { 43.6752f, 100.0f }, { 34.1514f, 100.0f }, { 19.8657f, 95.2381f },
+    { 10.3419f, 80.9524f }, { 5.58f, 57.1429f }, { 5.58f, 33.3333f }, { 10.3419f, 14.2857f },
+    { 19.8657f, 4.7619f }, { 34.1514f, 0.0f }, { 38.9133f, 0.0f }, { 53.199f, 4.7619f },
+    { 62.7229f, 14.2857f }, { 67.4848f, 28.5714f }, { 67.4848f, 33.3333f }, { 62.7229f, 47.619f },
+    { 53.199f, 57.1429f }, { 38.9133f, 61.9048f }, { 34.1514f, 61.9048f }, { 19.8657f, 57.1429f },
+    { 10.3419f, 47.619f }, { 5.58f, 33.3333f }, { 72.2267f, 100.0f }, { 24.6076f, 0.0f },
+    { 5.56f, 100.0f }, { 72.2267f, 100.0f }, { 29.4095f, 100.0f }, { 15.1238f, 95.2381f },
+    { 10.3619f, 85.7143f }, { 10.3619f, 76.1905f }, { 15.1238f, 66.6667f }, { 24.6476f, 61.9048f },
+    { 43.6952f, 57.1429f }, { 57.981f, 52.381f }, { 67.5048f, 42.8571f }, { 72.2667f, 33.3333f },
+    { 72.2667f, 19.0476f }, { 67.5048f, 9.5238f }, { 62.7429f, 4.7619f }, { 48.4571f, 0.0f },
+    { 29.4095f, 0.0f }, { 15.1238f, 4.7619f }, { 10.3619f, 9.5238f }, { 5.6f, 19.0476f },
+    { 5.6f, 33.3333f }, { 10.3619f, 42.8571f }, { 19.8857f, 52.381f }, { 34.1714f, 57.1429f },
+    { 53.219f, 61.9048f }, { 62.7429f, 66.6667f }, { 67.5048f, 76.1905f }, { 67.5048f, 85.7143f },
+    { 62.7429f, 95.2381f }, { 48.4571f, 100.0f }, { 29.4095f, 100.0f }, { 68.5048f, 66.6667f },
+    { 63.7429f, 52.381f }, { 54.219f, 42.8571f }, { 39.9333f, 38.0952f }, { 35.1714f, 38.0952f },
+    { 20.8857f, 42.8571f }, { 11.3619f, 52.381f }, { 6.6f, 66.6667f }, { 6.6f, 71.4286f },
+    { 11.3619f, 85.7143f }, { 20.8857f, 95.2381f }, { 35.1714f, 100.0f }, { 39.9333f, 100.0f },
+    { 54.219f, 95.2381f }, { 63.7429f, 85.7143f }, { 68.5048f, 66.6667f }, { 68.5048f, 42.8571f },
+    { 63.7429f, 19.0476f }, { 54.219f, 4.7619f }, { 39.9333f, 0.0f }, { 30.4095f, 0.0f },
+    { 16.1238f, 4.7619f }, { 11.3619f, 14.2857f }, { 14.0819f, 66.6667f }, { 9.32f, 61.9048f },
+    { 14.0819f, 57.1429f }, { 18.8438f, 61.9048f }, { 14.0819f, 66.6667f }, { 14.0819f, 9.5238f },
+    { 9.32f, 4.7619f }, { 14.0819f, 0.0f }, { 18.8438f, 4.7619f }, { 14.0819f, 9.5238f },
+    { 12.9619f, 66.6667f }, { 8.2f, 61.9048f }, { 12.9619f, 57.1429f }, { 17.7238f, 61.9048f },
+    { 12.9619f, 66.6667f }, { 17.7238f, 4.7619f }, { 12.9619f, 0.0f }, { 8.2f, 4.7619f },
+    { 12.9619f, 9.5238f }, { 17.7238f, 4.7619f }, { 17.7238f, -4.7619f }, { 12.9619f, -14.2857f },
+    { 8.2f, -19.0476f }, { 79.2505f, 85.7143f }, { 3.06f, 42.8571f }, { 79.2505f, 0.0f },
+    { 5.7f, 57.1429f }, { 91.4143f, 57.1429f }, { 5.7f, 28.5714f }, { 91.4143f, 28.5714f },
+    { 2.78f, 85.7143f }, { 78.9705f, 42.8571f }, { 2.78f, 0.0f }, { 8.42f, 76.1905f },
+    { 8.42f, 80.9524f }, { 13.1819f, 90.4762f }, { 17.9438f, 95.2381f }, { 27.4676f, 100.0f },
+    { 46.5152f, 100.0f }, { 56.039f, 95.2381f }, { 60.801f, 90.4762f }, { 65.5629f, 80.9524f },
+    { 65.5629f, 71.4286f }, { 60.801f, 61.9048f }, { 56.039f, 57.1429f }, { 36.9914f, 47.619f },
+    { 36.9914f, 33.3333f }, { 36.9914f, 9.5238f }, { 32.2295f, 4.7619f }, { 36.9914f, 0.0f },
+    { 41.7533f, 4.7619f }, { 36.9914f, 9.5238f }, { 49.2171f, 52.381f }, { 39.6933f, 57.1429f },
+    { 30.1695f, 57.1429f }, { 25.4076f, 47.619f }, { 25.4076f, 42.8571f }, { 30.1695f, 33.3333f },
+    { 39.6933f, 33.3333f }, { 49.2171f, 38.0952f }, { 49.2171f, 57.1429f }, { 49.2171f, 38.0952f },
+    { 53.979f, 33.3333f }, { 63.5029f, 33.3333f }, { 68.2648f, 42.8571f }, { 68.2648f, 47.619f },
+    { 63.5029f, 61.9048f }, { 53.979f, 71.4286f }, { 39.6933f, 76.1905f }, { 34.9314f, 76.1905f },
+    { 20.6457f, 71.4286f }, { 11.1219f, 61.9048f }, { 6.36f, 47.619f }, { 6.36f, 42.8571f },
+    { 11.1219f, 28.5714f }, { 20.6457f, 19.0476f }, { 34.9314f, 14.2857f }, { 39.6933f, 14.2857f },
+    { 53.979f, 19.0476f }, { 40.5952f, 100.0f }, { 2.5f, 0.0f }, { 40.5952f, 100.0f },
+    { 78.6905f, 0.0f }, { 16.7857f, 33.3333f }, { 64.4048f, 33.3333f }, { 11.42f, 100.0f },
+    { 11.42f, 0.0f }, { 11.42f, 100.0f }, { 54.2771f, 100.0f }, { 68.5629f, 95.2381f },
+    { 73.3248f, 90.4762f }, { 78.0867f, 80.9524f }, { 78.0867f, 71.4286f }, { 73.3248f, 61.9048f },
+    { 68.5629f, 57.1429f }, { 54.2771f, 52.381f }, { 11.42f, 52.381f }, { 54.2771f, 52.381f },
+    { 68.5629f, 47.619f }, { 73.3248f, 42.8571f }, { 78.0867f, 33.3333f }, { 78.0867f, 19.0476f },
+    { 73.3248f, 9.5238f }, { 68.5629f, 4.7619f }, { 54.2771f, 0.0f }, { 11.42f, 0.0f },
+    { 78.0886f, 76.1905f }, { 73.3267f, 85.7143f }, { 63.8029f, 95.2381f }, { 54.279f, 100.0f },
+    { 35.2314f, 100.0f }, { 25.7076f, 95.2381f }, { 16.1838f, 85.7143f }, { 11.4219f, 76.1905f },
+    { 6.66f, 61.9048f }, { 6.66f, 38.0952f }, { 11.4219f, 23.8095f }, { 16.1838f, 14.2857f },
+    { 25.7076f, 4.7619f }, { 35.2314f, 0.0f }, { 54.279f, 0.0f }, { 63.8029f, 4.7619f },
+    { 73.3267f, 14.2857f }, { 78.0886f, 23.8095f }, { 11.96f, 100.0f }, { 11.96f, 0.0f },
+    { 11.96f, 100.0f }, { 45.2933f, 100.0f }, { 59.579f, 95.2381f }, { 69.1029f, 85.7143f },
+    { 73.8648f, 76.1905f }, { 78.6267f, 61.9048f }, { 78.6267f, 38.0952f }, { 73.8648f, 23.8095f },
+    { 69.1029f, 14.2857f }, { 59.579f, 4.7619f }, { 45.2933f, 0.0f }, { 11.96f, 0.0f },
+    { 11.42f, 100.0f }, { 11.42f, 0.0f }, { 11.42f, 100.0f }, { 73.3248f, 100.0f },
+    { 11.42f, 52.381f }, { 49.5152f, 52.381f }, { 11.42f, 0.0f }, { 73.3248f, 0.0f },
+    { 11.42f, 100.0f }, { 11.42f, 0.0f }, { 11.42f, 100.0f }, { 73.3248f, 100.0f },
+    { 11.42f, 52.381f }, { 49.5152f, 52.381f }, { 78.4886f, 76.1905f }, { 73.7267f, 85.7143f },
+    { 64.2029f, 95.2381f }, { 54.679f, 100.0f }, { 35.6314f, 100.0f }, { 26.1076f, 95.2381f },
+    { 16.5838f, 85.7143f }, { 11.8219f, 76.1905f }, { 7.06f, 61.9048f }, { 7.06f, 38.0952f },
+    { 11.8219f, 23.8095f }, { 16.5838f, 14.2857f }, { 26.1076f, 4.7619f }, { 35.6314f, 0.0f },
+    { 54.679f, 0.0f }, { 64.2029f, 4.7619f }, { 73.7267f, 14.2857f }, { 78.4886f, 23.8095f },
+    { 78.4886f, 38.0952f }, { 54.679f, 38.0952f }, { 78.4886f, 38.0952f }, { 11.42f, 100.0f },
+    { 11.42f, 0.0f }, { 78.0867f, 100.0f }, { 78.0867f, 0.0f }, { 11.42f, 52.381f },
+    { 78.0867f, 52.381f }, { 10.86f, 100.0f }, { 10.86f, 0.0f }, { 50.119f, 100.0f },
+    { 50.119f, 23.8095f }, { 45.3571f, 9.5238f }, { 40.5952f, 4.7619f }, { 31.0714f, 0.0f },
+    { 21.5476f, 0.0f }, { 12.0238f, 4.7619f }, { 7.2619f, 9.5238f }, { 2.5f, 23.8095f },
+    { 2.5f, 33.3333f }, { 11.28f, 100.0f }, { 11.28f, 0.0f }, { 77.9467f, 100.0f },
+    { 11.28f, 33.3333f }, { 35.0895f, 57.1429f }, { 77.9467f, 0.0f }, { 11.68f, 100.0f },
+    { 11.68f, 0.0f }, { 11.68f, 0.0f }, { 68.8229f, 0.0f }, { 10.86f, 100.0f },
+    { 10.86f, 0.0f }, { 10.86f, 100.0f }, { 48.9552f, 0.0f }, { 87.0505f, 100.0f },
+    { 48.9552f, 0.0f }, { 87.0505f, 100.0f }, { 87.0505f, 0.0f }, { 11.14f, 100.0f },
+    { 11.14f, 0.0f }, { 11.14f, 100.0f }, { 77.8067f, 0.0f }, { 77.8067f, 100.0f },
+    { 77.8067f, 0.0f }, { 34.8114f, 100.0f }, { 25.2876f, 95.2381f }, { 15.7638f, 85.7143f },
+    { 11.0019f, 76.1905f }, { 6.24f, 61.9048f }, { 6.24f, 38.0952f }, { 11.0019f, 23.8095f },
+    { 15.7638f, 14.2857f }, { 25.2876f, 4.7619f }, { 34.8114f, 0.0f }, { 53.859f, 0.0f },
+    { 63.3829f, 4.7619f }, { 72.9067f, 14.2857f }, { 77.6686f, 23.8095f }, { 82.4305f, 38.0952f },
+    { 82.4305f, 61.9048f }, { 77.6686f, 76.1905f }, { 72.9067f, 85.7143f }, { 63.3829f, 95.2381f },
+    { 53.859f, 100.0f }, { 34.8114f, 100.0f }, { 12.1f, 100.0f }, { 12.1f, 0.0f },
+    { 12.1f, 100.0f }, { 54.9571f, 100.0f }, { 69.2429f, 95.2381f }, { 74.0048f, 90.4762f },
+    { 78.7667f, 80.9524f }, { 78.7667f, 66.6667f }, { 74.0048f, 57.1429f }, { 69.2429f, 52.381f },
+    { 54.9571f, 47.619f }, { 12.1f, 47.619f }, { 33.8714f, 100.0f }, { 24.3476f, 95.2381f },
+    { 14.8238f, 85.7143f }, { 10.0619f, 76.1905f }, { 5.3f, 61.9048f }, { 5.3f, 38.0952f },
+    { 10.0619f, 23.8095f }, { 14.8238f, 14.2857f }, { 24.3476f, 4.7619f }, { 33.8714f, 0.0f },
+    { 52.919f, 0.0f }, { 62.4429f, 4.7619f }, { 71.9667f, 14.2857f }, { 76.7286f, 23.8095f },
+    { 81.4905f, 38.0952f }, { 81.4905f, 61.9048f }, { 76.7286f, 76.1905f }, { 71.9667f, 85.7143f },
+    { 62.4429f, 95.2381f }, { 52.919f, 100.0f }, { 33.8714f, 100.0f }, { 48.1571f, 19.0476f },
+    { 76.7286f, -9.5238f }, { 11.68f, 100.0f }, { 11.68f, 0.0f }, { 11.68f, 100.0f },
+    { 54.5371f, 100.0f }, { 68.8229f, 95.2381f }, { 73.5848f, 90.4762f }, { 78.3467f, 80.9524f },
+    { 78.3467f, 71.4286f }, { 73.5848f, 61.9048f }, { 68.8229f, 57.1429f }, { 54.5371f, 52.381f },
+    { 11.68f, 52.381f }, { 45.0133f, 52.381f }, { 78.3467f, 0.0f }, { 74.6667f, 85.7143f },
+    { 65.1429f, 95.2381f }, { 50.8571f, 100.0f }, { 31.8095f, 100.0f }, { 17.5238f, 95.2381f },
+    { 8.0f, 85.7143f }, { 8.0f, 76.1905f }, { 12.7619f, 66.6667f }, { 17.5238f, 61.9048f },
+    { 27.0476f, 57.1429f }, { 55.619f, 47.619f }, { 65.1429f, 42.8571f }, { 69.9048f, 38.0952f },
+    { 74.6667f, 28.5714f }, { 74.6667f, 14.2857f }, { 65.1429f, 4.7619f }, { 50.8571f, 0.0f },
+    { 31.8095f, 0.0f }, { 17.5238f, 4.7619f }, { 8.0f, 14.2857f }, { 35.6933f, 100.0f },
+    { 35.6933f, 0.0f }, { 2.36f, 100.0f }, { 69.0267f, 100.0f }, { 11.54f, 100.0f },
+    { 11.54f, 28.5714f }, { 16.3019f, 14.2857f }, { 25.8257f, 4.7619f }, { 40.1114f, 0.0f },
+    { 49.6352f, 0.0f }, { 63.921f, 4.7619f }, { 73.4448f, 14.2857f }, { 78.2067f, 28.5714f },
+    { 78.2067f, 100.0f }, { 2.36f, 100.0f }, { 40.4552f, 0.0f }, { 78.5505f, 100.0f },
+    { 40.4552f, 0.0f }, { 2.22f, 100.0f }, { 26.0295f, 0.0f }, { 49.839f, 100.0f },
+    { 26.0295f, 0.0f }, { 49.839f, 100.0f }, { 73.6486f, 0.0f }, { 97.4581f, 100.0f },
+    { 73.6486f, 0.0f }, { 2.5f, 100.0f }, { 69.1667f, 0.0f }, { 69.1667f, 100.0f },
+    { 2.5f, 0.0f }, { 1.52f, 100.0f }, { 39.6152f, 52.381f }, { 39.6152f, 0.0f },
+    { 77.7105f, 100.0f }, { 39.6152f, 52.381f }, { 69.1667f, 100.0f }, { 2.5f, 0.0f },
+    { 2.5f, 100.0f }, { 69.1667f, 100.0f }, { 2.5f, 0.0f }, { 69.1667f, 0.0f },
+    { 7.78f, 119.048f }, { 7.78f, -33.3333f }, { 12.5419f, 119.048f }, { 12.5419f, -33.3333f },
+    { 7.78f, 119.048f }, { 41.1133f, 119.048f }, { 7.78f, -33.3333f }, { 41.1133f, -33.3333f },
+    { 5.84f, 100.0f }, { 72.5067f, -14.2857f }, { 33.0114f, 119.048f }, { 33.0114f, -33.3333f },
+    { 37.7733f, 119.048f }, { 37.7733f, -33.3333f }, { 4.44f, 119.048f }, { 37.7733f, 119.048f },
+    { 4.44f, -33.3333f }, { 37.7733f, -33.3333f }, { 44.0752f, 109.524f }, { 5.98f, 42.8571f },
+    { 44.0752f, 109.524f }, { 82.1705f, 42.8571f }, { -1.1f, -33.3333f }, { 103.662f, -33.3333f },
+    { 103.662f, -28.5714f }, { -1.1f, -28.5714f }, { -1.1f, -33.3333f }, { 33.0219f, 100.0f },
+    { 56.8314f, 71.4286f }, { 33.0219f, 100.0f }, { 28.26f, 95.2381f }, { 56.8314f, 71.4286f },
+    { 63.8229f, 66.6667f }, { 63.8229f, 0.0f }, { 63.8229f, 52.381f }, { 54.299f, 61.9048f },
+    { 44.7752f, 66.6667f }, { 30.4895f, 66.6667f }, { 20.9657f, 61.9048f }, { 11.4419f, 52.381f },
+    { 6.68f, 38.0952f }, { 6.68f, 28.5714f }, { 11.4419f, 14.2857f }, { 20.9657f, 4.7619f },
+    { 30.4895f, 0.0f }, { 44.7752f, 0.0f }, { 54.299f, 4.7619f }, { 63.8229f, 14.2857f },
+    { 8.76f, 100.0f }, { 8.76f, 0.0f }, { 8.76f, 52.381f }, { 18.2838f, 61.9048f },
+    { 27.8076f, 66.6667f }, { 42.0933f, 66.6667f }, { 51.6171f, 61.9048f }, { 61.141f, 52.381f },
+    { 65.9029f, 38.0952f }, { 65.9029f, 28.5714f }, { 61.141f, 14.2857f }, { 51.6171f, 4.7619f },
+    { 42.0933f, 0.0f }, { 27.8076f, 0.0f }, { 18.2838f, 4.7619f }, { 8.76f, 14.2857f },
+    { 62.6629f, 52.381f }, { 53.139f, 61.9048f }, { 43.6152f, 66.6667f }, { 29.3295f, 66.6667f },
+    { 19.8057f, 61.9048f }, { 10.2819f, 52.381f }, { 5.52f, 38.0952f }, { 5.52f, 28.5714f },
+    { 10.2819f, 14.2857f }, { 19.8057f, 4.7619f }, { 29.3295f, 0.0f }, { 43.6152f, 0.0f },
+    { 53.139f, 4.7619f }, { 62.6629f, 14.2857f }, { 61.7829f, 100.0f }, { 61.7829f, 0.0f },
+    { 61.7829f, 52.381f }, { 52.259f, 61.9048f }, { 42.7352f, 66.6667f }, { 28.4495f, 66.6667f },
+    { 18.9257f, 61.9048f }, { 9.4019f, 52.381f }, { 4.64f, 38.0952f }, { 4.64f, 28.5714f },
+    { 9.4019f, 14.2857f }, { 18.9257f, 4.7619f }, { 28.4495f, 0.0f }, { 42.7352f, 0.0f },
+    { 52.259f, 4.7619f }, { 61.7829f, 14.2857f }, { 5.72f, 38.0952f }, { 62.8629f, 38.0952f },
+    { 62.8629f, 47.619f }, { 58.101f, 57.1429f }, { 53.339f, 61.9048f }, { 43.8152f, 66.6667f },
+    { 29.5295f, 66.6667f }, { 20.0057f, 61.9048f }, { 10.4819f, 52.381f }, { 5.72f, 38.0952f },
+    { 5.72f, 28.5714f }, { 10.4819f, 14.2857f }, { 20.0057f, 4.7619f }, { 29.5295f, 0.0f },
+    { 43.8152f, 0.0f }, { 53.339f, 4.7619f }, { 62.8629f, 14.2857f }, { 38.7752f, 100.0f },
+    { 29.2514f, 100.0f }, { 19.7276f, 95.2381f }, { 14.9657f, 80.9524f }, { 14.9657f, 0.0f },
+    { 0.68f, 66.6667f }, { 34.0133f, 66.6667f }, { 62.5029f, 66.6667f }, { 62.5029f, -9.5238f },
+    { 57.741f, -23.8095f }, { 52.979f, -28.5714f }, { 43.4552f, -33.3333f }, { 29.1695f, -33.3333f },
+    { 19.6457f, -28.5714f }, { 62.5029f, 52.381f }, { 52.979f, 61.9048f }, { 43.4552f, 66.6667f },
+    { 29.1695f, 66.6667f }, { 19.6457f, 61.9048f }, { 10.1219f, 52.381f }, { 5.36f, 38.0952f },
+    { 5.36f, 28.5714f }, { 10.1219f, 14.2857f }, { 19.6457f, 4.7619f }, { 29.1695f, 0.0f },
+    { 43.4552f, 0.0f }, { 52.979f, 4.7619f }, { 62.5029f, 14.2857f }, { 9.6f, 100.0f },
+    { 9.6f, 0.0f }, { 9.6f, 47.619f }, { 23.8857f, 61.9048f }, { 33.4095f, 66.6667f },
+    { 47.6952f, 66.6667f }, { 57.219f, 61.9048f }, { 61.981f, 47.619f }, { 61.981f, 0.0f },
+    { 10.02f, 100.0f }, { 14.7819f, 95.2381f }, { 19.5438f, 100.0f }, { 14.7819f, 104.762f },
+    { 10.02f, 100.0f }, { 14.7819f, 66.6667f }, { 14.7819f, 0.0f }, { 17.3876f, 100.0f },
+    { 22.1495f, 95.2381f }, { 26.9114f, 100.0f }, { 22.1495f, 104.762f }, { 17.3876f, 100.0f },
+    { 22.1495f, 66.6667f }, { 22.1495f, -14.2857f }, { 17.3876f, -28.5714f }, { 7.8638f, -33.3333f },
+    { -1.66f, -33.3333f }, { 9.6f, 100.0f }, { 9.6f, 0.0f }, { 57.219f, 66.6667f },
+    { 9.6f, 19.0476f }, { 28.6476f, 38.0952f }, { 61.981f, 0.0f }, { 10.02f, 100.0f },
+    { 10.02f, 0.0f }, { 9.6f, 66.6667f }, { 9.6f, 0.0f }, { 9.6f, 47.619f },
+    { 23.8857f, 61.9048f }, { 33.4095f, 66.6667f }, { 47.6952f, 66.6667f }, { 57.219f, 61.9048f },
+    { 61.981f, 47.619f }, { 61.981f, 0.0f }, { 61.981f, 47.619f }, { 76.2667f, 61.9048f },
+    { 85.7905f, 66.6667f }, { 100.076f, 66.6667f }, { 109.6f, 61.9048f }, { 114.362f, 47.619f },
+    { 114.362f, 0.0f }, { 9.18f, 66.6667f }, { 9.18f, 0.0f }, { 9.18f, 47.619f },
+    { 23.4657f, 61.9048f }, { 32.9895f, 66.6667f }, { 47.2752f, 66.6667f }, { 56.799f, 61.9048f },
+    { 61.561f, 47.619f }, { 61.561f, 0.0f }, { 28.7895f, 66.6667f }, { 19.2657f, 61.9048f },
+    { 9.7419f, 52.381f }, { 4.98f, 38.0952f }, { 4.98f, 28.5714f }, { 9.7419f, 14.2857f },
+    { 19.2657f, 4.7619f }, { 28.7895f, 0.0f }, { 43.0752f, 0.0f }, { 52.599f, 4.7619f },
+    { 62.1229f, 14.2857f }, { 66.8848f, 28.5714f }, { 66.8848f, 38.0952f }, { 62.1229f, 52.381f },
+    { 52.599f, 61.9048f }, { 43.0752f, 66.6667f }, { 28.7895f, 66.6667f }, { 9.46f, 66.6667f },
+    { 9.46f, -33.3333f }, { 9.46f, 52.381f }, { 18.9838f, 61.9048f }, { 28.5076f, 66.6667f },
+    { 42.7933f, 66.6667f }, { 52.3171f, 61.9048f }, { 61.841f, 52.381f }, { 66.6029f, 38.0952f },
+    { 66.6029f, 28.5714f }, { 61.841f, 14.2857f }, { 52.3171f, 4.7619f }, { 42.7933f, 0.0f },
+    { 28.5076f, 0.0f }, { 18.9838f, 4.7619f }, { 9.46f, 14.2857f }, { 61.9829f, 66.6667f },
+    { 61.9829f, -33.3333f }, { 61.9829f, 52.381f }, { 52.459f, 61.9048f }, { 42.9352f, 66.6667f },
+    { 28.6495f, 66.6667f }, { 19.1257f, 61.9048f }, { 9.6019f, 52.381f }, { 4.84f, 38.0952f },
+    { 4.84f, 28.5714f }, { 9.6019f, 14.2857f }, { 19.1257f, 4.7619f }, { 28.6495f, 0.0f },
+    { 42.9352f, 0.0f }, { 52.459f, 4.7619f }, { 61.9829f, 14.2857f }, { 9.46f, 66.6667f },
+    { 9.46f, 0.0f }, { 9.46f, 38.0952f }, { 14.2219f, 52.381f }, { 23.7457f, 61.9048f },
+    { 33.2695f, 66.6667f }, { 47.5552f, 66.6667f }, { 57.081f, 52.381f }, { 52.319f, 61.9048f },
+    { 38.0333f, 66.6667f }, { 23.7476f, 66.6667f }, { 9.4619f, 61.9048f }, { 4.7f, 52.381f },
+    { 9.4619f, 42.8571f }, { 18.9857f, 38.0952f }, { 42.7952f, 33.3333f }, { 52.319f, 28.5714f },
+    { 57.081f, 19.0476f }, { 57.081f, 14.2857f }, { 52.319f, 4.7619f }, { 38.0333f, 0.0f },
+    { 23.7476f, 0.0f }, { 9.4619f, 4.7619f }, { 4.7f, 14.2857f }, { 14.8257f, 100.0f },
+    { 14.8257f, 19.0476f }, { 19.5876f, 4.7619f }, { 29.1114f, 0.0f }, { 38.6352f, 0.0f },
+    { 0.54f, 66.6667f }, { 33.8733f, 66.6667f }, { 9.46f, 66.6667f }, { 9.46f, 19.0476f },
+    { 14.2219f, 4.7619f }, { 23.7457f, 0.0f }, { 38.0314f, 0.0f }, { 47.5552f, 4.7619f },
+    { 61.841f, 19.0476f }, { 61.841f, 66.6667f }, { 61.841f, 0.0f }, { 1.8f, 66.6667f },
+    { 30.3714f, 0.0f }, { 58.9429f, 66.6667f }, { 30.3714f, 0.0f }, { 2.5f, 66.6667f },
+    { 21.5476f, 0.0f }, { 40.5952f, 66.6667f }, { 21.5476f, 0.0f }, { 40.5952f, 66.6667f },
+    { 59.6429f, 0.0f }, { 78.6905f, 66.6667f }, { 59.6429f, 0.0f }, { 1.66f, 66.6667f },
+    { 54.041f, 0.0f }, { 54.041f, 66.6667f }, { 1.66f, 0.0f }, { 6.5619f, 66.6667f },
+    { 35.1333f, 0.0f }, { 63.7048f, 66.6667f }, { 35.1333f, 0.0f }, { 25.6095f, -19.0476f },
+    { 16.0857f, -28.5714f }, { 6.5619f, -33.3333f }, { 1.8f, -33.3333f }, { 56.821f, 66.6667f },
+    { 4.44f, 0.0f }, { 4.44f, 66.6667f }, { 56.821f, 66.6667f }, { 4.44f, 0.0f },
+    { 56.821f, 0.0f }, { 31.1895f, 119.048f }, { 21.6657f, 114.286f }, { 16.9038f, 109.524f },
+    { 12.1419f, 100.0f }, { 12.1419f, 90.4762f }, { 16.9038f, 80.9524f }, { 21.6657f, 76.1905f },
+    { 26.4276f, 66.6667f }, { 26.4276f, 57.1429f }, { 16.9038f, 47.619f }, { 21.6657f, 114.286f },
+    { 16.9038f, 104.762f }, { 16.9038f, 95.2381f }, { 21.6657f, 85.7143f }, { 26.4276f, 80.9524f },
+    { 31.1895f, 71.4286f }, { 31.1895f, 61.9048f }, { 26.4276f, 52.381f }, { 7.38f, 42.8571f },
+    { 26.4276f, 33.3333f }, { 31.1895f, 23.8095f }, { 31.1895f, 14.2857f }, { 26.4276f, 4.7619f },
+    { 21.6657f, 0.0f }, { 16.9038f, -9.5238f }, { 16.9038f, -19.0476f }, { 21.6657f, -28.5714f },
+    { 16.9038f, 38.0952f }, { 26.4276f, 28.5714f }, { 26.4276f, 19.0476f }, { 21.6657f, 9.5238f },
+    { 16.9038f, 4.7619f }, { 12.1419f, -4.7619f }, { 12.1419f, -14.2857f }, { 16.9038f, -23.8095f },
+    { 21.6657f, -28.5714f }, { 31.1895f, -33.3333f }, { 11.54f, 119.048f }, { 11.54f, -33.3333f },
+    { 9.18f, 119.048f }, { 18.7038f, 114.286f }, { 23.4657f, 109.524f }, { 28.2276f, 100.0f },
+    { 28.2276f, 90.4762f }, { 23.4657f, 80.9524f }, { 18.7038f, 76.1905f }, { 13.9419f, 66.6667f },
+    { 13.9419f, 57.1429f }, { 23.4657f, 47.619f }, { 18.7038f, 114.286f }, { 23.4657f, 104.762f },
+    { 23.4657f, 95.2381f }, { 18.7038f, 85.7143f }, { 13.9419f, 80.9524f }, { 9.18f, 71.4286f },
+    { 9.18f, 61.9048f }, { 13.9419f, 52.381f }, { 32.9895f, 42.8571f }, { 13.9419f, 33.3333f },
+    { 9.18f, 23.8095f }, { 9.18f, 14.2857f }, { 13.9419f, 4.7619f }, { 18.7038f, 0.0f },
+    { 23.4657f, -9.5238f }, { 23.4657f, -19.0476f }, { 18.7038f, -28.5714f }, { 23.4657f, 38.0952f },
+    { 13.9419f, 28.5714f }, { 13.9419f, 19.0476f }, { 18.7038f, 9.5238f }, { 23.4657f, 4.7619f },
+    { 28.2276f, -4.7619f }, { 28.2276f, -14.2857f }, { 23.4657f, -23.8095f }, { 18.7038f, -28.5714f },
+    { 9.18f, -33.3333f }, { 2.92f, 28.5714f }, { 2.92f, 38.0952f }, { 7.6819f, 52.381f },
+    { 17.2057f, 57.1429f }, { 26.7295f, 57.1429f }, { 36.2533f, 52.381f }, { 55.301f, 38.0952f },
+    { 64.8248f, 33.3333f }, { 74.3486f, 33.3333f }, { 83.8724f, 38.0952f }, { 88.6343f, 47.619f },
+    { 2.92f, 38.0952f }, { 7.6819f, 47.619f }, { 17.2057f, 52.381f }, { 26.7295f, 52.381f },
+    { 36.2533f, 47.619f }, { 55.301f, 33.3333f }, { 64.8248f, 28.5714f }, { 74.3486f, 28.5714f },
+    { 83.8724f, 33.3333f }, { 88.6343f, 47.619f }, { 88.6343f, 57.1429f }, { 52.381f, 100.0f },
+    { 14.2857f, -33.3333f }, { 28.5714f, 66.6667f }, { 14.2857f, 61.9048f }, { 4.7619f, 52.381f },
+    { 0.0f, 38.0952f }, { 0.0f, 23.8095f }, { 4.7619f, 14.2857f }, { 14.2857f, 4.7619f },
+    { 28.5714f, 0.0f }, { 38.0952f, 0.0f }, { 52.381f, 4.7619f }, { 61.9048f, 14.2857f },
+    { 66.6667f, 28.5714f }, { 66.6667f, 42.8571f }, { 61.9048f, 52.381f }, { 52.381f, 61.9048f },
+    { 38.0952f, 66.6667f }, { 28.5714f, 66.6667f },
+};
+
+// Advance of byte c; bytes outside ASCII have no glyph, as in GLUT.
+constexpr float strokeAdvance(unsigned char c) {
+    return (c < 128) ? STROKE_ROMAN_GLYPHS[c].advance : 0.0f;
+}
+
+// Width of the first `count` bytes of s, in stroke units: one lookup per glyph.
+inline float strokeTextWidth(const std::string& s, size_t count = std::string::npos) {
+    if (count > s.size()) count = s.size();
+    float w = 0.0f;
+    for (size_t i = 0; i < count; ++i) w += strokeAdvance((unsigned char)s[i]);
+    return w;
+}
+
+// fn(vertices, vertexCount) for each line strip of glyph c, vertices as xy pairs.
+template <typename Fn>
+inline void forEachStrokeStrip(unsigned char c, Fn&& fn) {
+    if (c >= 128) return;
+    const StrokeGlyph& g = STROKE_ROMAN_GLYPHS[c];
+    for (int s = 0; s < g.stripCount; ++s) {
+        const StrokeStrip& st = STROKE_ROMAN_STRIPS[g.firstStrip + s];
+        fn(&STROKE_ROMAN_VERTS[st.firstVertex][0], int(st.vertexCount));
+    }
+}
+
+#endif // STROKEFONT_H
@@ -0,0 +1,248 @@
+// svgexport.cpp - streaming SVG export of a laid-out map.
+
+#include "svgexport.h"
+
+#include <cstdio>
+#include <cstdint>
+#include <cmath>
+#include <string>
+#include <algorithm>
+
+#include "strokefont.h"
+
+static const size_t SVG_FLUSH_BYTES   = 1 << 16; // buffered output before a write
+static const int    SVG_PATH_SEGMENTS = 4096;    // links or circles per <path> element
+
+// Output buffer plus the number format. Coordinates are quantized to
+// 10^-precision world units and y is negated (SVG's y axis points down);
+// path data is written as integer differences of quantized points, so the
+// pen never drifts from the absolute positions.
+struct SvgWriter {
+    FILE* f;
+    std::string buf;
+    int precision;
+    int64_t scale = 1;
+    bool ok = true;
+
+    int64_t penX = 0, penY = 0; // current point of the open path (quantized)
+    bool moved = false;         // the open path has a current point
+    bool sep = false;           // last thing written to the path was a number
+
+    SvgWriter(FILE* file, int digits) : f(file), precision(std::clamp(digits, 0, 6)) {
+        for (int i = 0; i < precision; ++i) scale *= 10;
+        buf.reserve(SVG_FLUSH_BYTES + 4096);
+    }
+
+    void flush() {
+        if (!buf.empty() && std::fwrite(buf.data(), 1, buf.size(), f) != buf.size()) ok = false;
+        buf.clear();
+    }
+
+    void put(const char* s) { buf += s; }
+
+    void maybeFlush() {
+        if (buf.size() >= SVG_FLUSH_BYTES) flush();
+    }
+
+    int64_t qx(float x) const { return std::llround(double(x) * double(scale)); }
+    int64_t qy(float y) const { return std::llround(-double(y) * double(scale)); }
+
+    // Fixed-point value q / scale with trailing zeros (and a leading "0") dropped.
+    void number(int64_t q) {
+        if (q < 0) { buf += '-'; q = -q; }
+        int64_t whole = q / scale, frac = q % scale;
+        if (whole != 0 || frac == 0) buf += std::to_string(whole);
+        if (frac == 0) return;
+
+        char digits[8];
+        int n = precision;
+        for (int i = n - 1; i >= 0; --i) { digits[i] = char('0' + frac % 10); frac /= 10; }
+        while (digits[n - 1] == '0') --n;
+        buf += '.';
+        buf.append(digits, size_t(n));
+    }
+
+    // Attribute values: space separated.
+    void value(float v) { number(std::llround(double(v) * double(scale))); }
+
+    // Path data: a separator only where the sign does not already provide one.
+    void pathNumber(int64_t q) {
+        if (sep && q >= 0) buf += ' ';
+        number(q);
+        sep = true;
+    }
+
+    void command(char c) { buf += c; sep = false; }
+
+    void beginPath(const char* attrs) {
+        buf += "<path ";
+        buf += attrs;
+        buf += " d=\"";
+        penX = penY = 0;
+        moved = sep = false;
+    }
+
+    void endPath() { buf += "\"/>\n"; }
+
+    // Relative move to quantized (x, y), unless the pen is already there.
+    void moveTo(int64_t x, int64_t y) {
+        if (moved && x == penX && y == penY) return;
+        command('m');
+        pathNumber(x - penX);
+        pathNumber(y - penY);
+        penX = x;
+        penY = y;
+        moved = true;
+    }
+
+    void text(const std::string& s) {
+        for (char c : s) {
+            switch (c) {
+            case '&':  buf += "&amp;";  break;
+            case '<':  buf += "&lt;";   break;
+            case '>':  buf += "&gt;";   break;
+            case '"':  buf += "&quot;"; break;
+            default:   buf += (unsigned char)c < 0x20 ? ' ' : c; break; // not allowed in XML 1.0
+            }
+        }
+    }
+};
+
+// A sequence of <path> elements with at most SVG_PATH_SEGMENTS items each.
+struct SvgPathRun {
+    SvgWriter& w;
+    const char* attrs;
+    int items = 0;
+
+    void next() {
+        if (items == SVG_PATH_SEGMENTS) { w.endPath(); w.maybeFlush(); items = 0; }
+        if (items++ == 0) w.beginPath(attrs);
+    }
+
+    void finish() { if (items) w.endPath(); }
+};
+
+static void writeLinks(SvgWriter& w, const std::vector<Node*>& nodes,
+                       const std::vector<std::pair<int, int>>& ranges, const Node* focus, const SvgOptions& opt) {
+    SvgPathRun run{ w, "fill=\"none\" stroke=\"#737373\" stroke-opacity=\"0.55\" stroke-width=\"1\" "
+                       "vector-effect=\"non-scaling-stroke\"" };
+    forEachSlot(nodes, ranges, [&](const Node* n) {
+        const Node* p = n->parent;
+        if (!p) return;
+        run.next();
+
+        int64_t x0 = w.qx(p->x), y0 = w.qy(p->y);
+        int64_t x3 = w.qx(n->x), y3 = w.qy(n->y);
+        w.moveTo(x0, y0);
+        // The ancestor path on the back wedge is collinear, so straight.
+        if (opt.curved && n->depth > focus->depth) {
+            float p1x, p1y, p2x, p2y;
+            linkControlPoints(p, n, opt.radiusStep, p1x, p1y, p2x, p2y);
+            w.command('c');
+            w.pathNumber(w.qx(p1x) - x0); w.pathNumber(w.qy(p1y) - y0);
+            w.pathNumber(w.qx(p2x) - x0); w.pathNumber(w.qy(p2y) - y0);
+        } else {
+            w.command('l');
+        }
+        w.pathNumber(x3 - x0);
+        w.pathNumber(y3 - y0);
+        w.penX = x3;
+        w.penY = y3;
+    });
+    run.finish();
+}
+
+// Each circle is two half-circle arcs starting and ending at its leftmost point.
+static void writeCircles(SvgWriter& w, const std::vector<Node*>& nodes,
+                         const std::vector<std::pair<int, int>>& ranges, const SvgOptions& opt) {
+    SvgPathRun run{ w, "fill=\"#4d4d4d\" fill-opacity=\"0.95\"" };
+    int64_t r = w.qx(opt.endpointRadius);
+    if (r <= 0) return;
+    forEachSlot(nodes, ranges, [&](const Node* n) {
+        run.next();
+        w.moveTo(w.qx(n->x) - r, w.qy(n->y));
+        for (int half = 0; half < 2; ++half) {
+            w.command('a');
+            w.pathNumber(r); w.pathNumber(r);
+            w.buf += " 0 1 0";
+            w.pathNumber(half ? -2 * r : 2 * r);
+            w.pathNumber(0);
+        }
+    });
+    run.finish();
+}
+
+static void writeLabel(SvgWriter& w, float x, float y, float angleDeg, bool end,
+                       const std::string& s, const SvgOptions& opt) {
+    w.put("<text transform=\"translate(");
+    w.value(x);
+    w.put(" ");
+    w.value(-y);
+    if (angleDeg != 0.0f) {
+        w.put(") rotate(");
+        w.value(-angleDeg);
+    }
+    w.put(")\" textLength=\"");
+    w.value(strokeTextWidth(s) * opt.labelScale);
+    w.put(end ? "\" text-anchor=\"end\">" : "\">");
+    w.text(s);
+    w.put("</text>\n");
+    w.maybeFlush();
+}
+
+static void writeLabels(SvgWriter& w, const std::vector<Node*>& nodes,
+                        const std::vector<std::pair<int, int>>& ranges, const Node* focus, const SvgOptions& opt) {
+    forEachSlot(nodes, ranges, [&](const Node* n) {
+        if (!mapLabelWanted(n, focus, opt)) return;
+        float x, y, deg;
+        bool end;
+        placeMapLabel(n, focus, opt, x, y, deg, end);
+        writeLabel(w, x, y, deg, end, n->text, opt);
+    });
+}
+
+bool exportSvg(const char* path,
+               const std::vector<Node*>& nodes,
+               const std::vector<std::pair<int, int>>& ranges,
+               const Node* focus,
+               const SvgOptions& opt)
+{
+    FILE* f = std::fopen(path, "wb");
+    if (!f) { std::fprintf(stderr, "Cannot write %s\n", path); return false; }
+
+    // Square view box around the focus, large enough for the longest label.
+    float extent = std::ceil(mapExtent(nodes, ranges, focus, opt) + 2.0f * opt.labelPad);
+
+    SvgWriter w(f, opt.precision);
+    w.put("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n");
+    w.put("<svg xmlns=\"http://www.w3.org/2000/svg\" viewBox=\"");
+    w.value(-extent); w.put(" "); w.value(-extent); w.put(" ");
+    w.value(2.0f * extent); w.put(" "); w.value(2.0f * extent);
+    w.put("\" width=\""); w.value(2.0f * extent);
+    w.put("\" height=\""); w.value(2.0f * extent);
+    w.put("\">\n<rect x=\""); w.value(-extent); w.put("\" y=\""); w.value(-extent);
+    w.put("\" width=\""); w.value(2.0f * extent);
+    w.put("\" height=\""); w.value(2.0f * extent);
+    w.put("\" fill=\"#fff\"/>\n");
+
+    w.put("<g transform=\"rotate(");
+    w.value(-opt.rotDeg);
+    w.put(")\">\n");
+    writeLinks(w, nodes, ranges, focus, opt);
+    writeCircles(w, nodes, ranges, opt);
+    if (opt.labels) {
+        // Font size: the stroke font's full height (ascent + descent) at labelScale.
+        w.put("<g font-family=\"sans-serif\" font-size=\"");
+        w.value(STROKE_ROMAN_HEIGHT * opt.labelScale);
+        w.put("\" fill=\"#1a1a1a\">\n");
+        writeLabels(w, nodes, ranges, focus, opt);
+        w.put("</g>\n");
+    }
+    w.put("</g>\n</svg>\n");
+    w.flush();
+
+    bool ok = w.ok && !std::ferror(f);
+    ok = (std::fclose(f) == 0) && ok;
+    if (!ok) std::fprintf(stderr, "Error writing %s\n", path);
+    return ok;
+}
@@ -0,0 +1,32 @@
+// svgexport.h - streaming SVG export of a laid-out map.
+//
+// Writes the viewer's geometry: links as native cubic Bezier (or straight)
+// path segments, endpoint circles as arc pairs and labels as rotated,
+// start/end-aligned <text> elements. Path data uses relative coordinates on a
+// fixed decimal grid, so rounding never accumulates along a path. Output is
+// produced in one pass per layer and flushed in fixed-size chunks: memory use
+// does not grow with the map.
+
+#ifndef SVGEXPORT_H
+#define SVGEXPORT_H
+
+#include <vector>
+#include <utility>
+
+#include "mindmap.h"
+
+struct SvgOptions : MapStyle {
+    int precision = 2;              // decimal places of all coordinates
+};
+
+// Export the nodes in ranges (preorder [begin, end) slots of nodes), laid
+// out around focus. Nodes at or above the focus depth are the ancestor path
+// and are linked with straight lines. Returns false (after a message on
+// stderr) if the file cannot be written.
+bool exportSvg(const char* path,
+               const std::vector<Node*>& nodes,
+               const std::vector<std::pair<int, int>>& ranges,
+               const Node* focus,
+               const SvgOptions& opt);
+
+#endif // SVGEXPORT_H
@@ -0,0 +1,159 @@
+// tiffwriter.cpp - streaming writer for tiled, deflate-compressed RGB TIFF.
+
+#include "tiffwriter.h"
+
+#include <cstring>
+#include <string>
+#include <algorithm>
+
+#include "pngwriter.h"
+
+// Classic TIFF offsets are 32 bits; above this many raw bytes the compressed
+// tiles could (in theory) not fit, so the file is made BigTIFF instead.
+static const uint64_t TIFF_CLASSIC_LIMIT = 0xE0000000ull;
+
+// Tags and field types used here (TIFF 6.0, BigTIFF).
+enum : uint16_t {
+    TAG_IMAGE_WIDTH = 256, TAG_IMAGE_LENGTH = 257, TAG_BITS_PER_SAMPLE = 258,
+    TAG_COMPRESSION = 259, TAG_PHOTOMETRIC = 262, TAG_SAMPLES_PER_PIXEL = 277,
+    TAG_PLANAR_CONFIG = 284, TAG_PREDICTOR = 317, TAG_TILE_WIDTH = 322,
+    TAG_TILE_LENGTH = 323, TAG_TILE_OFFSETS = 324, TAG_TILE_BYTE_COUNTS = 325
+};
+enum : uint16_t { TYPE_SHORT = 3, TYPE_LONG = 4, TYPE_LONG8 = 16 };
+
+static void putLE(std::vector<uint8_t>& out, uint64_t v, int bytes) {
+    for (int i = 0; i < bytes; ++i) out.push_back(uint8_t(v >> (8 * i)));
+}
+
+TiledTiffWriter::~TiledTiffWriter() {
+    if (f) std::fclose(f);
+}
+
+bool TiledTiffWriter::open(const char* file, int w, int h, int tile) {
+    path = file;
+    width = w;
+    height = h;
+    tileSize = tile;
+    if (w <= 0 || h <= 0 || tile <= 0 || tile % 16 != 0) {
+        std::fprintf(stderr, "%s: bad TIFF size %dx%d, tile %d\n", file, w, h, tile);
+        return false;
+    }
+    tilesX = (w + tile - 1) / tile;
+    tilesY = (h + tile - 1) / tile;
+    size_t tiles = size_t(tilesX) * size_t(tilesY);
+    offsets.assign(tiles, 0);
+    counts.assign(tiles, 0);
+    big = uint64_t(tilesX) * uint64_t(tilesY) * uint64_t(tile) * uint64_t(tile) * 3 > TIFF_CLASSIC_LIMIT;
+
+    f = std::fopen(file, "wb");
+    if (!f) { std::fprintf(stderr, "Cannot write %s\n", file); return false; }
+
+    // Header with a placeholder for the directory offset, patched by close().
+    std::vector<uint8_t> head = { 'I', 'I' };
+    if (big) {
+        putLE(head, 43, 2);
+        putLE(head, 8, 2);     // offset size
+        putLE(head, 0, 2);
+        putLE(head, 0, 8);
+    } else {
+        putLE(head, 42, 2);
+        putLE(head, 0, 4);
+    }
+    ok = std::fwrite(head.data(), 1, head.size(), f) == head.size();
+    end = head.size();
+    return ok;
+}
+
+bool TiledTiffWriter::writeTile(int tx, int ty, const uint8_t* rgba) {
+    if (tx < 0 || ty < 0 || tx >= tilesX || ty >= tilesY) return false;
+
+    // RGB with horizontal differencing (predictor 2): flat backgrounds and
+    // long lines turn into runs of zeros.
+    size_t row = size_t(tileSize) * 3;
+    std::vector<uint8_t> raw(row * size_t(tileSize));
+    for (int y = 0; y < tileSize; ++y) {
+        const uint8_t* s = rgba + size_t(y) * size_t(tileSize) * 4;
+        uint8_t* d = &raw[size_t(y) * row];
+        uint8_t pr = 0, pg = 0, pb = 0;
+        for (int x = 0; x < tileSize; ++x, s += 4, d += 3) {
+            d[0] = uint8_t(s[0] - pr);
+            d[1] = uint8_t(s[1] - pg);
+            d[2] = uint8_t(s[2] - pb);
+            pr = s[0]; pg = s[1]; pb = s[2];
+        }
+    }
+    std::vector<uint8_t> z = zlibCompress(raw.data(), raw.size());
+
+    std::lock_guard<std::mutex> guard(lock);
+    size_t i = size_t(ty) * size_t(tilesX) + size_t(tx);
+    offsets[i] = end;
+    counts[i] = z.size();
+    if (std::fwrite(z.data(), 1, z.size(), f) != z.size()) ok = false;
+    end += z.size();
+    return ok;
+}
+
+bool TiledTiffWriter::close() {
+    if (!f) return false;
+
+    // Directory: entries sorted by tag. Values that do not fit in an entry
+    // (bits per sample, the tile arrays) follow the directory.
+    const int entrySize = big ? 20 : 12, countSize = big ? 8 : 4, offSize = big ? 8 : 4;
+    const int entries = 12;
+    if (end & 1) { std::fputc(0, f); ++end; } // word alignment
+    uint64_t dirPos = end;
+    uint64_t extra = dirPos + uint64_t(big ? 8 : 2) + uint64_t(entries * entrySize) + uint64_t(offSize);
+    size_t tiles = offsets.size();
+
+    std::vector<uint8_t> dir, tail;
+    putLE(dir, entries, big ? 8 : 2);
+    auto entry = [&](uint16_t tag, uint16_t type, uint64_t count, uint64_t value) {
+        putLE(dir, tag, 2);
+        putLE(dir, type, 2);
+        putLE(dir, count, countSize);
+        putLE(dir, value, offSize);
+    };
+    auto external = [&]() { return extra + tail.size(); };
+
+    entry(TAG_IMAGE_WIDTH, TYPE_LONG, 1, uint32_t(width));
+    entry(TAG_IMAGE_LENGTH, TYPE_LONG, 1, uint32_t(height));
+    if (big) {
+        entry(TAG_BITS_PER_SAMPLE, TYPE_SHORT, 3, 8 | (8ull << 16) | (8ull << 32));
+    } else {
+        entry(TAG_BITS_PER_SAMPLE, TYPE_SHORT, 3, external());
+        putLE(tail, 8, 2); putLE(tail, 8, 2); putLE(tail, 8, 2); putLE(tail, 0, 2);
+    }
+    entry(TAG_COMPRESSION, TYPE_SHORT, 1, 8);       // Adobe deflate (zlib)
+    entry(TAG_PHOTOMETRIC, TYPE_SHORT, 1, 2);       // RGB
+    entry(TAG_SAMPLES_PER_PIXEL, TYPE_SHORT, 1, 3);
+    entry(TAG_PLANAR_CONFIG, TYPE_SHORT, 1, 1);     // interleaved
+    entry(TAG_PREDICTOR, TYPE_SHORT, 1, 2);         // horizontal differencing
+    entry(TAG_TILE_WIDTH, TYPE_LONG, 1, uint32_t(tileSize));
+    entry(TAG_TILE_LENGTH, TYPE_LONG, 1, uint32_t(tileSize));
+
+    // A single tile's offset and size sit in the entries themselves.
+    uint16_t arrayType = big ? TYPE_LONG8 : TYPE_LONG;
+    if (tiles == 1) {
+        entry(TAG_TILE_OFFSETS, arrayType, 1, offsets[0]);
+        entry(TAG_TILE_BYTE_COUNTS, arrayType, 1, counts[0]);
+    } else {
+        entry(TAG_TILE_OFFSETS, arrayType, tiles, external());
+        for (uint64_t v : offsets) putLE(tail, v, offSize);
+        entry(TAG_TILE_BYTE_COUNTS, arrayType, tiles, external());
+        for (uint64_t v : counts) putLE(tail, v, offSize);
+    }
+    putLE(dir, 0, offSize); // no next directory
+
+    if (std::fwrite(dir.data(), 1, dir.size(), f) != dir.size()) ok = false;
+    if (std::fwrite(tail.data(), 1, tail.size(), f) != tail.size()) ok = false;
+
+    std::vector<uint8_t> pos;
+    putLE(pos, dirPos, offSize);
+    if (std::fseek(f, big ? 8 : 4, SEEK_SET) != 0 || std::fwrite(pos.data(), 1, pos.size(), f) != pos.size())
+        ok = false;
+
+    ok = (std::fclose(f) == 0) && ok;
+    f = nullptr;
+    if (!ok) std::fprintf(stderr, "Error writing %s\n", path.c_str());
+    return ok;
+}
@@ -0,0 +1,48 @@
+// tiffwriter.h - streaming writer for tiled, deflate-compressed RGB TIFF.
+//
+// For images far larger than memory (wall posters): tiles are compressed by
+// whichever thread hands them in, in any order, and appended to the file at
+// once. Only the offset and size of every tile are kept until close() writes
+// the image directory. Images whose uncompressed size could pass 4 GiB are
+// written as BigTIFF.
+
+#ifndef TIFFWRITER_H
+#define TIFFWRITER_H
+
+#include <cstdio>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <mutex>
+
+struct TiledTiffWriter {
+    int width = 0, height = 0;
+    int tileSize = 0;
+    int tilesX = 0, tilesY = 0;
+
+    ~TiledTiffWriter();
+
+    // tileSize must be a positive multiple of 16 (TIFF requirement). Returns
+    // false (after a message on stderr) if the file cannot be created.
+    bool open(const char* path, int w, int h, int tile);
+
+    // Tile (tx, ty): tileSize x tileSize RGBA8 pixels, rows of tileSize * 4
+    // bytes, top row first. Alpha is dropped; pixels past the right or bottom
+    // edge of the image are stored but never shown. Thread-safe.
+    bool writeTile(int tx, int ty, const uint8_t* rgba);
+
+    // Write the directory and close the file. Tiles never written are left
+    // empty. Returns false (after a message on stderr) on any write error.
+    bool close();
+
+private:
+    FILE* f = nullptr;
+    std::string path;
+    bool big = false;           // BigTIFF: 64-bit offsets
+    bool ok = true;
+    uint64_t end = 0;           // file size so far
+    std::vector<uint64_t> offsets, counts;
+    std::mutex lock;
+};
+
+#endif // TIFFWRITER_H
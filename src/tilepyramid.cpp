@@ -0,0 +1,129 @@
+// tilepyramid.cpp - precomputed raster tile pyramid of a laid-out map.
+
+#include "tilepyramid.h"
+
+#include <cstdio>
+#include <cstring>
+#include <cerrno>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+#include <sys/stat.h>
+
+#include "pngwriter.h"
+
+static const char* PYRAMID_MAGIC = "radialgl-tile-pyramid 1";
+
+static bool makeDir(const std::string& path) {
+    if (::mkdir(path.c_str(), 0777) == 0 || errno == EEXIST) return true;
+    std::fprintf(stderr, "Cannot create %s\n", path.c_str());
+    return false;
+}
+
+std::string tilePyramidPath(const std::string& dir, int z, int x, int y) {
+    return dir + "/" + std::to_string(z) + "/" + std::to_string(x) + "/" + std::to_string(y) + ".png";
+}
+
+static bool writeTile(const std::string& path, const RasterImage& image) {
+    std::vector<uint8_t> png = encodePng(image.rgba.data(), image.width, image.height, false, 1);
+    FILE* f = std::fopen(path.c_str(), "wb");
+    if (!f) { std::fprintf(stderr, "Cannot write %s\n", path.c_str()); return false; }
+    bool ok = std::fwrite(png.data(), 1, png.size(), f) == png.size();
+    ok = (std::fclose(f) == 0) && ok;
+    if (!ok) std::fprintf(stderr, "Error writing %s\n", path.c_str());
+    return ok;
+}
+
+static bool writeInfo(const std::string& dir, const TilePyramid& info) {
+    std::string path = dir + "/pyramid.txt";
+    FILE* f = std::fopen(path.c_str(), "w");
+    if (!f) { std::fprintf(stderr, "Cannot write %s\n", path.c_str()); return false; }
+    std::fprintf(f, "%s\ntile-size %d\nlevels %d\nextent %.9g\nradius-step %.9g\ncurved %d\nnodes %zu\n",
+                 PYRAMID_MAGIC, info.tileSize, info.levels, info.extent, info.radiusStep,
+                 info.curved ? 1 : 0, info.nodes);
+    bool ok = !std::ferror(f);
+    ok = (std::fclose(f) == 0) && ok;
+    if (!ok) std::fprintf(stderr, "Error writing %s\n", path.c_str());
+    return ok;
+}
+
+bool readTilePyramid(const std::string& dir, TilePyramid& info) {
+    FILE* f = std::fopen((dir + "/pyramid.txt").c_str(), "r");
+    if (!f) return false;
+
+    char line[256];
+    bool ok = std::fgets(line, sizeof(line), f) && std::strncmp(line, PYRAMID_MAGIC, std::strlen(PYRAMID_MAGIC)) == 0;
+    char key[64];
+    double value;
+    while (ok && std::fscanf(f, "%63s %lf", key, &value) == 2) {
+        if (!std::strcmp(key, "tile-size"))        info.tileSize = int(value);
+        else if (!std::strcmp(key, "levels"))      info.levels = int(value);
+        else if (!std::strcmp(key, "extent"))      info.extent = float(value);
+        else if (!std::strcmp(key, "radius-step")) info.radiusStep = float(value);
+        else if (!std::strcmp(key, "curved"))      info.curved = value != 0.0;
+        else if (!std::strcmp(key, "nodes"))       info.nodes = size_t(value);
+    }
+    std::fclose(f);
+    return ok && info.tileSize > 0 && info.levels > 0 && info.extent > 0.0f;
+}
+
+bool writeTilePyramid(const char* dir, const std::vector<Node*>& nodes,
+                      const std::vector<std::pair<int, int>>& ranges, const Node* focus,
+                      const RasterOptions& opt, int tileSize, int levels) {
+    std::string root = dir;
+    if (!makeDir(root)) return false;
+    std::remove((root + "/pyramid.txt").c_str()); // until this run is complete
+
+    RasterOptions style = opt;
+    style.rotDeg = 0.0f;
+    TilePyramid info;
+    info.tileSize = tileSize;
+    info.levels = levels;
+    info.extent = mapExtent(nodes, ranges, focus, style) + 2.0f * style.labelPad;
+    info.radiusStep = style.radiusStep;
+    info.curved = style.curved;
+    for (const auto& r : ranges) info.nodes += size_t(r.second - r.first);
+
+    size_t workers = style.threads > 0 ? size_t(style.threads) : std::max(1u, std::thread::hardware_concurrency());
+    bool ok = true;
+    for (int z = 0; z < levels && ok; ++z) {
+        int across = 1 << z;
+        if (!makeDir(root + "/" + std::to_string(z))) return false;
+
+        RasterView view;
+        view.width = view.height = tileSize * across;
+        view.pixelsPerUnit = float(view.width) / (2.0f * info.extent);
+        std::vector<uint8_t> keep = declutterMapLabels(nodes, ranges, focus, style, view);
+        RasterOptions levelStyle = style;
+        levelStyle.labelKeep = &keep;
+        RasterTiler tiler(nodes, ranges, focus, levelStyle, view);
+
+        // Tiles go column by column, so a worker creates the column directory
+        // only for the first tile drawn in it (mkdir is idempotent here).
+        size_t tiles = size_t(across) * size_t(across);
+        std::atomic<size_t> next{ 0 };
+        std::atomic<bool> levelOk{ true };
+        auto worker = [&]() {
+            SoftRaster raster(tileSize, tileSize);
+            RasterImage image;
+            std::vector<std::pair<int, int>> visible;
+            int madeColumn = -1;
+            for (size_t ti; levelOk && (ti = next.fetch_add(1)) < tiles; ) {
+                int x = int(ti / size_t(across)), y = int(ti % size_t(across));
+                if (!tiler.render(x * tileSize, y * tileSize, tileSize, tileSize, raster, image, visible)) continue;
+                if (madeColumn != x) {
+                    if (!makeDir(root + "/" + std::to_string(z) + "/" + std::to_string(x))) { levelOk = false; break; }
+                    madeColumn = x;
+                }
+                if (!writeTile(tilePyramidPath(root, z, x, y), image)) levelOk = false;
+            }
+        };
+        std::vector<std::thread> pool;
+        for (size_t t = 1; t < std::min(workers, tiles); ++t) pool.emplace_back(worker);
+        worker();
+        for (auto& t : pool) t.join();
+        ok = levelOk;
+    }
+    return ok && writeInfo(root, info);
+}
@@ -0,0 +1,45 @@
+// tilepyramid.h - precomputed raster tile pyramid of a laid-out map.
+//
+// Level z is the map rendered as 2^z x 2^z tiles of tileSize pixels, twice
+// the resolution of level z - 1; level 0 is the whole map in one tile. Labels
+// are decluttered per level, so every level shows what fits at its scale.
+// On disk a pyramid is a directory holding pyramid.txt (the TilePyramid
+// fields) and <z>/<x>/<y>.png, with x to the right and y down from the top
+// edge. Tiles with nothing drawn on them are left out.
+
+#ifndef TILEPYRAMID_H
+#define TILEPYRAMID_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include <utility>
+
+#include "softraster.h"
+
+struct TilePyramid {
+    int   tileSize   = 256;
+    int   levels     = 0;
+    float extent     = 0.0f;  // half the edge of the covered square (world units), centered on the origin
+    float radiusStep = 35.0f; // ring spacing of the layout the tiles show
+    bool  curved     = true;
+    size_t nodes     = 0;     // placed nodes of that layout
+};
+
+// Render the pyramid of the nodes in ranges, laid out around focus at the
+// origin, into dir (created if needed) with opt's style at rotation 0. Tiles
+// are rendered and encoded on opt.threads workers, one tile per worker in
+// memory at a time. pyramid.txt is written last, so an interrupted run
+// leaves no pyramid behind. Returns false (after a message on stderr) if
+// anything cannot be written.
+bool writeTilePyramid(const char* dir, const std::vector<Node*>& nodes,
+                      const std::vector<std::pair<int, int>>& ranges, const Node* focus,
+                      const RasterOptions& opt, int tileSize, int levels);
+
+// Read dir/pyramid.txt. Returns false (quietly) if there is no pyramid.
+bool readTilePyramid(const std::string& dir, TilePyramid& info);
+
+// dir/<z>/<x>/<y>.png
+std::string tilePyramidPath(const std::string& dir, int z, int x, int y);
+
+#endif // TILEPYRAMID_H